@@ -139,6 +139,7 @@ ls -la bin/
 echo ""
 echo -e "${BLUE}🚀 To run applications:${NC}"
 echo -e "  Console app: ${GREEN}./$BUILD_DIR/bin/audioApp${NC}"
+echo -e "  Renderer:    ${GREEN}./$BUILD_DIR/bin/audioRender out.wav${NC}"
 if [ "$BUILD_GUI" = "ON" ] && [ -f "bin/audioGUI" ]; then
     echo -e "  GUI app:     ${GREEN}./$BUILD_DIR/bin/audioGUI${NC}"
 fi
@@ -1,5 +1,29 @@
 #include "AudioSystemAdapter.h"
+#include <chrono>
 #include <stdexcept>
+#include <thread>
+#include "notes.h"
+
+namespace {
+    constexpr auto kReleaseRetryTime = std::chrono::milliseconds(200);  ///< Longest wait for room for a release
+    constexpr auto kReleaseRetryPause = std::chrono::milliseconds(1);   ///< Pause between attempts
+
+    /**
+     * @brief Queue a release, waiting for the audio thread to make room if needed
+     *
+     * A dropped note-on only loses a note, but a dropped note-off leaves it
+     * hanging, and a MIDI panic alone can send more releases than the queue
+     * holds. The audio thread drains the queue every buffer, so a short wait
+     * is enough; the bound keeps a stopped stream from blocking the caller.
+     */
+    template <typename Push>
+    void queueRelease(Push push) {
+        const auto deadline = std::chrono::steady_clock::now() + kReleaseRetryTime;
+        while (!push() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(kReleaseRetryPause);
+        }
+    }
+}
 
 AudioSystemAdapter::AudioSystemAdapter(AudioSystem* pAudioSystem) : itsAudioSystem(pAudioSystem) 
 {
@@ -20,11 +44,20 @@ void AudioSystemAdapter::update(void* params)
     
     switch (event->type) {
         case MidiEventType::NOTE_ON:
-            itsAudioSystem->triggerNote(event->value);  // Use the frequency value
+            itsAudioSystem->noteOn(event->data1, event->channel,
+                                   MIDI_NOTE_FREQUENCIES[event->data1 & 0x7F],
+                                   event->data2 / 127.0f);
             break;
             
         case MidiEventType::NOTE_OFF:
-            itsAudioSystem->triggerNoteOff();
+            queueRelease([this, event]() { return itsAudioSystem->noteOff(event->data1, event->channel); });
+            break;
+            
+        case MidiEventType::CONTROL_CHANGE:
+            // CC 123 (All Notes Off) releases the voices held on that channel
+            if (event->data1 == 123) {
+                queueRelease([this, event]() { return itsAudioSystem->channelNotesOff(event->channel); });
+            }
             break;
             
         // Handle other event types as needed
@@ -39,6 +39,10 @@ public:
      * its observers of a change. The method interprets the parameters and
      * forwards appropriate commands to the underlying AudioSystem.
      *
+     * Note-offs and All Notes Off are retried for a short while if the
+     * command queue is full, since losing one would leave notes hanging.
+     * Callers without a running audio thread must keep the queue drained.
+     *
      * @param params A pointer to the data associated with the notification,
      *               typically a MidiEvent or similar structure
      */
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <memory>
 #include <stdexcept>
 #include "audioSystem.h"
 #include "audioDevice.h"
@@ -10,22 +12,75 @@
 #include "AudioSystemAdapter.h"
 #include "ConfigReader.h"
 #include "AudioConfig.h"
+#include "RtSafetyCheck.h"
 
 /**
- * @brief Initialize and configure the audio system from XML configuration
+ * @brief Configure the audio system from XML configuration
+ * @param audioSystem AudioSystem instance to configure (not copyable: it owns the command queue)
  * @param config AudioConfig loaded from XML file
- * @return Configured AudioSystem instance
  */
-AudioSystem initializeAudioSystem(const AudioConfig& config) {
+void initializeAudioSystem(AudioSystem& audioSystem, const AudioConfig& config) {
 
-    AudioSystem audioSystem(config.sampleRate);
-    
     // Configure with loaded settings
     audioSystem.configure(config);
-    
-    return audioSystem;
 }
 
+/**
+ * @brief Print the audio callback load and xrun counters
+ * @param audioDevice Running audio device to poll
+ */
+void printDspLoad(const AudioDevice& audioDevice) {
+    DspLoadStats load = audioDevice.getLoadStats();
+    std::cout << "DSP load: p50 " << load.p50Load * 100.0f << "%, p99 " << load.p99Load * 100.0f
+              << "%, max " << load.maxLoad * 100.0f << "% over " << load.callbacks << " callbacks; "
+              << load.outputUnderflows << " underflows, " << load.inputOverflows << " overflows";
+    if (audioDevice.getRingUnderruns() > 0) {
+        std::cout << ", " << audioDevice.getRingUnderruns() << " render-ahead underruns";
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @class DspLoadWatcher
+ * @brief Background thread that prints the load statistics whenever a new xrun is counted
+ *
+ * It also frees the signal chains the audio thread has retired and, in
+ * real-time check builds, prints the allocations and locks the audio threads
+ * made since the last poll.
+ */
+class DspLoadWatcher {
+public:
+    DspLoadWatcher(AudioSystem& audioSystem, const AudioDevice& audioDevice)
+        : m_audioSystem(audioSystem), m_audioDevice(audioDevice), m_running(true), m_thread([this]() { run(); }) {}
+
+    ~DspLoadWatcher() {
+        m_running = false;
+        m_thread.join();
+    }
+
+private:
+    void run() {
+        unsigned long long reportedXruns = 0;
+        while (m_running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            m_audioSystem.collectGarbage();
+            RtSafetyCheck::reportViolations(std::cerr);
+            DspLoadStats load = m_audioDevice.getLoadStats();
+            unsigned long long xruns = load.outputUnderflows + load.inputOverflows + m_audioDevice.getRingUnderruns();
+            if (xruns > reportedXruns) {
+                std::cout << "⚠ Audio dropout detected. ";
+                printDspLoad(m_audioDevice);
+                reportedXruns = xruns;
+            }
+        }
+    }
+
+    AudioSystem& m_audioSystem;
+    const AudioDevice& m_audioDevice;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
 /**
  * @brief Main application entry point
  */
@@ -40,8 +95,12 @@ int main()
         AudioConfig     config = configReader.loadConfigWithFallback(configPath);
         
         // Initialize audio system with configuration
-        AudioSystem audioSystem = initializeAudioSystem(config);
-        AudioDevice audioDevice(&audioSystem, config.sampleRate, config.bufferFrames);
+        AudioSystem audioSystem(config.sampleRate);
+        initializeAudioSystem(audioSystem, config);
+        // Rendering ahead adds latency, so live MIDI playing keeps the direct path
+        const unsigned int renderAhead = config.inputMode == "sequencer" ? config.renderAhead : 0;
+        AudioDevice audioDevice(&audioSystem, config.sampleRate, config.bufferFrames, renderAhead);
+        audioDevice.setRealtime(config);
 
         // Create the AudioSystemAdapter for MIDI integration
         AudioSystemAdapter audioSystemAdapter(&audioSystem);
@@ -52,6 +111,10 @@ int main()
 
         // Add a delay to let the audio system initialize fully
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        std::cout << "Real-time setup: " << audioDevice.getRealtimeStatus().describe() << std::endl;
+
+        // Report dropouts as they happen instead of waiting for someone to hear them
+        auto loadWatcher = std::make_unique<DspLoadWatcher>(audioSystem, audioDevice);
         
         // Choose input mode based on configuration
         if (config.inputMode == "sequencer") {
@@ -104,6 +167,11 @@ int main()
             std::cout << "Shutting down MIDI device..." << std::endl;
             midiDevice.stop();
         }
+
+        loadWatcher.reset();
+        printDspLoad(audioDevice);
+        RtSafetyCheck::reportViolations(std::cerr);
+
         audioDevice.stop();
         
         // Final sleep to ensure all resources are released
@@ -0,0 +1,752 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cmath>
+#include <complex>
+#include "audioSystem.h"
+#include "RealtimeSetup.h"
+#include "AudioConfig.h"
+#include "Waves/SineWave.h"
+#include "Waves/SquareWave.h"
+#include "Waves/SawtoothWave.h"
+#include "Waves/TriangleWave.h"
+#include "Waves/WavetableWave.h"
+#include "Waves/PolyBlepWave.h"
+#include "Effects/FilterEffect.h"
+#include "Effects/DelayEffect.h"
+#include "Effects/OctaveEffect.h"
+#include "Effects/ReverbEffect.h"
+#include "Effects/ConvolutionReverbEffect.h"
+#include "Effects/WaveshaperEffect.h"
+#include "Effects/OversampledEffect.h"
+#include "Effects/CompressorEffect.h"
+#include "Effects/LimiterEffect.h"
+#include "Effects/ChorusEffect.h"
+#include "Effects/FlangerEffect.h"
+#include "Effects/PhaserEffect.h"
+#include "DSP/PartitionedConvolver.h"
+#include "Envelope/ADSREnvelope.h"
+
+/**
+ * @file main_bench.cpp
+ * @brief Microbenchmarks for waves, effects, the envelope and full AudioSystem chains
+ *
+ * Every case is timed over several repetitions and reported as ns/sample and
+ * samples/second, where a sample is one frame (both channels for effects and
+ * chains, all voices for chains). Results are written as JSON so runs from
+ * different commits can be diffed; a human-readable table goes to stderr.
+ *
+ * Alongside the timings, every waveform's aliasing energy is measured at a few
+ * pitches so the cost of the anti-aliased oscillators can be weighed against
+ * what they buy.
+ *
+ * The convolution reverb is timed separately for several partition sizes
+ * with a multi-second impulse response at a fixed 128-frame callback.
+ */
+
+namespace {
+
+    constexpr float kSampleRate = 48000.0f;
+
+    /**
+     * @struct BenchOptions
+     * @brief Command line settings
+     */
+    struct BenchOptions {
+        std::string jsonPath;                 ///< JSON output file, empty for stdout
+        std::string filter;                   ///< Only run cases whose id contains this
+        std::string label;                    ///< Free-form run label copied into the JSON
+        double minSeconds = 0.05;             ///< Minimum measured time per repetition
+        unsigned int repetitions = 5;         ///< Repetitions per case (median and best reported)
+        std::vector<unsigned int> blockSizes = {1, 16, 64, 256, 1024};
+        std::vector<unsigned int> voiceCounts = {1, 4, 16, 32};
+    };
+
+    /**
+     * @struct BenchResult
+     * @brief Timing of one case
+     */
+    struct BenchResult {
+        std::string group;        ///< "wave", "effect", "convolution", "envelope" or "chain"
+        std::string name;         ///< Component or chain name
+        std::string api;          ///< Entry point measured (e.g. "generateBlock")
+        unsigned int blockSize;   ///< Frames per call
+        unsigned int voices;      ///< Sounding voices (chains only, otherwise 1)
+        double nsPerSample;       ///< Median over the repetitions
+        double nsPerSampleBest;   ///< Fastest repetition
+    };
+
+    /**
+     * @struct AliasResult
+     * @brief Aliasing measurement of one waveform at one pitch
+     */
+    struct AliasResult {
+        std::string name;         ///< Waveform name
+        double frequency;         ///< Measured pitch in Hz
+        double aliasDb;           ///< Energy off the harmonic series relative to the harmonics, in dB
+    };
+
+    /**
+     * @brief Processes one block of the given size; returns a value that depends on the output
+     */
+    using BenchKernel = std::function<float(unsigned int blockSize)>;
+
+    volatile float g_sink = 0.0f; ///< Keeps the optimizer from discarding results
+
+    /**
+     * @brief Time a kernel and return {median, best} in ns per sample
+     */
+    std::pair<double, double> measure(const BenchKernel& kernel, unsigned int blockSize, const BenchOptions& options) {
+        using Clock = std::chrono::steady_clock;
+
+        // Warm caches, branch predictors and any lazily initialized state
+        float checksum = 0.0f;
+        for (unsigned int i = 0; i < 8 + 4096 / blockSize; ++i) {
+            checksum += kernel(blockSize);
+        }
+
+        std::vector<double> samples;
+        for (unsigned int rep = 0; rep < options.repetitions; ++rep) {
+            unsigned long long frames = 0;
+            double elapsed = 0.0;
+            auto start = Clock::now();
+
+            // Run in batches so the clock is not read on every call
+            do {
+                for (unsigned int i = 0; i < 64; ++i) {
+                    checksum += kernel(blockSize);
+                }
+                frames += 64ull * blockSize;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (elapsed < options.minSeconds);
+
+            samples.push_back(elapsed * 1e9 / static_cast<double>(frames));
+        }
+
+        g_sink = g_sink + checksum;
+
+        std::sort(samples.begin(), samples.end());
+        return {samples[samples.size() / 2], samples.front()};
+    }
+
+    /**
+     * @class BenchRunner
+     * @brief Collects results for the cases that pass the filter
+     */
+    class BenchRunner {
+    public:
+        explicit BenchRunner(const BenchOptions& options) : m_options(options) {}
+
+        void run(const std::string& group, const std::string& name, const std::string& api,
+                 unsigned int blockSize, unsigned int voices, const BenchKernel& kernel) {
+            std::string id = group + "/" + name + "/" + api + "/b" + std::to_string(blockSize) +
+                             "/v" + std::to_string(voices);
+            if (!m_options.filter.empty() && id.find(m_options.filter) == std::string::npos) {
+                return;
+            }
+
+            auto timing = measure(kernel, blockSize, m_options);
+            m_results.push_back({group, name, api, blockSize, voices, timing.first, timing.second});
+
+            std::cerr << "  " << id << std::string(id.size() < 44 ? 44 - id.size() : 1, ' ')
+                      << timing.first << " ns/sample" << std::endl;
+        }
+
+        /**
+         * @brief Run an aliasing measurement unless the filter excludes it
+         */
+        void runAliasing(const std::string& name, double frequency, const std::function<double()>& measurement) {
+            std::string id = "alias/" + name + "/f" + std::to_string(static_cast<int>(frequency + 0.5));
+            if (!m_options.filter.empty() && id.find(m_options.filter) == std::string::npos) {
+                return;
+            }
+
+            double aliasDb = measurement();
+            m_aliasResults.push_back({name, frequency, aliasDb});
+
+            std::cerr << "  " << id << std::string(id.size() < 44 ? 44 - id.size() : 1, ' ')
+                      << aliasDb << " dB" << std::endl;
+        }
+
+        const std::vector<BenchResult>& getResults() const { return m_results; }
+        const std::vector<AliasResult>& getAliasResults() const { return m_aliasResults; }
+
+    private:
+        const BenchOptions& m_options;
+        std::vector<BenchResult> m_results;
+        std::vector<AliasResult> m_aliasResults;
+    };
+
+    unsigned int maxBlockSize(const BenchOptions& options) {
+        return *std::max_element(options.blockSizes.begin(), options.blockSizes.end());
+    }
+
+    std::string jsonString(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    void writeJson(std::ostream& out, const BenchOptions& options, const std::vector<BenchResult>& results,
+                   const std::vector<AliasResult>& aliasResults) {
+        out << "{\n"
+            << "  \"benchmark\": \"audioBench\",\n"
+            << "  \"label\": " << jsonString(options.label) << ",\n"
+            << "  \"sampleRate\": " << kSampleRate << ",\n"
+            << "  \"repetitions\": " << options.repetitions << ",\n"
+            << "  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << "    {\"group\": " << jsonString(r.group)
+                << ", \"name\": " << jsonString(r.name)
+                << ", \"api\": " << jsonString(r.api)
+                << ", \"blockSize\": " << r.blockSize
+                << ", \"voices\": " << r.voices
+                << ", \"nsPerSample\": " << r.nsPerSample
+                << ", \"nsPerSampleBest\": " << r.nsPerSampleBest
+                << ", \"samplesPerSecond\": " << (r.nsPerSample > 0.0 ? 1e9 / r.nsPerSample : 0.0)
+                << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ],\n"
+            << "  \"aliasing\": [\n";
+
+        for (size_t i = 0; i < aliasResults.size(); ++i) {
+            const AliasResult& r = aliasResults[i];
+            out << "    {\"name\": " << jsonString(r.name)
+                << ", \"frequency\": " << r.frequency
+                << ", \"aliasDb\": " << r.aliasDb
+                << "}" << (i + 1 < aliasResults.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}" << std::endl;
+    }
+
+    // -------------------------------------------------------------------------
+    // Aliasing measurement
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief In-place iterative radix-2 FFT; the size must be a power of two
+     */
+    void fft(std::vector<std::complex<double>>& data) {
+        const size_t n = data.size();
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(data[i], data[j]);
+            }
+        }
+
+        const double pi = std::acos(-1.0);
+        for (size_t length = 2; length <= n; length <<= 1) {
+            std::complex<double> step = std::polar(1.0, -2.0 * pi / static_cast<double>(length));
+            for (size_t start = 0; start < n; start += length) {
+                std::complex<double> twiddle(1.0, 0.0);
+                for (size_t k = 0; k < length / 2; ++k) {
+                    std::complex<double> even = data[start + k];
+                    std::complex<double> odd = data[start + k + length / 2] * twiddle;
+                    data[start + k] = even + odd;
+                    data[start + k + length / 2] = even - odd;
+                    twiddle *= step;
+                }
+            }
+        }
+    }
+
+    constexpr unsigned int kAliasFftSize = 65536;
+
+    /**
+     * @brief Pitch nearest @p target that puts the fundamental on an odd FFT bin
+     *
+     * With kAliasFftSize a power of two, the phase increment bin / size is
+     * exact in float, so the oscillator repeats exactly within the analysis
+     * window and no window function is needed. An odd bin keeps the folded
+     * partials off the harmonic bins.
+     */
+    unsigned int aliasBin(double target) {
+        unsigned int bin = static_cast<unsigned int>(target * kAliasFftSize / kSampleRate + 0.5);
+        return bin | 1u;
+    }
+
+    /**
+     * @brief Energy off the harmonic series relative to the harmonics, in dB
+     *
+     * Every partial of a band-limited oscillator sits on a multiple of the
+     * fundamental bin; anything else is a partial that folded back from above
+     * Nyquist.
+     */
+    double measureAliasing(IWave& wave, unsigned int bin) {
+        const float frequency = static_cast<float>(bin) * kSampleRate / kAliasFftSize;
+        std::vector<float> samples(kAliasFftSize);
+
+        // Run one window first so the measurement starts on a settled phase
+        float phase = 0.0f;
+        wave.generateBlock(frequency, kSampleRate, phase, samples.data(), kAliasFftSize);
+        wave.generateBlock(frequency, kSampleRate, phase, samples.data(), kAliasFftSize);
+
+        std::vector<std::complex<double>> spectrum(samples.begin(), samples.end());
+        fft(spectrum);
+
+        double harmonicEnergy = 0.0;
+        double aliasEnergy = 0.0;
+        for (unsigned int k = 1; k < kAliasFftSize / 2; ++k) {
+            double energy = std::norm(spectrum[k]);
+            if (k % bin == 0) {
+                harmonicEnergy += energy;
+            } else {
+                aliasEnergy += energy;
+            }
+        }
+
+        // Floor at -200 dB so a perfect sine still yields a finite number
+        return 10.0 * std::log10(std::max(aliasEnergy, harmonicEnergy * 1e-20) / harmonicEnergy);
+    }
+
+    // -------------------------------------------------------------------------
+    // Cases
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Every selectable oscillator, keyed by its <waveform><type> name
+     */
+    std::vector<std::pair<std::string, std::shared_ptr<IWave>>> allWaves() {
+        return {
+            {"sine", std::make_shared<SineWave>()},
+            {"square", std::make_shared<SquareWave>()},
+            {"sawtooth", std::make_shared<SawtoothWave>()},
+            {"triangle", std::make_shared<TriangleWave>()},
+            {"sine_wt", std::make_shared<WavetableWave>(WavetableShape::Sine)},
+            {"square_wt", std::make_shared<WavetableWave>(WavetableShape::Square)},
+            {"sawtooth_wt", std::make_shared<WavetableWave>(WavetableShape::Sawtooth)},
+            {"triangle_wt", std::make_shared<WavetableWave>(WavetableShape::Triangle)},
+            {"square_blep", std::make_shared<PolyBlepWave>(PolyBlepShape::Square)},
+            {"sawtooth_blep", std::make_shared<PolyBlepWave>(PolyBlepShape::Sawtooth)},
+            {"triangle_blep", std::make_shared<PolyBlepWave>(PolyBlepShape::Triangle)}
+        };
+    }
+
+    void benchWaves(BenchRunner& runner, const BenchOptions& options) {
+        auto waves = allWaves();
+        std::vector<float> buffer(maxBlockSize(options));
+
+        for (auto& entry : waves) {
+            IWave& wave = *entry.second;
+            float phase = 0.0f;
+
+            runner.run("wave", entry.first, "generate", 1, 1, [&](unsigned int) {
+                return wave.generate(440.0f, kSampleRate, phase);
+            });
+
+            for (unsigned int blockSize : options.blockSizes) {
+                runner.run("wave", entry.first, "generateBlock", blockSize, 1, [&](unsigned int frames) {
+                    wave.generateBlock(440.0f, kSampleRate, phase, buffer.data(), frames);
+                    return buffer[frames - 1];
+                });
+            }
+        }
+    }
+
+    void benchAliasing(BenchRunner& runner) {
+        for (auto& entry : allWaves()) {
+            for (double target : {1000.0, 5000.0, 10000.0}) {
+                unsigned int bin = aliasBin(target);
+                IWave& wave = *entry.second;
+                runner.runAliasing(entry.first, static_cast<double>(bin) * kSampleRate / kAliasFftSize,
+                                   [&wave, bin]() { return measureAliasing(wave, bin); });
+            }
+        }
+    }
+
+    void benchEffects(BenchRunner& runner, const BenchOptions& options) {
+        // The same filter with the SIMD kernel disabled, to track what it buys
+        auto scalarFilter = std::make_shared<FilterEffect>(FilterEffect::Mode::LowPass, 1000.0f, 0.7071f, kSampleRate);
+        scalarFilter->setUseSimd(false);
+        auto scalarReverb = std::make_shared<ReverbEffect>(0.5f, 2.0f, 0.5f, 0.25f, kSampleRate);
+        scalarReverb->setUseSimd(false);
+
+        std::vector<std::pair<std::string, std::shared_ptr<IEffect>>> effects = {
+            {"lowpass", std::make_shared<FilterEffect>(FilterEffect::Mode::LowPass, 1000.0f, 0.7071f, kSampleRate)},
+            {"lowpass_scalar", scalarFilter},
+            {"delay", std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, kSampleRate)},
+            {"octave", std::make_shared<OctaveEffect>()},
+            {"reverb", std::make_shared<ReverbEffect>(0.5f, 2.0f, 0.5f, 0.25f, kSampleRate)},
+            {"reverb_scalar", scalarReverb},
+            {"compressor", std::make_shared<CompressorEffect>(-24.0f, 4.0f, 0.01f, 0.15f, 6.0f, 0.0f, kSampleRate)},
+            {"limiter", std::make_shared<LimiterEffect>(-6.0f, 0.005f, 0.05f, kSampleRate)},
+            {"chorus", std::make_shared<ChorusEffect>(0.8f, 0.5f, 0.5f, kSampleRate)},
+            {"flanger", std::make_shared<FlangerEffect>(0.2f, 0.7f, 0.5f, 0.5f, kSampleRate)},
+            {"phaser", std::make_shared<PhaserEffect>(0.4f, 0.7f, 0.5f, 0.5f, kSampleRate)}
+        };
+
+        // The waveshaper at each oversampling factor, to weigh the resampling
+        // cost against the aliasing it removes
+        for (unsigned int factor : {1u, 2u, 4u, 8u}) {
+            effects.emplace_back("overdrive_" + std::to_string(factor) + "x",
+                                 std::make_shared<OversampledEffect<WaveshaperEffect>>(factor, WaveshaperEffect::Shape::Tanh));
+        }
+
+        // Same lifecycle as AudioSystem: prepare once, then a note for the
+        // pitch-tracking effects
+        const unsigned int maxBlock = maxBlockSize(options);
+        NoteEvent note;
+        note.type = NoteEvent::Type::On;
+        note.note = 69;
+        note.channel = 0;
+        note.frequency = 440.0f;
+        note.velocity = 1.0f;
+        for (auto& entry : effects) {
+            entry.second->prepare(kSampleRate, maxBlock);
+            entry.second->onNoteEvent(note);
+        }
+
+        // Test signal: a sawtooth block, copied in before every call so the
+        // effects always see the same non-trivial input
+        std::vector<float> input(maxBlock);
+        std::vector<float> left(maxBlock);
+        std::vector<float> right(maxBlock);
+        SawtoothWave source;
+        float sourcePhase = 0.0f;
+        source.generateBlock(220.0f, kSampleRate, sourcePhase, input.data(), maxBlock);
+
+        for (auto& entry : effects) {
+            IEffect& effect = *entry.second;
+            unsigned int index = 0;
+
+            runner.run("effect", entry.first, "process", 1, 1, [&](unsigned int) {
+                float sample = input[index++ % maxBlock];
+                return effect.process({sample, sample}).first;
+            });
+
+            for (unsigned int blockSize : options.blockSizes) {
+                runner.run("effect", entry.first, "processBlock", blockSize, 1, [&](unsigned int frames) {
+                    std::copy(input.begin(), input.begin() + frames, left.begin());
+                    std::copy(input.begin(), input.begin() + frames, right.begin());
+                    effect.processBlock(left.data(), right.data(), frames);
+                    return left[frames - 1];
+                });
+            }
+        }
+    }
+
+    void benchDenormals(BenchRunner& runner, const BenchOptions& options) {
+        // Feedback effects fed a signal at denormal level, as in the last
+        // stretch of a decaying tail; "_ftz" runs with flush-to-zero set
+        const float tiny = 1e-39f;
+        const unsigned int maxBlock = maxBlockSize(options);
+        std::vector<float> left(maxBlock);
+        std::vector<float> right(maxBlock);
+        const unsigned int defaultMode = RealtimeSetup::getFloatMode();
+
+        for (bool flush : {false, true}) {
+            std::vector<std::pair<std::string, std::shared_ptr<IEffect>>> effects = {
+                {"lowpass", std::make_shared<FilterEffect>(FilterEffect::Mode::LowPass, 1000.0f, 0.7071f, kSampleRate)},
+                {"delay", std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, kSampleRate)},
+                {"reverb", std::make_shared<ReverbEffect>(0.5f, 2.0f, 0.5f, 0.25f, kSampleRate)}
+            };
+
+            if (flush) {
+                RealtimeSetup::flushDenormals();
+            }
+            for (auto& entry : effects) {
+                IEffect& effect = *entry.second;
+                effect.prepare(kSampleRate, maxBlock);
+                for (unsigned int blockSize : options.blockSizes) {
+                    runner.run("denormal", entry.first + (flush ? "_ftz" : ""), "processBlock", blockSize, 1,
+                               [&](unsigned int frames) {
+                        std::fill(left.begin(), left.begin() + frames, tiny);
+                        std::fill(right.begin(), right.begin() + frames, tiny);
+                        effect.processBlock(left.data(), right.data(), frames);
+                        return left[frames - 1];
+                    });
+                }
+            }
+            RealtimeSetup::setFloatMode(defaultMode);
+        }
+    }
+
+    void benchConvolution(BenchRunner& runner) {
+        constexpr unsigned int kCallbackFrames = 128;
+        std::vector<float> irLeft;
+        std::vector<float> irRight;
+        ConvolutionReverbEffect::makeSyntheticImpulse(3.0f, kSampleRate, irLeft, irRight);
+
+        std::vector<float> input(8192);
+        SawtoothWave source;
+        float sourcePhase = 0.0f;
+        source.generateBlock(220.0f, kSampleRate, sourcePhase, input.data(), static_cast<unsigned int>(input.size()));
+        std::vector<float> left(input.size());
+        std::vector<float> right(input.size());
+
+        for (unsigned int partition : {64u, 128u, 256u, 512u}) {
+            std::string name = "p" + std::to_string(partition);
+            ConvolutionReverbEffect effect(irLeft, irRight, kSampleRate, partition, 0.3f);
+            effect.prepare(kSampleRate, kCallbackFrames);
+
+            // Whole effect as the audio callback sees it. Running faster than
+            // real time, the callback also waits for the worker here, so the
+            // head and tail are timed on their own below
+            runner.run("convolution", name, "processBlock", kCallbackFrames, 1, [&](unsigned int frames) {
+                std::copy(input.begin(), input.begin() + frames, left.begin());
+                std::copy(input.begin(), input.begin() + frames, right.begin());
+                effect.processBlock(left.data(), right.data(), frames);
+                return left[frames - 1];
+            });
+
+            // Audio-thread part (head) and worker part (tail) on their own
+            const size_t headLength = std::min<size_t>(2 * effect.getTailBlockSize() - partition, irLeft.size());
+            PartitionedConvolver head(partition, irLeft.data(), irRight.data(), headLength);
+            runner.run("convolution", name + "_head", "process", partition, 1, [&](unsigned int frames) {
+                head.process(input.data(), input.data(), left.data(), right.data());
+                return left[frames - 1];
+            });
+
+            const unsigned int tailBlock = effect.getTailBlockSize();
+            if (tailBlock > 0) {
+                PartitionedConvolver tail(tailBlock, irLeft.data() + headLength, irRight.data() + headLength,
+                                          irLeft.size() - headLength);
+                runner.run("convolution", name + "_tail", "process", tailBlock, 1, [&](unsigned int frames) {
+                    tail.process(input.data(), input.data(), left.data(), right.data());
+                    return left[frames - 1];
+                });
+            }
+        }
+    }
+
+    void benchEnvelope(BenchRunner& runner, const BenchOptions& options) {
+        ADSREnvelope envelope(0.005f, 0.05f, 0.7f, 0.05f);
+        const unsigned int maxBlock = maxBlockSize(options);
+        std::vector<float> output(maxBlock);
+
+        // Gate toggles every 4096 samples so every stage is exercised
+        unsigned long long position = 0;
+
+        runner.run("envelope", "adsr", "process", 1, 1, [&](unsigned int) {
+            bool gate = ((position++ >> 12) & 1) == 0;
+            return envelope.process(gate, kSampleRate);
+        });
+
+        for (unsigned int blockSize : options.blockSizes) {
+            runner.run("envelope", "adsr", "processBlock", blockSize, 1, [&](unsigned int frames) {
+                bool gate = ((position >> 12) & 1) == 0;
+                position += frames;
+                envelope.processBlock(gate, kSampleRate, output.data(), frames);
+                return output[frames - 1];
+            });
+        }
+    }
+
+    void benchChains(BenchRunner& runner, const BenchOptions& options) {
+        struct ChainCase {
+            std::string name;
+            std::string waveform;
+            std::vector<std::string> effects;
+            std::vector<EffectGraphNode> graph;
+            unsigned int workers;
+            unsigned int parts;
+        };
+
+        // Reverb on an aux send fed by two parallel branches
+        std::vector<EffectGraphNode> sendGraph(4);
+        sendGraph[0].name = "dark";
+        sendGraph[0].effect = "lowpass";
+        sendGraph[0].inputs = {EffectGraphInput("input")};
+        sendGraph[1].name = "wide";
+        sendGraph[1].effect = "chorus";
+        sendGraph[1].inputs = {EffectGraphInput("input")};
+        sendGraph[2].name = "verb";
+        sendGraph[2].effect = "reverb";
+        sendGraph[2].inputs = {EffectGraphInput("dark", 0.3f), EffectGraphInput("wide", 0.3f)};
+        sendGraph[3].name = "output";
+        sendGraph[3].inputs = {EffectGraphInput("dark", 0.5f), EffectGraphInput("wide", 0.5f), EffectGraphInput("verb")};
+
+        std::vector<ChainCase> chains = {
+            {"dry", "sawtooth", {}, {}, 0, 1},
+            {"lowpass", "sawtooth", {"lowpass"}, {}, 0, 1},
+            {"delay", "sawtooth", {"delay"}, {}, 0, 1},
+            {"octave", "sawtooth", {"octave"}, {}, 0, 1},
+            {"full", "sawtooth", {"octave", "lowpass", "delay"}, {}, 0, 1},
+            {"full-mt", "sawtooth", {"octave", "lowpass", "delay"}, {}, 3, 1},
+            {"series-reverb", "sawtooth", {"lowpass", "chorus", "reverb"}, {}, 0, 1},
+            {"send-reverb", "sawtooth", {}, sendGraph, 0, 1},
+            {"parts4", "sawtooth", {"lowpass", "delay"}, {}, 0, 4},
+            {"parts4-mt", "sawtooth", {"lowpass", "delay"}, {}, 3, 4}
+        };
+
+        const unsigned int maxBlock = maxBlockSize(options);
+        std::vector<float> left(maxBlock);
+        std::vector<float> right(maxBlock);
+
+        for (const auto& chain : chains) {
+            for (unsigned int voices : options.voiceCounts) {
+                AudioConfig config;
+                config.sampleRate = kSampleRate;
+                config.waveform = chain.waveform;
+                config.effects = chain.effects;
+                config.effectGraph = chain.graph;
+                config.voiceWorkers = chain.workers;
+
+                // Extra parts on channels 2, 3, ... with the same sound; the
+                // voices are dealt out over the parts
+                for (unsigned int p = 1; p < chain.parts; ++p) {
+                    AudioPartConfig part;
+                    part.channel = p;
+                    part.settings = std::make_shared<AudioConfig>(config);
+                    config.parts.push_back(part);
+                }
+                config.maxVoices = std::max(1u, voices);
+                config.sustainLevel = 1.0f;
+                config.chainCrossfadeTime = 0.0f;
+
+                AudioSystem audioSystem(kSampleRate);
+                audioSystem.configure(config);
+
+                // Hold a spread of notes so every voice stays active
+                for (unsigned int v = 0; v < voices; ++v) {
+                    unsigned char note = static_cast<unsigned char>(36 + (v * 7) % 60);
+                    float frequency = 440.0f * std::pow(2.0f, (static_cast<float>(note) - 69.0f) / 12.0f);
+                    audioSystem.noteOn(note, static_cast<unsigned char>((v / 60) * chain.parts + v % chain.parts), frequency, 0.8f);
+                }
+
+                for (unsigned int blockSize : options.blockSizes) {
+                    runner.run("chain", chain.name, "renderBlock", blockSize, voices, [&](unsigned int frames) {
+                        audioSystem.renderBlock(left.data(), right.data(), frames);
+                        return left[frames - 1];
+                    });
+                }
+            }
+        }
+    }
+
+    std::vector<unsigned int> parseList(const std::string& text) {
+        std::vector<unsigned int> values;
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            int value = std::stoi(text.substr(start, end - start));
+            if (value <= 0) {
+                throw std::runtime_error("List values must be positive: " + text);
+            }
+            values.push_back(static_cast<unsigned int>(value));
+            start = end + 1;
+        }
+        return values;
+    }
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "\n"
+                  << "Options:\n"
+                  << "  --json <file>       Write JSON results to a file (default: stdout)\n"
+                  << "  --filter <text>     Only run cases whose id contains text\n"
+                  << "                      (ids look like chain/full/renderBlock/b256/v16\n"
+                  << "                      or alias/sawtooth_blep/f5001)\n"
+                  << "  --label <text>      Label stored in the JSON, e.g. a commit id\n"
+                  << "  --blocks <list>     Block sizes to sweep (default: 1,16,64,256,1024)\n"
+                  << "  --voices <list>     Polyphony counts for chains (default: 1,4,16,32)\n"
+                  << "  --min-time <s>      Minimum time per repetition (default: 0.05)\n"
+                  << "  --reps <n>          Repetitions per case (default: 5)\n"
+                  << "  --quick             Short run: --min-time 0.01 --reps 3" << std::endl;
+    }
+
+    /**
+     * @return false if usage was printed and the program should exit
+     */
+    bool parseArguments(int argc, char* argv[], BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto nextValue = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return false;
+            } else if (arg == "--json") {
+                options.jsonPath = nextValue();
+            } else if (arg == "--filter") {
+                options.filter = nextValue();
+            } else if (arg == "--label") {
+                options.label = nextValue();
+            } else if (arg == "--blocks") {
+                options.blockSizes = parseList(nextValue());
+            } else if (arg == "--voices") {
+                options.voiceCounts = parseList(nextValue());
+            } else if (arg == "--min-time") {
+                options.minSeconds = std::max(0.001, std::stod(nextValue()));
+            } else if (arg == "--reps") {
+                options.repetitions = static_cast<unsigned int>(std::max(1, std::stoi(nextValue())));
+            } else if (arg == "--quick") {
+                options.minSeconds = 0.01;
+                options.repetitions = 3;
+            } else {
+                printUsage(argv[0]);
+                throw std::runtime_error("Unknown argument: " + arg);
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Benchmark entry point
+ */
+int main(int argc, char* argv[])
+{
+    try {
+        BenchOptions options;
+        if (!parseArguments(argc, argv, options)) {
+            return 0;
+        }
+
+        BenchRunner runner(options);
+        std::cerr << "audioBench: " << options.repetitions << " x " << options.minSeconds
+                  << " s per case, median ns/sample" << std::endl;
+
+        benchWaves(runner, options);
+        benchAliasing(runner);
+        benchEffects(runner, options);
+        benchDenormals(runner, options);
+        benchConvolution(runner);
+        benchEnvelope(runner, options);
+        benchChains(runner, options);
+
+        if (options.jsonPath.empty()) {
+            writeJson(std::cout, options, runner.getResults(), runner.getAliasResults());
+        } else {
+            std::ofstream file(options.jsonPath);
+            if (!file) {
+                throw std::runtime_error("Failed to create " + options.jsonPath);
+            }
+            writeJson(file, options, runner.getResults(), runner.getAliasResults());
+            std::cerr << "Results written to " << options.jsonPath << std::endl;
+        }
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
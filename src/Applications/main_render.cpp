@@ -0,0 +1,329 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include "audioSystem.h"
+#include "RealtimeSetup.h"
+#include "RtSafetyCheck.h"
+#include "AudioSequencer.h"
+#include "AudioSystemAdapter.h"
+#include "ConfigReader.h"
+#include "AudioConfig.h"
+#include "MidiEvent.h"
+#include "IO/WavFile.h"
+
+/**
+ * @file main_render.cpp
+ * @brief Offline renderer: plays a note script or built-in sequence into a WAV file
+ *
+ * Uses the same AudioSystem as audioApp but drives it from a loop instead of
+ * an RtAudio callback, so it runs as fast as the DSP allows and works on
+ * machines without audio hardware.
+ *
+ * Built with AUDIO_RT_CHECK, it prints every allocation or lock made inside
+ * renderBlock() and exits with status 2 if there was any.
+ */
+
+namespace {
+
+    /**
+     * @struct RenderOptions
+     * @brief Command line settings for a render
+     */
+    struct RenderOptions {
+        std::string configPath = "config/config.xml";  ///< Configuration file
+        bool configGiven = false;                      ///< --config was passed (missing file is an error)
+        std::string outputPath;                        ///< WAV file to write
+        std::string scriptPath;                        ///< Note script, empty to use a built-in sequence
+        std::string sequenceType;                      ///< Built-in sequence, empty for the config's
+        float tailSeconds = 1.0f;                      ///< Silence rendered after the last event
+        unsigned int blockFrames = 0;                  ///< Frames per renderBlock(), 0 for the config's buffer size
+        WavSampleFormat format = WavSampleFormat::Float32;
+    };
+
+    /**
+     * @struct TimedEvent
+     * @brief MIDI event scheduled at an absolute time
+     */
+    struct TimedEvent {
+        double time;        ///< Seconds from the start of the render
+        MidiEvent event;    ///< Event delivered through AudioSystemAdapter
+    };
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options] <output.wav>\n"
+                  << "\n"
+                  << "Options:\n"
+                  << "  --config <file>     Configuration XML (default: config/config.xml)\n"
+                  << "  --script <file>     Note script to render\n"
+                  << "  --sequence <type>   Built-in sequence: scale, chord, melody, demo\n"
+                  << "                      (default: <sequenceType> from the configuration)\n"
+                  << "  --tail <seconds>    Audio rendered after the last event (default: 1.0)\n"
+                  << "  --block <frames>    Frames per render call (default: <bufferFrames>)\n"
+                  << "  --pcm16             Write 16-bit PCM instead of 32-bit float\n"
+                  << "\n"
+                  << "Note script: one event per line, '#' starts a comment\n"
+                  << "  <time> on <note> <velocity> [channel]   velocity 0-127\n"
+                  << "  <time> off <note> [channel]\n"
+                  << "  <time> alloff\n"
+                  << "Times are in seconds, notes are MIDI note numbers (60 = middle C)." << std::endl;
+    }
+
+    MidiEvent makeEvent(MidiEventType type, int channel, int data1, int data2) {
+        MidiEvent event;
+        event.type = type;
+        event.channel = static_cast<unsigned char>(channel & 0x0F);
+        event.data1 = static_cast<unsigned char>(data1 & 0x7F);
+        event.data2 = static_cast<unsigned char>(data2 & 0x7F);
+        event.value = 0;
+        return event;
+    }
+
+    /**
+     * @brief Parse a note script into time-ordered events
+     * @throws std::runtime_error on an unreadable file or malformed line
+     */
+    std::vector<TimedEvent> loadScript(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Failed to open note script: " + path);
+        }
+
+        std::vector<TimedEvent> events;
+        std::string line;
+        int lineNumber = 0;
+
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream fields(line);
+            double time = 0.0;
+            std::string command;
+            if (!(fields >> time)) {
+                if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                    continue; // Blank or comment-only line
+                }
+                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected a time");
+            }
+
+            int note = 0;
+            int velocity = 0;
+            int channel = 0;
+            bool valid = (fields >> command) && time >= 0.0;
+
+            if (valid && command == "on") {
+                valid = static_cast<bool>(fields >> note >> velocity);
+                fields >> channel;
+                events.push_back({time, makeEvent(MidiEventType::NOTE_ON, channel, note, velocity)});
+            } else if (valid && command == "off") {
+                valid = static_cast<bool>(fields >> note);
+                fields >> channel;
+                events.push_back({time, makeEvent(MidiEventType::NOTE_OFF, channel, note, 0)});
+            } else if (valid && command == "alloff") {
+                events.push_back({time, makeEvent(MidiEventType::CONTROL_CHANGE, 0, 123, 0)});
+            } else {
+                valid = false;
+            }
+
+            if (!valid || note < 0 || note > 127 || velocity < 0 || velocity > 127 ||
+                channel < 0 || channel > 15) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": invalid event '" + line + "'");
+            }
+        }
+
+        // Stable, so events at the same time keep their script order
+        std::stable_sort(events.begin(), events.end(),
+                         [](const TimedEvent& a, const TimedEvent& b) { return a.time < b.time; });
+        return events;
+    }
+
+    /**
+     * @brief Lay out a built-in AudioSequencer pattern on a timeline
+     */
+    std::vector<TimedEvent> sequenceEvents(const std::string& sequenceType) {
+        std::vector<TimedEvent> events;
+        double time = 0.0;
+
+        for (const auto& note : AudioSequencer::getSequence(sequenceType)) {
+            float noteNumber = 69.0f + 12.0f * std::log2(note.frequency / 440.0f);
+            int midiNote = std::min(std::max(static_cast<int>(std::round(noteNumber)), 0), 127);
+            int velocity = static_cast<int>(note.velocity * 127);
+
+            events.push_back({time, makeEvent(MidiEventType::NOTE_ON, 0, midiNote, velocity)});
+            time += note.duration;
+            events.push_back({time, makeEvent(MidiEventType::NOTE_OFF, 0, midiNote, 0)});
+            time += note.pauseAfter;
+        }
+        return events;
+    }
+
+    /**
+     * @brief Parse the command line
+     * @return false if usage was printed and the program should exit
+     * @throws std::runtime_error on invalid arguments
+     */
+    bool parseArguments(int argc, char* argv[], RenderOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto nextValue = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return false;
+            } else if (arg == "--config") {
+                options.configPath = nextValue();
+                options.configGiven = true;
+            } else if (arg == "--script") {
+                options.scriptPath = nextValue();
+            } else if (arg == "--sequence") {
+                options.sequenceType = nextValue();
+            } else if (arg == "--tail") {
+                options.tailSeconds = std::max(0.0f, std::stof(nextValue()));
+            } else if (arg == "--block") {
+                options.blockFrames = static_cast<unsigned int>(std::max(1, std::stoi(nextValue())));
+            } else if (arg == "--pcm16") {
+                options.format = WavSampleFormat::Pcm16;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::runtime_error("Unknown option: " + arg);
+            } else if (options.outputPath.empty()) {
+                options.outputPath = arg;
+            } else {
+                throw std::runtime_error("Unexpected argument: " + arg);
+            }
+        }
+
+        if (options.outputPath.empty()) {
+            printUsage(argv[0]);
+            throw std::runtime_error("No output file given");
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Offline render entry point
+ */
+int main(int argc, char* argv[])
+{
+    try {
+        RenderOptions options;
+        if (!parseArguments(argc, argv, options)) {
+            return 0;
+        }
+
+        // An explicit --config must exist; the default path falls back like audioApp
+        ConfigReader configReader;
+        AudioConfig config = options.configGiven
+            ? configReader.loadConfig(options.configPath)
+            : configReader.loadConfigWithFallback(options.configPath);
+        if (options.configGiven) {
+            configReader.printConfig(config, options.configPath);
+        }
+
+        std::vector<TimedEvent> events;
+        if (!options.scriptPath.empty()) {
+            events = loadScript(options.scriptPath);
+        } else {
+            events = sequenceEvents(options.sequenceType.empty() ? config.sequenceType : options.sequenceType);
+        }
+
+        const float sampleRate = config.sampleRate;
+        const unsigned int blockFrames = options.blockFrames > 0 ? options.blockFrames
+                                                                : std::max(1u, config.bufferFrames);
+        const double endTime = (events.empty() ? 0.0 : events.back().time) + options.tailSeconds;
+        const unsigned long long totalFrames = static_cast<unsigned long long>(endTime * sampleRate + 0.5);
+
+        auto frameOf = [sampleRate](const TimedEvent& e) {
+            return static_cast<unsigned long long>(e.time * sampleRate + 0.5);
+        };
+
+        // Same denormal handling as the live audio thread, so renders match it
+        if (config.flushDenormals) {
+            RealtimeSetup::flushDenormals();
+        }
+
+        AudioSystem audioSystem(sampleRate);
+        audioSystem.configure(config);
+        AudioSystemAdapter audioSystemAdapter(&audioSystem);
+        WavWriter writer(options.outputPath, static_cast<unsigned int>(sampleRate), options.format);
+
+        std::vector<float> left(blockFrames);
+        std::vector<float> right(blockFrames);
+        unsigned long long frame = 0;
+        size_t nextEvent = 0;
+        double renderSeconds = 0.0;
+
+        std::cout << "Rendering " << events.size() << " events, " << endTime << " s at "
+                  << sampleRate << " Hz in blocks of " << blockFrames << " frames..." << std::endl;
+        if (audioSystem.getLatency() > 0) {
+            std::cout << "Effect chain latency: " << audioSystem.getLatency() << " frames" << std::endl;
+        }
+
+        while (frame < totalFrames) {
+            // Deliver every event that is due; blocks end on event boundaries,
+            // so events land on the exact frame
+            unsigned int queued = 0;
+            while (nextEvent < events.size() && frameOf(events[nextEvent]) <= frame) {
+                // Nothing drains the command queue between blocks here, so
+                // apply a full batch with an empty block before queuing more
+                if (queued == AudioSystem::kCommandQueueSize) {
+                    audioSystem.renderBlock(left.data(), right.data(), 0);
+                    queued = 0;
+                }
+                audioSystemAdapter.update(&events[nextEvent].event);
+                ++queued;
+                ++nextEvent;
+            }
+
+            unsigned long long end = std::min(frame + blockFrames, totalFrames);
+            if (nextEvent < events.size()) {
+                end = std::min(end, frameOf(events[nextEvent]));
+            }
+            unsigned int frames = static_cast<unsigned int>(end - frame);
+
+            // Only the DSP is timed; file output is excluded from the speed figure
+            auto start = std::chrono::steady_clock::now();
+            audioSystem.renderBlock(left.data(), right.data(), frames);
+            renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            writer.write(left.data(), right.data(), frames);
+            frame = end;
+
+            // Real-time check builds: print new violations before the queue fills up
+            RtSafetyCheck::reportViolations(std::cerr);
+        }
+
+        writer.close();
+
+        const double audioSeconds = static_cast<double>(totalFrames) / sampleRate;
+        std::cout << "Wrote " << writer.getFramesWritten() << " frames (" << audioSeconds << " s) to "
+                  << options.outputPath << std::endl;
+        if (renderSeconds > 0.0) {
+            std::cout << "Render time: " << renderSeconds * 1000.0 << " ms ("
+                      << audioSeconds / renderSeconds << "x realtime)" << std::endl;
+        }
+
+        // A violation fails the render, so CI catches new ones
+        if (RtSafetyCheck::getViolationCount() > 0) {
+            std::cerr << "RT check: " << RtSafetyCheck::getViolationCount()
+                      << " allocation or lock call(s) on the audio thread" << std::endl;
+            return 2;
+        }
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file MpscQueue.h
+ * @brief Bounded lock-free multi-producer / single-consumer queue
+ */
+
+/**
+ * @class MpscQueue
+ * @brief Fixed-capacity ring of trivially copyable items
+ *
+ * Any number of control threads may push() concurrently; exactly one thread
+ * (the audio thread) may pop(). Every slot carries a sequence number, so
+ * producers claim slots with a single compare-and-swap and never wait on each
+ * other's copies, and the consumer never blocks or retries. Storage is inline,
+ * so the queue never allocates after construction.
+ *
+ * The producer and consumer indices are padded onto separate cache lines to
+ * keep control threads from invalidating the line the audio thread reads.
+ *
+ * @tparam T Item type, should be a small POD
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscQueue capacity must be a power of two");
+
+public:
+    MpscQueue() : m_enqueuePos(0), m_dequeuePos(0)
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Append an item (safe from any number of threads)
+     * @param item Item to copy into the queue
+     * @return false if the queue is full and the item was dropped
+     */
+    bool push(const T& item)
+    {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[pos & (Capacity - 1)];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                // Slot is free for this position; try to claim it
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Consumer has not freed this slot yet: queue is full
+                return false;
+            } else {
+                // Another producer claimed this position; reload and retry
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Append several items as one group (safe from any number of threads)
+     *
+     * Either every item is queued or none is. The slots are claimed together
+     * and published last to first, so the consumer, which stops at the first
+     * unpublished slot, sees the whole group at once.
+     *
+     * @param items Items to copy into the queue, in order
+     * @param count Number of items
+     * @return false if the queue lacks room for all of them and nothing was queued
+     */
+    bool pushAll(const T* items, std::size_t count)
+    {
+        if (count == 0) {
+            return true;
+        }
+        if (count > Capacity) {
+            return false;
+        }
+
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            // The consumer frees slots in order, so if the last one is free all are
+            const std::size_t last = pos + count - 1;
+            std::size_t sequence = m_slots[last & (Capacity - 1)].sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(last);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        m_slots[(pos + i) & (Capacity - 1)].item = items[i];
+                    }
+                    for (std::size_t i = count; i-- > 0;) {
+                        m_slots[(pos + i) & (Capacity - 1)].sequence.store(pos + i + 1, std::memory_order_release);
+                    }
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the oldest item (consumer thread only, wait-free)
+     * @param item Receives the popped item
+     * @return false if the queue is empty (or the next item is still being written)
+     */
+    bool pop(T& item)
+    {
+        Slot& slot = m_slots[m_dequeuePos & (Capacity - 1)];
+        std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence != m_dequeuePos + 1) {
+            return false;
+        }
+
+        item = slot.item;
+        slot.sequence.store(m_dequeuePos + Capacity, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    /**
+     * @brief Number of slots in the queue
+     */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T item;
+    };
+
+    Slot m_slots[Capacity];
+    char m_pad0[kCacheLine];
+    std::atomic<std::size_t> m_enqueuePos;      ///< Shared by producers
+    char m_pad1[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::size_t m_dequeuePos;                   ///< Owned by the consumer
+    char m_pad2[kCacheLine - sizeof(std::size_t)];
+};
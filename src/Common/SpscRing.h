@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file SpscRing.h
+ * @brief Bounded lock-free single-producer / single-consumer sample ring
+ */
+
+/**
+ * @class SpscRing
+ * @brief Ring buffer of trivially copyable samples for one writer and one reader
+ *
+ * Exactly one thread may write() and exactly one other thread may read().
+ * Both sides are wait-free: each owns its index, publishes it with a release
+ * store and reads the other's with an acquire load, so neither ever blocks
+ * or retries. The storage is allocated once by the constructor, so the ring
+ * never allocates afterwards. Unlike MpscQueue it moves runs of samples, not
+ * single items, and its capacity is chosen at run time.
+ *
+ * The two indices are padded onto separate cache lines so the writer does
+ * not invalidate the line the reader polls, and vice versa.
+ *
+ * @tparam T Sample type, must be trivially copyable
+ */
+template <typename T>
+class SpscRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing holds trivially copyable samples");
+
+public:
+    /**
+     * @brief Allocate the ring (not real-time safe)
+     * @param minCapacity Samples the ring must hold; rounded up to a power of two
+     */
+    explicit SpscRing(std::size_t minCapacity) : m_writePos(0), m_readPos(0)
+    {
+        std::size_t capacity = 2;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        m_buffer.assign(capacity, T());
+        m_mask = capacity - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Append up to @p count samples (producer thread only)
+     * @return Number of samples written, less than @p count if the ring filled up
+     */
+    std::size_t write(const T* data, std::size_t count)
+    {
+        const std::size_t write = m_writePos.load(std::memory_order_relaxed);
+        const std::size_t read = m_readPos.load(std::memory_order_acquire);
+        count = std::min(count, capacity() - (write - read));
+
+        // At most two runs: up to the end of the storage, then from the start
+        const std::size_t start = write & m_mask;
+        const std::size_t first = std::min(count, capacity() - start);
+        std::copy(data, data + first, m_buffer.data() + start);
+        std::copy(data + first, data + count, m_buffer.data());
+
+        m_writePos.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Remove up to @p count of the oldest samples (consumer thread only)
+     * @return Number of samples read, less than @p count if the ring ran empty
+     */
+    std::size_t read(T* data, std::size_t count)
+    {
+        const std::size_t read = m_readPos.load(std::memory_order_relaxed);
+        const std::size_t write = m_writePos.load(std::memory_order_acquire);
+        count = std::min(count, write - read);
+
+        const std::size_t start = read & m_mask;
+        const std::size_t first = std::min(count, capacity() - start);
+        std::copy(m_buffer.data() + start, m_buffer.data() + start + first, data);
+        std::copy(m_buffer.data(), m_buffer.data() + (count - first), data + first);
+
+        m_readPos.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Samples waiting to be read (exact on the consumer, a lower bound elsewhere)
+    std::size_t readAvailable() const
+    {
+        return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_acquire);
+    }
+
+    /// Room left for writing (exact on the producer, a lower bound elsewhere)
+    std::size_t writeAvailable() const
+    {
+        return capacity() - readAvailable();
+    }
+
+    /// Number of samples the ring holds when full
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    std::vector<T> m_buffer;                    ///< Storage, a power of two long
+    std::size_t m_mask;                         ///< capacity() - 1
+    char m_pad0[kCacheLine];
+    std::atomic<std::size_t> m_writePos;        ///< Samples ever written, owned by the producer
+    char m_pad1[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_readPos;         ///< Samples ever read, owned by the consumer
+    char m_pad2[kCacheLine - sizeof(std::atomic<std::size_t>)];
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,46 @@
  * @brief Configuration structure for the audio system
  */
 
+/**
+ * @brief One connection into an effect graph node
+ */
+struct EffectGraphInput
+{
+    std::string source;     ///< Name of the node read from ("input" is the voice mix)
+    float gain;             ///< Level the source is summed in at (send or branch level)
+
+    EffectGraphInput(const std::string& sourceName = std::string(), float level = 1.0f)
+        : source(sourceName), gain(level) {}
+};
+
+/**
+ * @brief Node of an effect graph: the sum of its inputs, optionally through an effect
+ *
+ * A node without an effect is a plain mixer, which is how splits, merges and
+ * aux return buses are built. The node named "output" feeds the master bus.
+ */
+struct EffectGraphNode
+{
+    std::string name;                       ///< Unique node name
+    std::string effect;                     ///< Effect run on the summed inputs (empty for a mixer)
+    std::vector<EffectGraphInput> inputs;   ///< Sources summed into the node
+};
+
+struct AudioConfig;
+
+/**
+ * @brief Instrument played on one MIDI channel
+ *
+ * The settings start as a copy of the main configuration with the part's own
+ * waveform, voices, envelope and effects applied on top. Audio, MIDI, input
+ * and master-bus settings are global and ignored here.
+ */
+struct AudioPartConfig
+{
+    unsigned int channel;                           ///< MIDI channel (0-15) the part plays
+    std::shared_ptr<const AudioConfig> settings;    ///< Sound of the part
+};
+
 /**
  * @brief Configuration options for selecting waveform and effects
  */
@@ -15,21 +56,81 @@ struct AudioConfig
 {
     std::string waveform;               ///< Name of the oscillator to use
     std::vector<std::string> effects;   ///< Ordered list of effect names
+    std::vector<EffectGraphNode> effectGraph; ///< Effect graph; replaces the serial list when not empty
+    float chainCrossfadeTime;           ///< Crossfade from the old effect chain on reconfiguration, in seconds (0 = instant)
+    std::string convolutionImpulse;     ///< Impulse response WAV for the convolution effect (empty = synthetic hall)
+    unsigned int convolutionPartition;  ///< Audio-thread partition size of the convolution effect in frames
+    float convolutionMix;               ///< Wet/dry mix of the convolution effect [0.0-1.0]
+    unsigned int oversampling;          ///< Oversampling factor of the distortion effects (1, 2, 4 or 8)
+    bool lfoShared;                     ///< Drive chorus, flanger and phaser from one chain LFO
+    float lfoRate;                      ///< Rate of the shared LFO in Hz
     float sampleRate;                   ///< Audio sample rate in Hz
     unsigned int bufferFrames;          ///< Number of frames per audio buffer
+    unsigned int renderAhead;           ///< Buffers a render thread keeps ready in sequencer mode (0 = render in the callback)
+    int realtimePriority;               ///< SCHED_FIFO priority of the rendering thread (0 = leave the scheduling alone)
+    std::vector<unsigned int> realtimeCpus; ///< CPUs the rendering thread is pinned to (empty = any)
+    bool flushDenormals;                ///< Set flush-to-zero / denormals-are-zero on the audio threads
+    bool lockMemory;                    ///< Lock the process memory (mlockall) and prefault it when the stream starts
     int midiPort;                       ///< MIDI port number
     float defaultFrequency;             ///< Default frequency for testing (Hz)
     std::string inputMode;              ///< Input mode: "midi" or "sequencer" for testing
     std::string sequenceType;           ///< Type of sequence for sequencer mode
+    unsigned int maxVoices;             ///< Number of preallocated polyphonic voices
+    std::string voiceStealPolicy;       ///< Voice stealing policy: "oldest", "quietest" or "samenote"
+    unsigned int voiceWorkers;          ///< Worker threads rendering voices besides the audio thread (0: audio thread only)
+    float attackTime;                   ///< Voice envelope attack time in seconds
+    float decayTime;                    ///< Voice envelope decay time in seconds
+    float sustainLevel;                 ///< Voice envelope sustain level [0.0-1.0]
+    float releaseTime;                  ///< Voice envelope release time in seconds
+    bool compressorEnabled;             ///< Run the master-bus compressor
+    float compressorThreshold;          ///< Compressor threshold in dBFS
+    float compressorRatio;              ///< Compressor ratio (input dB per output dB above the threshold)
+    float compressorAttack;             ///< Compressor attack time in seconds
+    float compressorRelease;            ///< Compressor release time in seconds
+    float compressorKnee;               ///< Compressor soft-knee width in dB
+    float compressorMakeup;             ///< Compressor makeup gain in dB
+    bool limiterEnabled;                ///< Run the master-bus true-peak limiter
+    float limiterCeiling;               ///< Limiter ceiling in dBTP
+    float limiterLookahead;             ///< Limiter lookahead in seconds (adds this much latency)
+    float limiterRelease;               ///< Limiter release time in seconds
+    std::vector<AudioPartConfig> parts; ///< Instruments of the channels with their own part; the others play the main settings
     
     // Default constructor with sensible defaults
     AudioConfig() : 
         waveform("sine"),
+        chainCrossfadeTime(0.02f),
+        convolutionPartition(128),
+        convolutionMix(0.3f),
+        oversampling(4),
+        lfoShared(false),
+        lfoRate(0.5f),
         sampleRate(44100.0f),
         bufferFrames(512),
+        renderAhead(0),
+        realtimePriority(0),
+        flushDenormals(false),
+        lockMemory(false),
         midiPort(1),
         defaultFrequency(440.0f),
         inputMode("midi"),
-        sequenceType("demo")
+        sequenceType("demo"),
+        maxVoices(32),
+        voiceStealPolicy("oldest"),
+        voiceWorkers(0),
+        attackTime(0.005f),
+        decayTime(0.05f),
+        sustainLevel(1.0f),
+        releaseTime(0.05f),
+        compressorEnabled(false),
+        compressorThreshold(-12.0f),
+        compressorRatio(3.0f),
+        compressorAttack(0.01f),
+        compressorRelease(0.15f),
+        compressorKnee(6.0f),
+        compressorMakeup(0.0f),
+        limiterEnabled(true),
+        limiterCeiling(-1.0f),
+        limiterLookahead(0.005f),
+        limiterRelease(0.05f)
     {}
 };
@@ -2,6 +2,8 @@
 #include <stdexcept>
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <sstream>
 
 ConfigReader::ConfigReader()
 {
@@ -39,71 +41,368 @@ AudioConfig ConfigReader::loadConfig(const std::string& filename)
         throw std::runtime_error("Invalid root element in XML file. Expected 'audioSystemConfig'");
     }
     
-    // Parse configuration sections
+    // Parse configuration sections; the parts inherit the finished main settings
+    xmlNode* partsNode = NULL;
     for (xmlNode* node = root->children; node; node = node->next) {
         if (node->type != XML_ELEMENT_NODE) continue;
         
-        std::string nodeName = (const char*)node->name;
+        if (strcmp((const char*)node->name, "parts") == 0) {
+            partsNode = node;
+        } else {
+            parseSection(node, config);
+        }
+    }
+    
+    if (partsNode) {
+        parseParts(partsNode, config);
+    }
+    
+    xmlFreeDoc(doc);
+    return config;
+}
+
+void ConfigReader::parseSection(xmlNode* node, AudioConfig& config)
+{
+    std::string nodeName = (const char*)node->name;
+    
+    if (nodeName == "audio") {
+        // Parse audio configuration
+        xmlNode* sampleRateNode = findChildNode(node, "sampleRate");
+        if (sampleRateNode) {
+            config.sampleRate = getNodeFloat(sampleRateNode, config.sampleRate);
+        }
+        
+        xmlNode* bufferFramesNode = findChildNode(node, "bufferFrames");
+        if (bufferFramesNode) {
+            config.bufferFrames = getNodeInt(bufferFramesNode, config.bufferFrames);
+        }
         
-        if (nodeName == "audio") {
-            // Parse audio configuration
-            xmlNode* sampleRateNode = findChildNode(node, "sampleRate");
-            if (sampleRateNode) {
-                config.sampleRate = getNodeFloat(sampleRateNode, config.sampleRate);
+        xmlNode* renderAheadNode = findChildNode(node, "renderAhead");
+        if (renderAheadNode) {
+            int buffers = getNodeInt(renderAheadNode, static_cast<int>(config.renderAhead));
+            if (buffers >= 0) {
+                config.renderAhead = static_cast<unsigned int>(buffers);
+            }
+        }
+    }
+    else if (nodeName == "waveform") {
+        // Parse waveform configuration
+        xmlNode* typeNode = findChildNode(node, "type");
+        if (typeNode) {
+            config.waveform = getNodeText(typeNode);
+        }
+    }
+    else if (nodeName == "effects") {
+        // Parse effects configuration
+        config.effects.clear(); // Clear default effects
+        config.effectGraph.clear();
+        xmlNode* crossfadeNode = findChildNode(node, "crossfade");
+        if (crossfadeNode) {
+            float crossfade = getNodeFloat(crossfadeNode, config.chainCrossfadeTime);
+            if (crossfade >= 0.0f) {
+                config.chainCrossfadeTime = crossfade;
+            }
+        }
+        
+        xmlNode* convolutionNode = findChildNode(node, "convolution");
+        if (convolutionNode) {
+            xmlNode* impulseNode = findChildNode(convolutionNode, "impulse");
+            if (impulseNode) {
+                config.convolutionImpulse = getNodeText(impulseNode);
             }
             
-            xmlNode* bufferFramesNode = findChildNode(node, "bufferFrames");
-            if (bufferFramesNode) {
-                config.bufferFrames = getNodeInt(bufferFramesNode, config.bufferFrames);
-            }
-        }
-        else if (nodeName == "waveform") {
-            // Parse waveform configuration
-            xmlNode* typeNode = findChildNode(node, "type");
-            if (typeNode) {
-                config.waveform = getNodeText(typeNode);
-            }
-        }
-        else if (nodeName == "effects") {
-            // Parse effects configuration
-            config.effects.clear(); // Clear default effects
-            for (xmlNode* effectNode = node->children; effectNode; effectNode = effectNode->next) {
-                if (effectNode->type == XML_ELEMENT_NODE && 
-                    strcmp((const char*)effectNode->name, "effect") == 0) {
-                    std::string effectName = getNodeText(effectNode);
-                    if (!effectName.empty()) {
-                        config.effects.push_back(effectName);
-                    }
+            xmlNode* partitionNode = findChildNode(convolutionNode, "partition");
+            if (partitionNode) {
+                int partition = getNodeInt(partitionNode, static_cast<int>(config.convolutionPartition));
+                // Must be a power of two
+                if (partition >= 16 && (partition & (partition - 1)) == 0) {
+                    config.convolutionPartition = static_cast<unsigned int>(partition);
+                }
+            }
+            
+            xmlNode* mixNode = findChildNode(convolutionNode, "mix");
+            if (mixNode) {
+                config.convolutionMix = getNodeFloat(mixNode, config.convolutionMix);
+            }
+        }
+        
+        xmlNode* oversamplingNode = findChildNode(node, "oversampling");
+        if (oversamplingNode) {
+            int factor = getNodeInt(oversamplingNode, static_cast<int>(config.oversampling));
+            if (factor == 1 || factor == 2 || factor == 4 || factor == 8) {
+                config.oversampling = static_cast<unsigned int>(factor);
+            }
+        }
+        
+        xmlNode* lfoNode = findChildNode(node, "lfo");
+        if (lfoNode) {
+            xmlNode* sharedNode = findChildNode(lfoNode, "shared");
+            if (sharedNode) {
+                config.lfoShared = getNodeBool(sharedNode, config.lfoShared);
+            }
+            
+            xmlNode* rateNode = findChildNode(lfoNode, "rate");
+            if (rateNode) {
+                float rate = getNodeFloat(rateNode, config.lfoRate);
+                if (rate > 0.0f) {
+                    config.lfoRate = rate;
+                }
+            }
+        }
+        
+        for (xmlNode* effectNode = node->children; effectNode; effectNode = effectNode->next) {
+            if (effectNode->type == XML_ELEMENT_NODE && 
+                strcmp((const char*)effectNode->name, "effect") == 0) {
+                std::string effectName = getNodeText(effectNode);
+                if (!effectName.empty()) {
+                    config.effects.push_back(effectName);
+                }
+            }
+        }
+
+        // Optional effect graph; replaces the effect list when present
+        xmlNode* graphNode = findChildNode(node, "graph");
+        for (xmlNode* graphChild = graphNode ? graphNode->children : NULL; graphChild; graphChild = graphChild->next) {
+            if (graphChild->type != XML_ELEMENT_NODE || strcmp((const char*)graphChild->name, "node") != 0) {
+                continue;
+            }
+
+            EffectGraphNode graphEntry;
+            graphEntry.name = getNodeText(findChildNode(graphChild, "name"));
+            graphEntry.effect = getNodeText(findChildNode(graphChild, "effect"));
+
+            // <input>name</input>, or <input><from>name</from><gain>0.3</gain></input>
+            for (xmlNode* inputNode = graphChild->children; inputNode; inputNode = inputNode->next) {
+                if (inputNode->type != XML_ELEMENT_NODE || strcmp((const char*)inputNode->name, "input") != 0) {
+                    continue;
+                }
+                xmlNode* fromNode = findChildNode(inputNode, "from");
+                if (fromNode) {
+                    graphEntry.inputs.emplace_back(getNodeText(fromNode),
+                                                   getNodeFloat(findChildNode(inputNode, "gain"), 1.0f));
+                } else {
+                    graphEntry.inputs.emplace_back(getNodeText(inputNode));
                 }
             }
+            config.effectGraph.push_back(graphEntry);
         }
-        else if (nodeName == "midi") {
-            // Parse MIDI configuration
-            xmlNode* portNode = findChildNode(node, "port");
-            if (portNode) {
-                config.midiPort = getNodeInt(portNode, config.midiPort);
+    }
+    else if (nodeName == "voices") {
+        // Parse polyphony configuration
+        xmlNode* countNode = findChildNode(node, "count");
+        if (countNode) {
+            int count = getNodeInt(countNode, static_cast<int>(config.maxVoices));
+            if (count > 0) {
+                config.maxVoices = static_cast<unsigned int>(count);
             }
         }
-        else if (nodeName == "defaultFrequency") {
-            // Parse default frequency
-            config.defaultFrequency = getNodeFloat(node, config.defaultFrequency);
+        
+        xmlNode* stealPolicyNode = findChildNode(node, "stealPolicy");
+        if (stealPolicyNode) {
+            config.voiceStealPolicy = getNodeText(stealPolicyNode);
         }
-        else if (nodeName == "input") {
-            // Parse input configuration
-            xmlNode* modeNode = findChildNode(node, "mode");
-            if (modeNode) {
-                config.inputMode = getNodeText(modeNode);
+
+        xmlNode* workersNode = findChildNode(node, "workers");
+        if (workersNode) {
+            int workers = getNodeInt(workersNode, static_cast<int>(config.voiceWorkers));
+            if (workers >= 0) {
+                config.voiceWorkers = static_cast<unsigned int>(workers);
+            }
+        }
+    }
+    else if (nodeName == "envelope") {
+        // Parse per-voice amplitude envelope
+        xmlNode* attackNode = findChildNode(node, "attack");
+        if (attackNode) {
+            config.attackTime = getNodeFloat(attackNode, config.attackTime);
+        }
+        
+        xmlNode* decayNode = findChildNode(node, "decay");
+        if (decayNode) {
+            config.decayTime = getNodeFloat(decayNode, config.decayTime);
+        }
+        
+        xmlNode* sustainNode = findChildNode(node, "sustain");
+        if (sustainNode) {
+            config.sustainLevel = getNodeFloat(sustainNode, config.sustainLevel);
+        }
+        
+        xmlNode* releaseNode = findChildNode(node, "release");
+        if (releaseNode) {
+            config.releaseTime = getNodeFloat(releaseNode, config.releaseTime);
+        }
+    }
+    else if (nodeName == "master") {
+        // Parse the master-bus dynamics
+        xmlNode* compressorNode = findChildNode(node, "compressor");
+        if (compressorNode) {
+            xmlNode* enabledNode = findChildNode(compressorNode, "enabled");
+            if (enabledNode) {
+                config.compressorEnabled = getNodeBool(enabledNode, config.compressorEnabled);
+            }
+            
+            xmlNode* thresholdNode = findChildNode(compressorNode, "threshold");
+            if (thresholdNode) {
+                config.compressorThreshold = getNodeFloat(thresholdNode, config.compressorThreshold);
+            }
+            
+            xmlNode* ratioNode = findChildNode(compressorNode, "ratio");
+            if (ratioNode) {
+                float ratio = getNodeFloat(ratioNode, config.compressorRatio);
+                if (ratio >= 1.0f) {
+                    config.compressorRatio = ratio;
+                }
+            }
+            
+            xmlNode* attackNode = findChildNode(compressorNode, "attack");
+            if (attackNode) {
+                config.compressorAttack = getNodeFloat(attackNode, config.compressorAttack);
+            }
+            
+            xmlNode* releaseNode = findChildNode(compressorNode, "release");
+            if (releaseNode) {
+                config.compressorRelease = getNodeFloat(releaseNode, config.compressorRelease);
+            }
+            
+            xmlNode* kneeNode = findChildNode(compressorNode, "knee");
+            if (kneeNode) {
+                config.compressorKnee = getNodeFloat(kneeNode, config.compressorKnee);
             }
             
-            xmlNode* sequenceTypeNode = findChildNode(node, "sequenceType");
-            if (sequenceTypeNode) {
-                config.sequenceType = getNodeText(sequenceTypeNode);
+            xmlNode* makeupNode = findChildNode(compressorNode, "makeup");
+            if (makeupNode) {
+                config.compressorMakeup = getNodeFloat(makeupNode, config.compressorMakeup);
+            }
+        }
+        
+        xmlNode* limiterNode = findChildNode(node, "limiter");
+        if (limiterNode) {
+            xmlNode* enabledNode = findChildNode(limiterNode, "enabled");
+            if (enabledNode) {
+                config.limiterEnabled = getNodeBool(enabledNode, config.limiterEnabled);
+            }
+            
+            xmlNode* ceilingNode = findChildNode(limiterNode, "ceiling");
+            if (ceilingNode) {
+                config.limiterCeiling = getNodeFloat(ceilingNode, config.limiterCeiling);
+            }
+            
+            xmlNode* lookaheadNode = findChildNode(limiterNode, "lookahead");
+            if (lookaheadNode) {
+                float lookahead = getNodeFloat(lookaheadNode, config.limiterLookahead);
+                if (lookahead > 0.0f) {
+                    config.limiterLookahead = lookahead;
+                }
+            }
+            
+            xmlNode* releaseNode = findChildNode(limiterNode, "release");
+            if (releaseNode) {
+                config.limiterRelease = getNodeFloat(releaseNode, config.limiterRelease);
             }
         }
     }
+    else if (nodeName == "realtime") {
+        // Parse the real-time setup of the rendering thread
+        xmlNode* priorityNode = findChildNode(node, "priority");
+        if (priorityNode) {
+            int priority = getNodeInt(priorityNode, config.realtimePriority);
+            if (priority >= 0) {
+                config.realtimePriority = priority;
+            }
+        }
+        
+        // <cpus>2,3</cpus>: comma or space separated CPU numbers
+        xmlNode* cpusNode = findChildNode(node, "cpus");
+        if (cpusNode) {
+            std::string cpuList = getNodeText(cpusNode);
+            std::replace(cpuList.begin(), cpuList.end(), ',', ' ');
+            std::istringstream cpuStream(cpuList);
+            config.realtimeCpus.clear();
+            int cpu;
+            while (cpuStream >> cpu) {
+                if (cpu >= 0) {
+                    config.realtimeCpus.push_back(static_cast<unsigned int>(cpu));
+                }
+            }
+        }
+        
+        xmlNode* flushDenormalsNode = findChildNode(node, "flushDenormals");
+        if (flushDenormalsNode) {
+            config.flushDenormals = getNodeBool(flushDenormalsNode, config.flushDenormals);
+        }
+        
+        xmlNode* lockMemoryNode = findChildNode(node, "lockMemory");
+        if (lockMemoryNode) {
+            config.lockMemory = getNodeBool(lockMemoryNode, config.lockMemory);
+        }
+    }
+    else if (nodeName == "midi") {
+        // Parse MIDI configuration
+        xmlNode* portNode = findChildNode(node, "port");
+        if (portNode) {
+            config.midiPort = getNodeInt(portNode, config.midiPort);
+        }
+    }
+    else if (nodeName == "defaultFrequency") {
+        // Parse default frequency
+        config.defaultFrequency = getNodeFloat(node, config.defaultFrequency);
+    }
+    else if (nodeName == "input") {
+        // Parse input configuration
+        xmlNode* modeNode = findChildNode(node, "mode");
+        if (modeNode) {
+            config.inputMode = getNodeText(modeNode);
+        }
+        
+        xmlNode* sequenceTypeNode = findChildNode(node, "sequenceType");
+        if (sequenceTypeNode) {
+            config.sequenceType = getNodeText(sequenceTypeNode);
+        }
+    }
+}
+
+void ConfigReader::parseParts(xmlNode* partsNode, AudioConfig& config)
+{
+    AudioConfig base = config;
+    base.parts.clear();
     
-    xmlFreeDoc(doc);
-    return config;
+    for (xmlNode* partNode = partsNode->children; partNode; partNode = partNode->next) {
+        if (partNode->type != XML_ELEMENT_NODE || strcmp((const char*)partNode->name, "part") != 0) {
+            continue;
+        }
+        
+        // Channels are numbered 1-16 in the file, as on MIDI equipment
+        int channel = getNodeInt(findChildNode(partNode, "channel"), 0);
+        if (channel < 1 || channel > 16) {
+            std::cout << "⚠ Warning: Ignoring part without a valid <channel> (1-16)" << std::endl;
+            continue;
+        }
+        
+        auto settings = std::make_shared<AudioConfig>(base);
+        for (xmlNode* node = partNode->children; node; node = node->next) {
+            if (node->type != XML_ELEMENT_NODE) continue;
+            
+            // Only the sound can differ per part
+            std::string nodeName = (const char*)node->name;
+            if (nodeName == "waveform" || nodeName == "effects" ||
+                nodeName == "voices" || nodeName == "envelope") {
+                parseSection(node, *settings);
+            }
+        }
+        
+        AudioPartConfig part;
+        part.channel = static_cast<unsigned int>(channel - 1);
+        part.settings = settings;
+        
+        // A later part for the same channel replaces the earlier one
+        auto existing = std::find_if(config.parts.begin(), config.parts.end(),
+                                     [&](const AudioPartConfig& other) { return other.channel == part.channel; });
+        if (existing != config.parts.end()) {
+            *existing = part;
+        } else {
+            config.parts.push_back(part);
+        }
+    }
 }
 
 AudioConfig ConfigReader::loadConfigWithFallback(const std::string& filename)
@@ -133,7 +432,26 @@ void ConfigReader::printConfig(const AudioConfig& config, const std::string& sou
     
     std::cout << "  Waveform: " << config.waveform << std::endl;
     std::cout << "  Sample Rate: " << config.sampleRate << " Hz" << std::endl;
-    std::cout << "  Buffer Frames: " << config.bufferFrames << std::endl;
+    std::cout << "  Buffer Frames: " << config.bufferFrames;
+    if (config.renderAhead > 0) {
+        std::cout << " (" << config.renderAhead << " rendered ahead in sequencer mode)";
+    }
+    std::cout << std::endl;
+    std::cout << "  Real-time: ";
+    if (config.realtimePriority > 0 || !config.realtimeCpus.empty() || config.flushDenormals || config.lockMemory) {
+        std::cout << "priority " << (config.realtimePriority > 0 ? std::to_string(config.realtimePriority) : "unchanged")
+                  << ", CPUs ";
+        if (config.realtimeCpus.empty()) {
+            std::cout << "any";
+        }
+        for (size_t i = 0; i < config.realtimeCpus.size(); ++i) {
+            std::cout << (i > 0 ? "," : "") << config.realtimeCpus[i];
+        }
+        std::cout << ", flush denormals " << (config.flushDenormals ? "on" : "off")
+                  << ", lock memory " << (config.lockMemory ? "on" : "off") << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
     std::cout << "  Input Mode: " << config.inputMode << std::endl;
     
     if (config.inputMode == "midi") {
@@ -142,6 +460,13 @@ void ConfigReader::printConfig(const AudioConfig& config, const std::string& sou
         std::cout << "  Sequence Type: " << config.sequenceType << std::endl;
     }
     
+    std::cout << "  Voices: " << config.maxVoices << " (steal " << config.voiceStealPolicy << ")";
+    if (config.voiceWorkers > 0) {
+        std::cout << ", " << config.voiceWorkers << " render worker(s)";
+    }
+    std::cout << std::endl;
+    std::cout << "  Envelope: A " << config.attackTime << "s, D " << config.decayTime 
+              << "s, S " << config.sustainLevel << ", R " << config.releaseTime << "s" << std::endl;
     std::cout << "  Default Frequency: " << config.defaultFrequency << " Hz" << std::endl;
     std::cout << "  Effects: ";
     
@@ -154,6 +479,63 @@ void ConfigReader::printConfig(const AudioConfig& config, const std::string& sou
         }
     }
     std::cout << std::endl;
+    if (!config.effectGraph.empty()) {
+        std::cout << "  Effect Graph:" << std::endl;
+        for (const auto& graphNode : config.effectGraph) {
+            std::cout << "    " << graphNode.name;
+            if (!graphNode.effect.empty()) {
+                std::cout << " (" << graphNode.effect << ")";
+            }
+            std::cout << " <- ";
+            for (size_t i = 0; i < graphNode.inputs.size(); ++i) {
+                std::cout << graphNode.inputs[i].source;
+                if (graphNode.inputs[i].gain != 1.0f) std::cout << " x" << graphNode.inputs[i].gain;
+                if (i < graphNode.inputs.size() - 1) std::cout << ", ";
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "  Chain Crossfade: " << config.chainCrossfadeTime << " s" << std::endl;
+    std::cout << "  Convolution: " << (config.convolutionImpulse.empty() ? "(synthetic)" : config.convolutionImpulse)
+              << ", partition " << config.convolutionPartition << ", mix " << config.convolutionMix << std::endl;
+    std::cout << "  Oversampling: " << config.oversampling << "x" << std::endl;
+    std::cout << "  Modulation LFO: ";
+    if (config.lfoShared) {
+        std::cout << "shared, " << config.lfoRate << " Hz" << std::endl;
+    } else {
+        std::cout << "per effect" << std::endl;
+    }
+    std::cout << "  Master Compressor: ";
+    if (config.compressorEnabled) {
+        std::cout << config.compressorThreshold << " dB, " << config.compressorRatio << ":1, A "
+                  << config.compressorAttack << "s, R " << config.compressorRelease << "s, knee "
+                  << config.compressorKnee << " dB, makeup " << config.compressorMakeup << " dB" << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
+    std::cout << "  Master Limiter: ";
+    if (config.limiterEnabled) {
+        std::cout << config.limiterCeiling << " dBTP, lookahead " << config.limiterLookahead
+                  << "s, R " << config.limiterRelease << "s" << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
+    for (const auto& part : config.parts) {
+        const AudioConfig& settings = *part.settings;
+        std::cout << "  Part (channel " << part.channel + 1 << "): " << settings.waveform << ", "
+                  << settings.maxVoices << " voices, effects: ";
+        if (!settings.effectGraph.empty()) {
+            std::cout << "graph of " << settings.effectGraph.size() << " nodes";
+        } else if (settings.effects.empty()) {
+            std::cout << "(none)";
+        } else {
+            for (size_t i = 0; i < settings.effects.size(); ++i) {
+                std::cout << settings.effects[i];
+                if (i < settings.effects.size() - 1) std::cout << ", ";
+            }
+        }
+        std::cout << std::endl;
+    }
     std::cout << "--------------------------------" << std::endl;
 }
 
@@ -193,6 +575,14 @@ int ConfigReader::getNodeInt(xmlNode* node, int defaultValue)
     }
 }
 
+bool ConfigReader::getNodeBool(xmlNode* node, bool defaultValue)
+{
+    std::string text = getNodeText(node);
+    if (text == "true" || text == "yes" || text == "1") return true;
+    if (text == "false" || text == "no" || text == "0") return false;
+    return defaultValue;
+}
+
 xmlNode* ConfigReader::findChildNode(xmlNode* parent, const std::string& name)
 {
     if (parent == NULL) return NULL;
@@ -53,6 +53,20 @@ public:
     static void printConfig(const AudioConfig& config, const std::string& source = "");
 
 private:
+    /**
+     * @brief Apply one top-level section (audio, waveform, effects, ...) to a configuration
+     * @param node Section element
+     * @param config Configuration to update
+     */
+    void parseSection(xmlNode* node, AudioConfig& config);
+    
+    /**
+     * @brief Parse the per-channel parts on top of the main settings
+     * @param partsNode The <parts> element
+     * @param config Main configuration, already complete; receives the parts
+     */
+    void parseParts(xmlNode* partsNode, AudioConfig& config);
+    
     /**
      * @brief Parse a text node and return its content as string
      * @param node XML node to parse
@@ -76,6 +90,14 @@ private:
      */
     int getNodeInt(xmlNode* node, int defaultValue = 0);
     
+    /**
+     * @brief Parse a text node as a boolean ("true"/"false", "yes"/"no", "1"/"0")
+     * @param node XML node to parse
+     * @param defaultValue Default value to return if the text is not a boolean
+     * @return Boolean value parsed from node content
+     */
+    bool getNodeBool(xmlNode* node, bool defaultValue = false);
+    
     /**
      * @brief Find a child node by name
      * @param parent Parent node to search in
@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @file AudioCommand.h
+ * @brief Fixed-size commands sent from control threads to the audio thread
+ */
+
+/**
+ * @enum AudioCommandType
+ * @brief Kinds of state change the audio thread applies at the start of a block
+ */
+enum class AudioCommandType : unsigned char {
+    NoteOn,             ///< Start a voice (note, channel, value = frequency, velocity)
+    NoteOff,            ///< Release the voices playing note/channel
+    AllNotesOff,        ///< Release every held voice
+    ChannelNotesOff,    ///< Release the held voices of @c channel
+    SetEffectParameter, ///< Set parameter @c parameterId of the effect in @c effectSlot to @c value
+    ResetEffects        ///< Clear the state of every effect in the chain
+};
+
+/**
+ * @struct AudioCommand
+ * @brief Plain-old-data control message
+ *
+ * Commands are copied by value through the lock-free queue, so they must stay
+ * trivially copyable and must not own memory.
+ */
+struct AudioCommand {
+    AudioCommandType type;        ///< What to do
+    unsigned char note;           ///< MIDI note number for note commands
+    unsigned char channel;        ///< MIDI channel for note commands
+    unsigned char effectSlot;     ///< Index in the effect chain for parameter commands
+    unsigned int parameterId;     ///< Effect-specific parameter identifier
+    unsigned int chainGeneration; ///< SignalChain generation @c effectSlot was resolved against
+    float value;                  ///< Frequency for NoteOn, new value for SetEffectParameter
+    float velocity;               ///< Velocity [0.0-1.0] for NoteOn
+};
@@ -48,7 +48,7 @@ void AudioSequencer::stopSequence() {
         m_playing = false;
         // Stop the thread using ThreadBase's stop method
         stop();
-        sendNoteOff(); // Ensure any playing note is stopped
+        sendAllNotesOff(); // Ensure any playing note is stopped
         std::cout << "🔇 Audio sequence stopped." << std::endl;
     }
 }
@@ -61,15 +61,7 @@ void AudioSequencer::playSequenceOnce(const std::string& sequenceType) {
     m_currentSequenceType = sequenceType;
     
     // Generate the appropriate sequence
-    if (sequenceType == "scale") {
-        m_currentSequence = generateMajorScale();
-    } else if (sequenceType == "chord") {
-        m_currentSequence = generateChordProgression();
-    } else if (sequenceType == "melody") {
-        m_currentSequence = generateSimpleMelody();
-    } else {
-        m_currentSequence = generateDemoSequence();
-    }
+    m_currentSequence = getSequence(sequenceType);
     
     std::cout << "🎵 Playing " << sequenceType << " sequence..." << std::endl;
     
@@ -89,7 +81,7 @@ void AudioSequencer::playSequenceOnce(const std::string& sequenceType) {
             static_cast<int>(note.duration * 1000)));
         
         // Send note off
-        sendNoteOff();
+        sendNoteOff(note.frequency);
         
         // Wait for pause if specified
         if (note.pauseAfter > 0.0f) {
@@ -114,6 +106,17 @@ void AudioSequencer::thread() {
     m_playing = false;
 }
 
+std::vector<SequenceNote> AudioSequencer::getSequence(const std::string& sequenceType) {
+    if (sequenceType == "scale") {
+        return generateMajorScale();
+    } else if (sequenceType == "chord") {
+        return generateChordProgression();
+    } else if (sequenceType == "melody") {
+        return generateSimpleMelody();
+    }
+    return generateDemoSequence();
+}
+
 std::vector<SequenceNote> AudioSequencer::generateMajorScale() {
     return {
         SequenceNote(Notes::C4, 0.5f, 0.8f, 0.1f),  // C
@@ -214,11 +217,11 @@ void AudioSequencer::sendNoteOn(float frequency, float velocity) {
     notify(&event);
 }
 
-void AudioSequencer::sendNoteOff() {
+void AudioSequencer::sendNoteOff(float frequency) {
     MidiEvent event;
     event.type = MidiEventType::NOTE_OFF;
     event.channel = 0;
-    event.data1 = 0;  // Note number not important for note off in this context
+    event.data1 = static_cast<unsigned char>(frequencyToMidiNote(frequency));  // Release only this note
     event.data2 = 0;  // Velocity not important for note off
     event.value = 0;
     
@@ -226,6 +229,18 @@ void AudioSequencer::sendNoteOff() {
     notify(&event);
 }
 
+void AudioSequencer::sendAllNotesOff() {
+    MidiEvent event;
+    event.type = MidiEventType::CONTROL_CHANGE;
+    event.channel = 0;
+    event.data1 = 123;  // All Notes Off controller
+    event.data2 = 0;
+    event.value = 0;
+    
+    // Notify observers so every sounding voice is released
+    notify(&event);
+}
+
 int AudioSequencer::frequencyToMidiNote(float frequency) {
     // Convert frequency to MIDI note number using A4 = 440 Hz = note 69
     if (frequency <= 0) return 0;
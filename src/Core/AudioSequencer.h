@@ -69,6 +69,16 @@ public:
      */
     void playSequenceOnce(const std::string& sequenceType = "demo");
 
+    /**
+     * @brief Get the notes of a predefined sequence without playing it
+     *
+     * Lets offline tools (e.g. audioRender) reuse the built-in patterns.
+     *
+     * @param sequenceType Type of sequence ("scale", "chord", "melody", anything else for "demo")
+     * @return Vector of notes in playing order
+     */
+    static std::vector<SequenceNote> getSequence(const std::string& sequenceType);
+
 private:
     /**
      * @brief Thread function that plays the sequence (implements ThreadBase::thread)
@@ -79,25 +89,25 @@ private:
      * @brief Generate a major scale sequence (C major)
      * @return Vector of notes forming a major scale
      */
-    std::vector<SequenceNote> generateMajorScale();
+    static std::vector<SequenceNote> generateMajorScale();
     
     /**
      * @brief Generate a chord progression sequence
      * @return Vector of notes forming chord progressions
      */
-    std::vector<SequenceNote> generateChordProgression();
+    static std::vector<SequenceNote> generateChordProgression();
     
     /**
      * @brief Generate a simple melody sequence
      * @return Vector of notes forming a simple melody
      */
-    std::vector<SequenceNote> generateSimpleMelody();
+    static std::vector<SequenceNote> generateSimpleMelody();
     
     /**
      * @brief Generate a demo sequence showcasing various features
      * @return Vector of notes forming a demonstration sequence
      */
-    std::vector<SequenceNote> generateDemoSequence();
+    static std::vector<SequenceNote> generateDemoSequence();
     
     /**
      * @brief Send a note on event to observers
@@ -108,8 +118,14 @@ private:
     
     /**
      * @brief Send a note off event to observers
+     * @param frequency Frequency of the note to release, in Hz
+     */
+    void sendNoteOff(float frequency);
+    
+    /**
+     * @brief Send an All Notes Off control change to observers
      */
-    void sendNoteOff();
+    void sendAllNotesOff();
     
     /**
      * @brief Convert frequency to MIDI note number for logging
@@ -0,0 +1,94 @@
+#include "DspLoadMonitor.h"
+#include <algorithm>
+
+constexpr unsigned int DspLoadMonitor::kBinsPerUnit;
+constexpr unsigned int DspLoadMonitor::kBins;
+
+// -----------------------------------------------------------------------------
+// DspLoadMonitor implementation
+// -----------------------------------------------------------------------------
+
+DspLoadMonitor::DspLoadMonitor()
+    : m_callbacks(0), m_inputOverflows(0), m_outputUnderflows(0),
+      m_maxLoad(0.0f), m_resetRequested(false)
+{
+    for (auto& bin : m_bins) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+}
+
+void DspLoadMonitor::record(float load, bool inputOverflow, bool outputUnderflow)
+{
+    if (m_resetRequested.exchange(false, std::memory_order_relaxed)) {
+        clear();
+    }
+
+    load = std::max(load, 0.0f);
+    unsigned int bin = std::min(static_cast<unsigned int>(load * kBinsPerUnit), kBins - 1);
+    increment(m_bins[bin]);
+
+    if (load > m_maxLoad.load(std::memory_order_relaxed)) {
+        m_maxLoad.store(load, std::memory_order_relaxed);
+    }
+    if (inputOverflow) {
+        increment(m_inputOverflows);
+    }
+    if (outputUnderflow) {
+        increment(m_outputUnderflows);
+    }
+
+    // Published last so a reader never sees more callbacks than binned samples
+    m_callbacks.store(m_callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+DspLoadStats DspLoadMonitor::getStats() const
+{
+    DspLoadStats stats;
+    stats.callbacks = m_callbacks.load(std::memory_order_acquire);
+    stats.inputOverflows = m_inputOverflows.load(std::memory_order_relaxed);
+    stats.outputUnderflows = m_outputUnderflows.load(std::memory_order_relaxed);
+    stats.maxLoad = m_maxLoad.load(std::memory_order_relaxed);
+
+    // Bins may be a callback or two ahead of the snapshot; percentiles only
+    // need to be approximately consistent
+    unsigned long long total = 0;
+    for (const auto& bin : m_bins) {
+        total += bin.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return stats;
+    }
+
+    // Report the upper edge of the bin holding each percentile, capped at the true maximum
+    const unsigned long long p50Rank = (total * 50 + 99) / 100;
+    const unsigned long long p99Rank = (total * 99 + 99) / 100;
+    unsigned long long cumulative = 0;
+    bool p50Found = false;
+
+    for (unsigned int i = 0; i < kBins; ++i) {
+        cumulative += m_bins[i].load(std::memory_order_relaxed);
+        float upperEdge = static_cast<float>(i + 1) / kBinsPerUnit;
+
+        if (!p50Found && cumulative >= p50Rank) {
+            stats.p50Load = std::min(upperEdge, stats.maxLoad);
+            p50Found = true;
+        }
+        if (cumulative >= p99Rank) {
+            stats.p99Load = std::min(upperEdge, stats.maxLoad);
+            break;
+        }
+    }
+
+    return stats;
+}
+
+void DspLoadMonitor::clear()
+{
+    for (auto& bin : m_bins) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+    m_inputOverflows.store(0, std::memory_order_relaxed);
+    m_outputUnderflows.store(0, std::memory_order_relaxed);
+    m_maxLoad.store(0.0f, std::memory_order_relaxed);
+    m_callbacks.store(0, std::memory_order_release);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file DspLoadMonitor.h
+ * @brief Lock-free callback load histogram and xrun counters
+ */
+
+/**
+ * @struct DspLoadStats
+ * @brief Snapshot of the audio callback load since the last reset
+ *
+ * Loads are the callback's wall time divided by the buffer period
+ * (nBufferFrames / sampleRate), so 1.0 means the callback used its whole
+ * deadline and anything above it is a dropout.
+ */
+struct DspLoadStats
+{
+    float p50Load;                          ///< Median load
+    float p99Load;                          ///< 99th percentile load
+    float maxLoad;                          ///< Highest load seen
+    unsigned long long callbacks;           ///< Number of callbacks measured
+    unsigned long long inputOverflows;      ///< Callbacks flagged with an input overflow
+    unsigned long long outputUnderflows;    ///< Callbacks flagged with an output underflow
+
+    DspLoadStats() : p50Load(0.0f), p99Load(0.0f), maxLoad(0.0f),
+                     callbacks(0), inputOverflows(0), outputUnderflows(0) {}
+};
+
+/**
+ * @class DspLoadMonitor
+ * @brief Records per-callback load from the audio thread for polling elsewhere
+ *
+ * The audio thread is the only writer: record() bumps one histogram bin and a
+ * few counters with relaxed atomic stores, with no locks and no allocation.
+ * Any thread may call getStats(), which sums the bins to derive percentiles at
+ * a resolution of 1% load. Loads above the histogram range land in the last
+ * bin; the exact maximum is tracked separately.
+ */
+class DspLoadMonitor
+{
+public:
+    static constexpr unsigned int kBinsPerUnit = 100;  ///< Bins per 100% load (1% resolution)
+    static constexpr unsigned int kBins = 401;          ///< Covers 0% to 400%, last bin catches the rest
+
+    DspLoadMonitor();
+
+    DspLoadMonitor(const DspLoadMonitor&) = delete;
+    DspLoadMonitor& operator=(const DspLoadMonitor&) = delete;
+
+    /**
+     * @brief Record one callback (audio thread only)
+     * @param load Callback wall time divided by the buffer period
+     * @param inputOverflow The driver reported an input overflow
+     * @param outputUnderflow The driver reported an output underflow
+     */
+    void record(float load, bool inputOverflow, bool outputUnderflow);
+
+    /**
+     * @brief Current statistics (any thread)
+     */
+    DspLoadStats getStats() const;
+
+    /**
+     * @brief Ask the audio thread to clear the statistics on its next record()
+     */
+    void reset() { m_resetRequested.store(true, std::memory_order_relaxed); }
+
+private:
+    /** Zero every counter (audio thread only) */
+    void clear();
+
+    /** Single-writer increment, avoids a locked read-modify-write */
+    template <typename T>
+    static void increment(std::atomic<T>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint32_t> m_bins[kBins];           ///< Callbacks per 1% load bin
+    std::atomic<unsigned long long> m_callbacks;        ///< Total callbacks recorded
+    std::atomic<unsigned long long> m_inputOverflows;   ///< Input overflow count
+    std::atomic<unsigned long long> m_outputUnderflows; ///< Output underflow count
+    std::atomic<float> m_maxLoad;                       ///< Highest load recorded
+    std::atomic<bool> m_resetRequested;                 ///< Set by reset(), consumed by record()
+};
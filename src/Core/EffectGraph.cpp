@@ -0,0 +1,265 @@
+#include "EffectGraph.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+namespace {
+    const char* const kInputName = "input";     ///< Reserved source: the voice mix
+    const char* const kOutputName = "output";   ///< Node whose buffer is the graph's result
+    constexpr int kVoiceSource = -1;            ///< Resolved index of kInputName
+}
+
+EffectGraph::EffectGraph(const std::vector<EffectGraphNode>& nodes, const std::vector<std::shared_ptr<IEffect>>& effects,
+                         unsigned int maxBlockFrames)
+    : m_maxBlockFrames(maxBlockFrames), m_latency(0)
+{
+    const unsigned int nodeCount = static_cast<unsigned int>(nodes.size());
+
+    std::map<std::string, unsigned int> indices;
+    for (unsigned int i = 0; i < nodeCount; ++i) {
+        const std::string& name = nodes[i].name;
+        if (name.empty() || name == kInputName) {
+            throw std::invalid_argument("Effect graph: invalid node name '" + name + "'");
+        }
+        if (!indices.emplace(name, i).second) {
+            throw std::invalid_argument("Effect graph: duplicate node '" + name + "'");
+        }
+    }
+
+    auto output = indices.find(kOutputName);
+    if (output == indices.end()) {
+        throw std::invalid_argument("Effect graph: no 'output' node");
+    }
+
+    // Resolve the source names once
+    std::vector<std::vector<int>> sources(nodeCount);
+    for (unsigned int i = 0; i < nodeCount; ++i) {
+        for (const auto& input : nodes[i].inputs) {
+            if (input.source == kInputName) {
+                sources[i].push_back(kVoiceSource);
+                continue;
+            }
+            auto source = indices.find(input.source);
+            if (source == indices.end()) {
+                throw std::invalid_argument("Effect graph: node '" + nodes[i].name +
+                                            "' reads unknown node '" + input.source + "'");
+            }
+            sources[i].push_back(static_cast<int>(source->second));
+        }
+    }
+
+    // Only the nodes that lead to the output are scheduled
+    std::vector<bool> used(nodeCount, false);
+    std::vector<unsigned int> pending(1, output->second);
+    used[output->second] = true;
+    while (!pending.empty()) {
+        const unsigned int node = pending.back();
+        pending.pop_back();
+        for (int source : sources[node]) {
+            if (source != kVoiceSource && !used[source]) {
+                used[source] = true;
+                pending.push_back(static_cast<unsigned int>(source));
+            }
+        }
+    }
+
+    // Kahn's algorithm; among the ready nodes the earliest listed runs first,
+    // so a graph written in signal order keeps that order
+    std::vector<unsigned int> unresolved(nodeCount, 0);
+    unsigned int usedCount = 0;
+    for (unsigned int i = 0; i < nodeCount; ++i) {
+        if (!used[i]) {
+            continue;
+        }
+        ++usedCount;
+        for (int source : sources[i]) {
+            if (source != kVoiceSource) {
+                ++unresolved[i];
+            }
+        }
+    }
+
+    std::vector<bool> scheduled(nodeCount, false);
+    while (m_order.size() < usedCount) {
+        unsigned int next = nodeCount;
+        for (unsigned int i = 0; i < nodeCount; ++i) {
+            if (used[i] && !scheduled[i] && unresolved[i] == 0) {
+                next = i;
+                break;
+            }
+        }
+        if (next == nodeCount) {
+            throw std::invalid_argument("Effect graph: the connections form a cycle");
+        }
+
+        scheduled[next] = true;
+        m_order.push_back(next);
+        for (unsigned int i = 0; i < nodeCount; ++i) {
+            if (used[i] && !scheduled[i]) {
+                unresolved[i] -= static_cast<unsigned int>(std::count(sources[i].begin(), sources[i].end(),
+                                                                      static_cast<int>(next)));
+            }
+        }
+    }
+
+    // Buffer 0 is the voice mix; the node scheduled at step k writes buffer k + 1
+    std::vector<unsigned int> bufferOf(nodeCount, 0);
+    std::vector<unsigned int> latencyOf(nodeCount, 0);
+    unsigned int delayFrames = 0;
+    for (unsigned int step = 0; step < m_order.size(); ++step) {
+        const unsigned int node = m_order[step];
+        bufferOf[node] = step + 1;
+
+        Step entry;
+        entry.buffer = step + 1;
+        entry.firstConnection = static_cast<unsigned int>(m_connections.size());
+        entry.connectionCount = static_cast<unsigned int>(sources[node].size());
+        entry.effect = node < effects.size() ? effects[node].get() : nullptr;
+        m_steps.push_back(entry);
+
+        unsigned int latency = 0;
+        for (int source : sources[node]) {
+            if (source != kVoiceSource) {
+                latency = std::max(latency, latencyOf[source]);
+            }
+        }
+
+        // Inputs that arrive early are delayed to line up with the latest one
+        for (size_t j = 0; j < sources[node].size(); ++j) {
+            const int source = sources[node][j];
+            Connection connection;
+            connection.source = source == kVoiceSource ? 0 : bufferOf[source];
+            connection.gain = nodes[node].inputs[j].gain;
+            connection.delay = -1;
+            const unsigned int lag = latency - (source == kVoiceSource ? 0 : latencyOf[source]);
+            if (lag > 0) {
+                Delay delay;
+                delay.offset = delayFrames;
+                delay.length = lag;
+                delay.position = 0;
+                delay.pending = 0;
+                connection.delay = static_cast<int>(m_delays.size());
+                m_delays.push_back(delay);
+                delayFrames += 2 * lag;
+            }
+            m_connections.push_back(connection);
+        }
+        latencyOf[node] = latency + (entry.effect ? entry.effect->getLatency() : 0);
+    }
+    m_latency = latencyOf[output->second];
+
+    m_buffers.assign(2 * m_steps.size() * maxBlockFrames, 0.0f);
+    m_silent.assign(m_steps.size() + 1, 1);
+    m_delayBuffers.assign(delayFrames, 0.0f);
+}
+
+void EffectGraph::reset()
+{
+    std::fill(m_delayBuffers.begin(), m_delayBuffers.end(), 0.0f);
+    for (Delay& delay : m_delays) {
+        delay.position = 0;
+        delay.pending = 0;
+    }
+}
+
+void EffectGraph::sumDelayed(Delay& delay, const float* inLeft, const float* inRight, float gain,
+                             float* outLeft, float* outRight, unsigned int numFrames, bool add)
+{
+    // A silent input (null) feeds zeros, pushing out what the delay still holds
+    float* lineLeft = m_delayBuffers.data() + delay.offset;
+    float* lineRight = lineLeft + delay.length;
+    unsigned int position = delay.position;
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        const float delayedLeft = lineLeft[position];
+        const float delayedRight = lineRight[position];
+        lineLeft[position] = inLeft ? inLeft[i] : 0.0f;
+        lineRight[position] = inRight ? inRight[i] : 0.0f;
+        if (++position == delay.length) {
+            position = 0;
+        }
+        outLeft[i] = (add ? outLeft[i] : 0.0f) + gain * delayedLeft;
+        outRight[i] = (add ? outRight[i] : 0.0f) + gain * delayedRight;
+    }
+    delay.position = position;
+
+    if (inLeft) {
+        delay.pending = delay.length;
+    } else {
+        delay.pending -= std::min(delay.pending, numFrames);
+    }
+}
+
+bool EffectGraph::process(float* left, float* right, unsigned int numFrames, bool inputSilent)
+{
+    m_silent[0] = inputSilent ? 1 : 0;
+
+    for (const Step& step : m_steps)
+    {
+        float* outLeft = leftBuffer(step.buffer);
+        float* outRight = rightBuffer(step.buffer);
+        bool silent = true;
+
+        // The first audible source is copied, the others are added
+        const Connection* connection = m_connections.data() + step.firstConnection;
+        for (unsigned int c = 0; c < step.connectionCount; ++c, ++connection)
+        {
+            const bool sourceSilent = m_silent[connection->source] != 0;
+            if (connection->delay >= 0) {
+                // Runs while the delay still holds audio, even once its source is silent
+                Delay& delay = m_delays[connection->delay];
+                if (sourceSilent && delay.pending == 0) {
+                    continue;
+                }
+                const float* inLeft = sourceSilent ? nullptr
+                                    : connection->source == 0 ? left : leftBuffer(connection->source);
+                const float* inRight = sourceSilent ? nullptr
+                                     : connection->source == 0 ? right : rightBuffer(connection->source);
+                sumDelayed(delay, inLeft, inRight, connection->gain, outLeft, outRight, numFrames, !silent);
+                silent = false;
+                continue;
+            }
+            if (sourceSilent) {
+                continue;
+            }
+            const float* inLeft = connection->source == 0 ? left : leftBuffer(connection->source);
+            const float* inRight = connection->source == 0 ? right : rightBuffer(connection->source);
+            const float gain = connection->gain;
+            if (silent) {
+                for (unsigned int i = 0; i < numFrames; ++i) {
+                    outLeft[i] = gain * inLeft[i];
+                    outRight[i] = gain * inRight[i];
+                }
+            } else {
+                for (unsigned int i = 0; i < numFrames; ++i) {
+                    outLeft[i] += gain * inLeft[i];
+                    outRight[i] += gain * inRight[i];
+                }
+            }
+            silent = false;
+        }
+
+        if (step.effect != nullptr) {
+            // A silent effect fed silence would only output silence
+            if (silent && !step.effect->isSilent()) {
+                std::fill(outLeft, outLeft + numFrames, 0.0f);
+                std::fill(outRight, outRight + numFrames, 0.0f);
+                silent = false;
+            }
+            if (!silent) {
+                step.effect->processBlock(outLeft, outRight, numFrames);
+            }
+        }
+        m_silent[step.buffer] = silent ? 1 : 0;
+    }
+
+    // "output" is always scheduled last
+    const unsigned int output = m_steps.back().buffer;
+    if (m_silent[output]) {
+        std::fill(left, left + numFrames, 0.0f);
+        std::fill(right, right + numFrames, 0.0f);
+        return true;
+    }
+    std::copy(leftBuffer(output), leftBuffer(output) + numFrames, left);
+    std::copy(rightBuffer(output), rightBuffer(output) + numFrames, right);
+    return false;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include "AudioConfig.h"
+#include "Effects/IEffect.h"
+
+/**
+ * @file EffectGraph.h
+ * @brief Effect graph compiled into a flat execution schedule
+ */
+
+/**
+ * @class EffectGraph
+ * @brief Parallel branches, merges and send buses between effects
+ *
+ * The graph is described by EffectGraphNode entries: every node sums its
+ * inputs, each at its own gain, and optionally runs an effect on the sum.
+ * A split is two nodes reading the same source, a wet/dry merge is a mixer
+ * node reading both paths, and an aux send is a low-gain input into a bus
+ * node whose output is summed back in further down. The reserved source
+ * "input" is the voice mix and the node named "output" is the graph's
+ * result.
+ *
+ * The constructor (control thread) checks the description, sorts the nodes
+ * topologically and allocates one stereo buffer per node, so process() only
+ * walks a flat array of steps. Nodes that do not lead to "output" are
+ * dropped from the schedule.
+ *
+ * Parallel paths are latency-compensated: when the inputs of a node arrive
+ * with different latencies (dry plus an oversampled drive, say), each
+ * earlier input passes through a delay line preallocated to the difference,
+ * so the merge does not comb-filter. The graph reports the latency of its
+ * longest path.
+ */
+class EffectGraph
+{
+public:
+    /**
+     * @brief Compile a graph (allocates, control thread only)
+     * @param nodes          Node descriptions, in any order
+     * @param effects        Prepared effect of each node (nullptr for mixers), parallel to @p nodes
+     * @param maxBlockFrames Largest block passed to process()
+     * @throws std::invalid_argument for duplicate or reserved names, unknown
+     *         sources, cycles or a missing "output" node
+     */
+    EffectGraph(const std::vector<EffectGraphNode>& nodes, const std::vector<std::shared_ptr<IEffect>>& effects,
+                unsigned int maxBlockFrames);
+
+    /**
+     * @brief Run a block through the graph in place (audio thread)
+     * @param left        Voice mix in, graph output out (left channel)
+     * @param right       Voice mix in, graph output out (right channel)
+     * @param numFrames   Number of frames, at most the prepared maximum
+     * @param inputSilent True if the voice mix is silent; silent effects fed
+     *                    only silence are then skipped
+     * @return true if the output is silent
+     */
+    bool process(float* left, float* right, unsigned int numFrames, bool inputSilent = false);
+
+    /// Clear the latency-compensation delays (audio thread; does not reset the node effects)
+    void reset();
+
+    /// Indices into the constructor's @p nodes of the scheduled nodes, in execution order
+    const std::vector<unsigned int>& getOrder() const { return m_order; }
+    /// Latency of the longest path to "output", in frames
+    unsigned int getLatency() const { return m_latency; }
+
+private:
+    /// Summing of one source buffer into a step's buffer
+    struct Connection {
+        unsigned int source;    ///< Buffer read (0 is the voice mix)
+        float gain;             ///< Level it is summed in at
+        int delay;              ///< Entry in m_delays aligning it with the step's other inputs, or -1
+    };
+
+    /// Stereo ring delaying one connection by a fixed number of frames
+    struct Delay {
+        unsigned int offset;    ///< Start of its planar stereo storage in m_delayBuffers
+        unsigned int length;    ///< Delay in frames
+        unsigned int position;  ///< Next frame read and overwritten
+        unsigned int pending;   ///< Frames until the audio it holds has passed out (0 once silent)
+    };
+
+    /// Work for one node: sum the connections, then run the effect
+    struct Step {
+        unsigned int buffer;            ///< Buffer written
+        unsigned int firstConnection;   ///< First entry in m_connections
+        unsigned int connectionCount;   ///< Number of entries in m_connections
+        IEffect* effect;                ///< Effect run on the sum (owned by the chain), or nullptr
+    };
+
+    std::vector<Step> m_steps;              ///< Schedule in topological order
+    std::vector<Connection> m_connections;  ///< Inputs of all steps, grouped per step
+    std::vector<unsigned int> m_order;      ///< Node index of each step
+    std::vector<float> m_buffers;           ///< Planar stereo buffer per step
+    std::vector<unsigned char> m_silent;    ///< Whether each buffer holds only silence in this block
+    std::vector<Delay> m_delays;            ///< Latency-compensation delays of the connections
+    std::vector<float> m_delayBuffers;      ///< Storage of all delays
+    unsigned int m_maxBlockFrames;          ///< Frames per channel of each buffer
+    unsigned int m_latency;                 ///< Latency of the longest path to "output"
+
+    float* leftBuffer(unsigned int buffer) { return m_buffers.data() + (2 * buffer - 2) * m_maxBlockFrames; }
+    float* rightBuffer(unsigned int buffer) { return leftBuffer(buffer) + m_maxBlockFrames; }
+
+    void sumDelayed(Delay& delay, const float* inLeft, const float* inRight, float gain,
+                    float* outLeft, float* outRight, unsigned int numFrames, bool add);
+};
@@ -0,0 +1,36 @@
+#include "MasterBus.h"
+
+MasterBus::MasterBus(const AudioConfig& config, float sampleRate, unsigned int maxBlockFrames)
+{
+    if (config.compressorEnabled) {
+        m_compressor = std::make_unique<CompressorEffect>(config.compressorThreshold, config.compressorRatio,
+                                                          config.compressorAttack, config.compressorRelease,
+                                                          config.compressorKnee, config.compressorMakeup, sampleRate);
+        m_compressor->prepare(sampleRate, maxBlockFrames);
+    }
+    if (config.limiterEnabled) {
+        m_limiter = std::make_unique<LimiterEffect>(config.limiterCeiling, config.limiterLookahead,
+                                                    config.limiterRelease, sampleRate);
+        m_limiter->prepare(sampleRate, maxBlockFrames);
+    }
+}
+
+void MasterBus::process(float* left, float* right, unsigned int numFrames)
+{
+    if (m_compressor) {
+        m_compressor->processBlock(left, right, numFrames);
+    }
+    if (m_limiter) {
+        m_limiter->processBlock(left, right, numFrames);
+    }
+}
+
+void MasterBus::reset()
+{
+    if (m_compressor) {
+        m_compressor->reset();
+    }
+    if (m_limiter) {
+        m_limiter->reset();
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include "AudioConfig.h"
+#include "Effects/CompressorEffect.h"
+#include "Effects/LimiterEffect.h"
+
+/**
+ * @file MasterBus.h
+ * @brief Dynamics stage applied to the final stereo mix
+ */
+
+/**
+ * @class MasterBus
+ * @brief Optional compressor followed by an optional true-peak limiter
+ *
+ * The voice sum and the effect chain can easily go past full scale (the
+ * octave effect adds a full-scale square, a delay with high feedback stacks
+ * repeats), which the DAC would clip hard. The master bus runs after the
+ * chain and after any chain crossfade, so it keeps its state when the effect
+ * chain is swapped. Both stages are built and prepared in the constructor
+ * from the master settings of an AudioConfig.
+ */
+class MasterBus
+{
+public:
+    /**
+     * @brief Build and prepare the enabled stages (allocates, control thread only)
+     * @param config         Master compressor and limiter settings
+     * @param sampleRate     Sampling rate of the audio system
+     * @param maxBlockFrames Largest block passed to process()
+     */
+    MasterBus(const AudioConfig& config, float sampleRate, unsigned int maxBlockFrames);
+
+    /** Compress and limit a block of planar stereo samples in place */
+    void process(float* left, float* right, unsigned int numFrames);
+
+    /** Clear the limiter's lookahead and release all gain reduction */
+    void reset();
+
+    /** Delay added by the limiter's lookahead, in frames */
+    unsigned int getLatency() const { return m_limiter ? m_limiter->getLatency() : 0; }
+
+    /// Current compressor gain reduction in dB (0 when disabled)
+    float getCompressorReduction() const { return m_compressor ? m_compressor->getGainReduction() : 0.0f; }
+    /// Current limiter gain reduction in dB (0 when disabled)
+    float getLimiterReduction() const { return m_limiter ? m_limiter->getGainReduction() : 0.0f; }
+
+private:
+    std::unique_ptr<CompressorEffect> m_compressor;   ///< Compressor, or null when disabled
+    std::unique_ptr<LimiterEffect> m_limiter;         ///< Limiter, or null when disabled
+};
@@ -0,0 +1,215 @@
+#include "RealtimeSetup.h"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define REALTIME_HAVE_MXCSR 1
+#else
+#define REALTIME_HAVE_MXCSR 0
+#endif
+
+namespace {
+    constexpr size_t kPrefaultStackBytes = 64 * 1024;   ///< Stack touched by prefaultStack()
+    thread_local int t_threadPriority = 0;              ///< Last priority setThreadPriority() obtained
+#if REALTIME_HAVE_MXCSR
+    constexpr unsigned int kMxcsrFlushToZero = 0x8000;      ///< FTZ: denormal results become zero
+    constexpr unsigned int kMxcsrDenormalsAreZero = 0x0040; ///< DAZ: denormal inputs read as zero
+    constexpr unsigned int kMxcsrExceptionFlags = 0x003F;   ///< Sticky status bits, not part of the mode
+#elif defined(__aarch64__)
+    constexpr uint64_t kFpcrFlushToZero = 1ull << 24;       ///< FZ: denormal inputs and results become zero
+#endif
+}
+
+std::string RealtimeStatus::describe() const
+{
+    std::string text;
+    auto add = [&text](const std::string& item) {
+        text += text.empty() ? item : ", " + item;
+    };
+
+    // Until the rendering thread has run its setup, show what it will try
+    if (requestedPriority > 0) {
+        if (priority > 0 || !applied) {
+            add("SCHED_FIFO " + std::to_string(applied ? priority : requestedPriority));
+        } else {
+            add("normal priority (SCHED_FIFO " + std::to_string(requestedPriority) + " not permitted)");
+        }
+    }
+    if (requestedCpus > 0) {
+        add(pinned || !applied ? "pinned to " + std::to_string(requestedCpus) + " CPU(s)" : "not pinned (affinity refused)");
+    }
+    if (flushRequested) {
+        add(denormalsFlushed || !applied ? "FTZ/DAZ" : "denormals not flushed (unsupported)");
+    }
+    if (!applied && !text.empty()) {
+        text += " (pending first callback)";
+    }
+    if (lockRequested) {
+        add(memoryLocked ? "memory locked" : "memory not locked (mlockall refused)");
+    }
+    return text.empty() ? "not configured" : text;
+}
+
+RealtimeSetup::RealtimeSetup()
+    : m_priority(0), m_flushDenormals(false), m_lockMemory(false),
+      m_obtainedPriority(0), m_requestedPriority(0), m_pinned(false), m_denormalsFlushed(false),
+      m_memoryLocked(false), m_applied(false)
+{
+}
+
+void RealtimeSetup::configure(const AudioConfig& config)
+{
+    m_priority = std::max(config.realtimePriority, 0);
+    m_cpus = config.realtimeCpus;
+    m_flushDenormals = config.flushDenormals;
+    m_lockMemory = config.lockMemory;
+    m_requestedPriority.store(m_priority, std::memory_order_relaxed);
+}
+
+void RealtimeSetup::lockMemory()
+{
+    if (!m_lockMemory || m_memoryLocked.load(std::memory_order_relaxed)) {
+        return;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    // With a finite limit, locking future mappings would make allocations
+    // fail once it is reached; lock what exists and leave later ones alone
+    int flags = MCL_CURRENT;
+    rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY) {
+        flags |= MCL_FUTURE;
+    }
+    // MCL_CURRENT faults in every page it locks, the engine's buffers included
+    if (mlockall(flags) == 0) {
+        prefaultStack();
+        m_memoryLocked.store(true, std::memory_order_relaxed);
+    }
+#endif
+}
+
+void RealtimeSetup::applyToCurrentThread(int defaultPriority)
+{
+    const int priority = m_priority > 0 ? m_priority : defaultPriority;
+    const int obtained = priority > 0 ? setThreadPriority(priority) : 0;
+    bool pinned = false;
+
+#if defined(__linux__)
+    if (!m_cpus.empty()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (unsigned int cpu : m_cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        pinned = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+    }
+#endif
+
+    const bool flushed = m_flushDenormals && flushDenormals();
+    if (m_memoryLocked.load(std::memory_order_relaxed)) {
+        prefaultStack();
+    }
+
+    m_requestedPriority.store(priority, std::memory_order_relaxed);
+    m_obtainedPriority.store(obtained, std::memory_order_relaxed);
+    m_pinned.store(pinned, std::memory_order_relaxed);
+    m_denormalsFlushed.store(flushed, std::memory_order_relaxed);
+    m_applied.store(true, std::memory_order_release);
+}
+
+RealtimeStatus RealtimeSetup::getStatus() const
+{
+    RealtimeStatus status;
+    status.applied = m_applied.load(std::memory_order_acquire);
+    status.requestedPriority = m_requestedPriority.load(std::memory_order_relaxed);
+    status.priority = m_obtainedPriority.load(std::memory_order_relaxed);
+    status.requestedCpus = static_cast<unsigned int>(m_cpus.size());
+    status.pinned = m_pinned.load(std::memory_order_relaxed);
+    status.flushRequested = m_flushDenormals;
+    status.denormalsFlushed = m_denormalsFlushed.load(std::memory_order_relaxed);
+    status.lockRequested = m_lockMemory;
+    status.memoryLocked = m_memoryLocked.load(std::memory_order_relaxed);
+    return status;
+}
+
+int RealtimeSetup::setThreadPriority(int priority)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    sched_param param{};
+    int policy = SCHED_OTHER;
+    if (priority > 0) {
+        policy = SCHED_FIFO;
+        param.sched_priority = std::min(std::max(priority, sched_get_priority_min(SCHED_FIFO)),
+                                        sched_get_priority_max(SCHED_FIFO));
+    }
+    if (pthread_setschedparam(pthread_self(), policy, &param) == 0) {
+        t_threadPriority = param.sched_priority;
+    }
+#else
+    (void)priority;
+#endif
+    return t_threadPriority;
+}
+
+int RealtimeSetup::getThreadPriority()
+{
+    return t_threadPriority;
+}
+
+bool RealtimeSetup::flushDenormals()
+{
+#if REALTIME_HAVE_MXCSR
+    _mm_setcsr(_mm_getcsr() | kMxcsrFlushToZero | kMxcsrDenormalsAreZero);
+    return true;
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | kFpcrFlushToZero));
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned int RealtimeSetup::getFloatMode()
+{
+#if REALTIME_HAVE_MXCSR
+    return _mm_getcsr() & ~kMxcsrExceptionFlags;
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return static_cast<unsigned int>(fpcr);
+#else
+    return 0;
+#endif
+}
+
+void RealtimeSetup::setFloatMode(unsigned int mode)
+{
+#if REALTIME_HAVE_MXCSR
+    _mm_setcsr(mode);
+#elif defined(__aarch64__)
+    const uint64_t fpcr = mode;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#else
+    (void)mode;
+#endif
+}
+
+void RealtimeSetup::prefaultStack()
+{
+    volatile unsigned char stack[kPrefaultStackBytes];
+    for (size_t i = 0; i < kPrefaultStackBytes; i += 1024) {
+        stack[i] = 0;
+    }
+    (void)stack[0];
+}
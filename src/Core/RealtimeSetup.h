@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "AudioConfig.h"
+
+/**
+ * @file RealtimeSetup.h
+ * @brief Scheduling, CPU pinning, denormal mode and memory locking of the audio path
+ */
+
+/**
+ * @struct RealtimeStatus
+ * @brief What the real-time setup asked for and what it obtained
+ */
+struct RealtimeStatus
+{
+    bool applied;                   ///< The rendering thread has run its setup since start()
+    int requestedPriority;          ///< SCHED_FIFO priority asked for, 0 if none
+    int priority;                   ///< SCHED_FIFO priority obtained, 0 for normal scheduling
+    unsigned int requestedCpus;     ///< CPUs the thread should be pinned to, 0 if not pinned
+    bool pinned;                    ///< The thread is pinned to them
+    bool flushRequested;            ///< Flush-to-zero / denormals-are-zero asked for
+    bool denormalsFlushed;          ///< FTZ/DAZ set on the rendering thread
+    bool lockRequested;             ///< Memory locking asked for
+    bool memoryLocked;              ///< Process memory locked and prefaulted
+
+    RealtimeStatus() : applied(false), requestedPriority(0), priority(0), requestedCpus(0), pinned(false),
+                       flushRequested(false), denormalsFlushed(false), lockRequested(false), memoryLocked(false) {}
+
+    /** One-line summary for logs and the status panel, e.g. "SCHED_FIFO 80, CPUs 2, FTZ/DAZ, memory locked" */
+    std::string describe() const;
+};
+
+/**
+ * @class RealtimeSetup
+ * @brief Applies the <realtime> settings to the thread that renders audio
+ *
+ * The thread settings are per thread, so they are applied from the thread
+ * itself: the first RtAudio callback after start(), or the render-ahead
+ * thread when it starts. Doing it there costs a few system calls once per
+ * start instead of depending on how the audio API created its thread.
+ * Memory locking is process-wide and done on the control thread by start().
+ *
+ * Flushing denormals matters for decaying feedback (delay lines, filter and
+ * reverb state): once a tail falls below ~1e-38 every multiply on it can
+ * take a hundred cycles or more, which shows up as callback spikes long
+ * after the notes have stopped. VoiceWorkerPool copies the audio thread's
+ * floating-point mode to its workers, so the setting covers them as well.
+ *
+ * Failures are not fatal: the status records what was obtained, and the
+ * applications report it after the stream has started.
+ */
+class RealtimeSetup
+{
+public:
+    RealtimeSetup();
+
+    RealtimeSetup(const RealtimeSetup&) = delete;
+    RealtimeSetup& operator=(const RealtimeSetup&) = delete;
+
+    /**
+     * @brief Take the <realtime> settings (control thread, before start)
+     * @param config Configuration holding the realtime* fields
+     */
+    void configure(const AudioConfig& config);
+
+    /**
+     * @brief Lock the process memory if configured (control thread)
+     *
+     * Locks current and future mappings when RLIMIT_MEMLOCK is unlimited,
+     * otherwise only the current ones, so later allocations can never fail
+     * against the limit.
+     */
+    void lockMemory();
+
+    /**
+     * @brief Apply priority, pinning and denormal mode to the calling thread
+     *
+     * Makes system calls; call once per start from the rendering thread.
+     *
+     * @param defaultPriority SCHED_FIFO priority used when none is configured (0 for none)
+     */
+    void applyToCurrentThread(int defaultPriority = 0);
+
+    /**
+     * @brief What was requested and obtained (any thread)
+     */
+    RealtimeStatus getStatus() const;
+
+    /**
+     * @brief Set flush-to-zero and denormals-are-zero on the calling thread
+     * @return false if the platform has no such mode
+     */
+    static bool flushDenormals();
+
+    /**
+     * @brief Set the calling thread's scheduling
+     * @param priority SCHED_FIFO priority, 0 for normal scheduling
+     * @return Priority obtained, 0 if normal scheduling is in effect
+     */
+    static int setThreadPriority(int priority);
+
+    /// SCHED_FIFO priority the calling thread obtained through this class, 0 if none (cheap, no system call)
+    static int getThreadPriority();
+
+    /// Floating-point control word of the calling thread (MXCSR or FPCR), 0 where unsupported
+    static unsigned int getFloatMode();
+    /// Restore a word returned by getFloatMode() on the calling thread
+    static void setFloatMode(unsigned int mode);
+
+private:
+    /** Touch the stack the callback will use so it is resident before it is needed */
+    static void prefaultStack();
+
+    // Settings, written by configure() before the rendering thread starts
+    int m_priority;                         ///< SCHED_FIFO priority, 0 to leave the scheduling alone
+    std::vector<unsigned int> m_cpus;       ///< CPUs to pin to, empty for any
+    bool m_flushDenormals;                  ///< Set FTZ/DAZ
+    bool m_lockMemory;                      ///< mlockall and prefault
+
+    // Outcome, written by the thread that applied it
+    std::atomic<int> m_obtainedPriority;    ///< SCHED_FIFO priority in effect, 0 for none
+    std::atomic<int> m_requestedPriority;   ///< Priority the last applyToCurrentThread() asked for
+    std::atomic<bool> m_pinned;             ///< Affinity set
+    std::atomic<bool> m_denormalsFlushed;   ///< FTZ/DAZ set
+    std::atomic<bool> m_memoryLocked;       ///< mlockall succeeded
+    std::atomic<bool> m_applied;            ///< Published last by applyToCurrentThread()
+};
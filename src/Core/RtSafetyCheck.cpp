@@ -0,0 +1,287 @@
+#include "RtSafetyCheck.h"
+
+#if AUDIO_RT_CHECK
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <map>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "MpscQueue.h"
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+constexpr bool RtSafetyCheck::kEnabled;
+
+namespace {
+    constexpr int kMaxFrames = 24;          ///< Return addresses kept per violation
+    constexpr int kHookFrames = 2;          ///< Frames of record() and the hook, left out of reports
+
+    /// One forbidden call, as recorded by the offending thread
+    struct Violation {
+        const char* call;                   ///< Name of the intercepted function
+        int depth;                          ///< Valid entries in frames
+        void* frames[kMaxFrames];           ///< Return addresses, innermost first
+    };
+
+    thread_local int t_realtimeDepth = 0;   ///< Scopes the thread is inside
+    thread_local int t_recording = 0;       ///< Set while a call is checked or already counted
+
+    MpscQueue<Violation, 256> g_violations; ///< Recorded, not yet reported
+    std::atomic<unsigned long long> g_count(0);
+    std::atomic<unsigned long long> g_dropped(0);
+    std::atomic<bool> g_ready(false);       ///< The queue is constructed and the unwinder loaded
+
+    /**
+     * @brief Note a forbidden call if the calling thread is marked real-time
+     *
+     * Runs on the offending thread: only copies addresses into the queue.
+     */
+    void record(const char* call) {
+        if (t_realtimeDepth == 0 || t_recording != 0 || !g_ready.load(std::memory_order_acquire)) {
+            return;
+        }
+        ++t_recording;
+        Violation violation;
+        violation.call = call;
+        violation.depth = backtrace(violation.frames, kMaxFrames);
+        g_count.fetch_add(1, std::memory_order_relaxed);
+        if (!g_violations.push(violation)) {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        --t_recording;
+    }
+
+    /** Demangled function of a backtrace_symbols() line, "binary(mangled+0x1f) [0x...]" */
+    std::string describeFrame(const char* symbol) {
+        std::string line(symbol);
+        const size_t open = line.find('(');
+        const size_t plus = line.find('+', open);
+        if (open == std::string::npos || plus == std::string::npos || plus == open + 1) {
+            return line;
+        }
+        int status = 0;
+        char* name = abi::__cxa_demangle(line.substr(open + 1, plus - open - 1).c_str(), nullptr, nullptr, &status);
+        if (status != 0 || name == nullptr) {
+            return line;
+        }
+        std::string result = std::string(name) + " (" + line.substr(0, open) + ")";
+        std::free(name);
+        return result;
+    }
+
+    void* allocate(std::size_t size, const char* call) {
+        record(call);
+        // The malloc below belongs to the same violation
+        ++t_recording;
+        void* memory;
+        while ((memory = std::malloc(size > 0 ? size : 1)) == nullptr) {
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                --t_recording;
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+        --t_recording;
+        return memory;
+    }
+
+    void deallocate(void* memory, const char* call) {
+        if (memory == nullptr) {
+            return;
+        }
+        record(call);
+        ++t_recording;
+        std::free(memory);
+        --t_recording;
+    }
+
+#if defined(__GLIBC__)
+    typedef int (*MutexLock)(pthread_mutex_t*);
+    std::atomic<MutexLock> g_mutexLock(nullptr);    ///< glibc's pthread_mutex_lock
+
+    MutexLock realMutexLock() {
+        MutexLock lock = g_mutexLock.load(std::memory_order_relaxed);
+        if (lock == nullptr) {
+            lock = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            g_mutexLock.store(lock, std::memory_order_relaxed);
+        }
+        return lock;
+    }
+#endif
+
+    /// Loads what record() needs before any thread is marked
+    struct Startup {
+        Startup() {
+            // The first backtrace() loads the unwinder, which allocates
+            void* frame;
+            backtrace(&frame, 1);
+#if defined(__GLIBC__)
+            realMutexLock();
+#endif
+            g_ready.store(true, std::memory_order_release);
+        }
+    } g_startup;
+}
+
+RtSafetyCheck::Scope::Scope()
+{
+    ++t_realtimeDepth;
+}
+
+RtSafetyCheck::Scope::~Scope()
+{
+    --t_realtimeDepth;
+}
+
+unsigned long long RtSafetyCheck::reportViolations(std::ostream& out)
+{
+    static std::map<std::vector<void*>, unsigned long long> reported;  // Distinct stacks seen so far
+    static unsigned long long reportedDrops = 0;
+
+    unsigned long long count = 0;
+    Violation violation;
+    while (g_violations.pop(violation)) {
+        ++count;
+        const int first = std::min(kHookFrames, violation.depth);
+        std::vector<void*> stack(violation.frames + first, violation.frames + violation.depth);
+        if (reported[stack]++ > 0) {
+            continue;
+        }
+
+        out << "RT check: " << violation.call << "() on a real-time thread" << std::endl;
+        char** symbols = backtrace_symbols(stack.data(), static_cast<int>(stack.size()));
+        for (size_t i = 0; i < stack.size(); ++i) {
+            out << "    #" << i << ' ' << (symbols ? describeFrame(symbols[i]) : "?") << std::endl;
+        }
+        std::free(symbols);
+    }
+
+    const unsigned long long dropped = g_dropped.load(std::memory_order_relaxed);
+    if (dropped > reportedDrops) {
+        out << "RT check: " << dropped - reportedDrops << " more violation(s) without a stack (queue full)" << std::endl;
+        reportedDrops = dropped;
+    }
+    return count;
+}
+
+unsigned long long RtSafetyCheck::getViolationCount()
+{
+    return g_count.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// Replacement allocation functions
+// -----------------------------------------------------------------------------
+
+void* operator new(std::size_t size) { return allocate(size, "operator new"); }
+void* operator new[](std::size_t size) { return allocate(size, "operator new[]"); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return allocate(size, "operator new");
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return allocate(size, "operator new[]");
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept { deallocate(memory, "operator delete"); }
+void operator delete[](void* memory) noexcept { deallocate(memory, "operator delete[]"); }
+void operator delete(void* memory, std::size_t) noexcept { deallocate(memory, "operator delete"); }
+void operator delete[](void* memory, std::size_t) noexcept { deallocate(memory, "operator delete[]"); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { deallocate(memory, "operator delete"); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { deallocate(memory, "operator delete[]"); }
+
+#if defined(__GLIBC__)
+// -----------------------------------------------------------------------------
+// C allocator and mutex interposition (glibc exports its allocator as __libc_*)
+// -----------------------------------------------------------------------------
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* memory, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* memory);
+
+    void* malloc(size_t size) noexcept
+    {
+        record("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        record("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* memory, size_t size) noexcept
+    {
+        record("realloc");
+        return __libc_realloc(memory, size);
+    }
+
+    void free(void* memory) noexcept
+    {
+        if (memory != nullptr) {
+            record("free");
+        }
+        __libc_free(memory);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        record("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        record("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** memory, size_t alignment, size_t size) noexcept
+    {
+        if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+            return EINVAL;
+        }
+        record("posix_memalign");
+        void* result = __libc_memalign(alignment, size);
+        if (result == nullptr) {
+            return ENOMEM;
+        }
+        *memory = result;
+        return 0;
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        record("pthread_mutex_lock");
+        return realMutexLock()(mutex);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <iosfwd>
+
+/**
+ * @file RtSafetyCheck.h
+ * @brief Debug check for heap and mutex calls on the audio threads
+ */
+
+#ifndef AUDIO_RT_CHECK
+#define AUDIO_RT_CHECK 0
+#endif
+
+/**
+ * @class RtSafetyCheck
+ * @brief Flags allocations and locks made from threads marked as real-time
+ *
+ * Only compiled in with the AUDIO_RT_CHECK CMake option. The build then
+ * replaces the global operator new and delete and, on glibc, malloc,
+ * calloc, realloc, free, the aligned allocators and pthread_mutex_lock.
+ * While a thread is inside a Scope, each such call is a violation: the
+ * thread copies the return addresses of its stack into a lock-free queue
+ * and carries on. The unwinder is loaded at startup, so this capture does
+ * not allocate itself. Symbolizing and printing the stacks is left to a
+ * control thread calling reportViolations(), which prints every distinct
+ * stack once.
+ *
+ * AudioSystem::renderBlock(), the RtAudio callback and the voice workers
+ * mark themselves, so the console app and the offline renderer are covered
+ * without further changes.
+ *
+ * Without the option Scope is empty and the functions return 0, so the
+ * marks cost nothing in normal builds.
+ */
+class RtSafetyCheck
+{
+public:
+    /**
+     * @class Scope
+     * @brief Marks the calling thread as real-time for the lifetime of the object
+     *
+     * Scopes nest; the thread is unmarked when the outermost one ends.
+     */
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    /// Whether the check is compiled in
+    static constexpr bool kEnabled = AUDIO_RT_CHECK != 0;
+
+    /**
+     * @brief Print the violations recorded since the last call (one control thread at a time)
+     * @param out Stream the stack traces are written to
+     * @return Number of violations taken from the queue by this call
+     */
+    static unsigned long long reportViolations(std::ostream& out);
+
+    /**
+     * @brief Violations recorded since startup, printed or not (any thread)
+     */
+    static unsigned long long getViolationCount();
+};
+
+#if !AUDIO_RT_CHECK
+inline RtSafetyCheck::Scope::Scope() {}
+inline RtSafetyCheck::Scope::~Scope() {}
+inline unsigned long long RtSafetyCheck::reportViolations(std::ostream&) { return 0; }
+inline unsigned long long RtSafetyCheck::getViolationCount() { return 0; }
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <string>
+#include "Effects/IEffect.h"
+#include "Waves/IWave.h"
+#include "VoicePool.h"
+#include "VoiceWorkerPool.h"
+#include "MasterBus.h"
+#include "DSP/BlockLfo.h"
+#include "EffectGraph.h"
+
+/**
+ * @file SignalChain.h
+ * @brief Immutable snapshot of everything the audio thread renders with
+ */
+
+/**
+ * @struct SignalChain
+ * @brief Waveform, voices and effect chain published to the audio thread as one unit
+ *
+ * A chain is built completely on a control thread, handed to the audio thread
+ * with a single atomic pointer exchange and never modified afterwards (only the
+ * internal state of its effects and voices changes while rendering). When a
+ * newer chain replaces it, the audio thread retires it to a garbage queue and
+ * a control thread deletes it, so no memory is ever freed on the audio thread.
+ *
+ * Chains built from one another may share the voice pool, the master bus or
+ * individual effects; the shared_ptr reference counts are only touched on control threads.
+ *
+ * The chain itself is the main part. In a multi-timbral setup the channels
+ * with their own instrument play one of @c parts instead: sub-chains that use
+ * the waveform, voice, effect and latency fields but never the master bus,
+ * workers or parts, which belong to the top-level chain. Part slot 0 is the
+ * main part and slot k is parts[k - 1].
+ */
+struct SignalChain
+{
+    unsigned int generation;                         ///< Increases with every published chain
+    std::shared_ptr<IWave> waveform;                 ///< Waveform generator shared by all voices
+    std::shared_ptr<VoicePool> voicePool;            ///< Voices, shared with the previous chain when the voice settings are unchanged
+    std::shared_ptr<VoiceWorkerPool> voiceWorkers;   ///< Threads sharing the voice rendering, or null to render on the audio thread only
+    std::shared_ptr<MasterBus> masterBus;            ///< Master dynamics, shared with the previous chain when its settings are unchanged
+    std::vector<std::shared_ptr<IEffect>> effects;   ///< Ordered effect chain (graph effects first, in schedule order)
+    std::vector<std::string> effectNames;            ///< Canonical name of each effect slot (empty if not addressable)
+    std::shared_ptr<EffectGraph> graph;              ///< Routing of the first graphEffects effects, or null for a plain series chain
+    size_t graphEffects;                             ///< Effects run by the graph; the rest follow it in series
+    std::shared_ptr<BlockLfo> lfo;                   ///< LFO shared by the modulated effects, generated once per block (may be null)
+    unsigned int crossfadeFrames;                    ///< Length of the fade from the previous chain, 0 to switch at once
+    unsigned int latencyFrames;                      ///< Latency of the effects and master bus, set when published
+    std::vector<std::shared_ptr<SignalChain>> parts; ///< Parts of the channels with their own instrument, by channel
+    unsigned char channelSlots[16];                  ///< Part slot each MIDI channel plays
+
+    SignalChain() : generation(0), graphEffects(0), crossfadeFrames(0), latencyFrames(0)
+    {
+        std::fill(channelSlots, channelSlots + 16, 0);
+    }
+
+    /// Number of part slots (the main part and the channel parts)
+    unsigned int getSlotCount() const { return static_cast<unsigned int>(parts.size()) + 1; }
+
+    /// Part in @p slot (0 is this chain)
+    SignalChain& getSlot(unsigned int slot) { return slot == 0 ? *this : *parts[slot - 1]; }
+    const SignalChain& getSlot(unsigned int slot) const { return slot == 0 ? *this : *parts[slot - 1]; }
+
+    /// Part that plays MIDI channel @p channel
+    SignalChain& getChannelPart(unsigned char channel) { return getSlot(channelSlots[channel & 0x0F]); }
+};
@@ -0,0 +1,167 @@
+#include "VoicePool.h"
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+// VoicePool implementation
+// -----------------------------------------------------------------------------
+
+VoicePool::VoicePool()
+    : m_policy(VoiceStealPolicy::Oldest), m_nextAge(0), m_activeCount(0)
+{
+}
+
+void VoicePool::configure(unsigned int maxVoices, VoiceStealPolicy policy, const ADSREnvelope& envelopeTemplate)
+{
+    m_voices.assign(std::max(1u, maxVoices), Voice(envelopeTemplate));
+    m_policy = policy;
+    m_nextAge = 0;
+    m_activeCount = 0;
+}
+
+Voice* VoicePool::noteOn(unsigned char note, unsigned char channel, float frequency, float velocity)
+{
+    Voice* voice = nullptr;
+
+    // Same-note policy retriggers the voice already playing this note
+    if (m_policy == VoiceStealPolicy::SameNote) {
+        voice = findVoice(note, channel);
+    }
+
+    if (voice == nullptr) {
+        voice = findFreeVoice();
+    }
+
+    if (voice == nullptr) {
+        voice = selectVictim(note, channel);
+        if (voice == nullptr) {
+            return nullptr;
+        }
+    }
+
+    if (!voice->active) {
+        ++m_activeCount;
+        voice->phase = 0.0f;
+        voice->envelope.reset();
+    }
+    // A stolen or retriggered voice keeps its phase and level, so the
+    // waveform stays continuous and the attack rises from where it was
+
+    voice->note = note;
+    voice->channel = channel;
+    voice->frequency = frequency;
+    voice->velocity = std::min(std::max(velocity, 0.0f), 1.0f);
+    voice->age = m_nextAge++;
+    voice->active = true;
+    voice->held = true;
+    voice->fresh = true;
+    voice->envelope.trigger();
+
+    return voice;
+}
+
+void VoicePool::noteOff(unsigned char note, unsigned char channel)
+{
+    for (auto& voice : m_voices) {
+        if (voice.active && voice.held && voice.note == note && voice.channel == channel) {
+            voice.held = false;
+        }
+    }
+}
+
+void VoicePool::allNotesOff()
+{
+    for (auto& voice : m_voices) {
+        voice.held = false;
+    }
+}
+
+void VoicePool::channelNotesOff(unsigned char channel)
+{
+    for (auto& voice : m_voices) {
+        if (voice.channel == channel) {
+            voice.held = false;
+        }
+    }
+}
+
+void VoicePool::reset()
+{
+    for (auto& voice : m_voices) {
+        voice.active = false;
+        voice.held = false;
+        voice.fresh = false;
+        voice.envelope.reset();
+    }
+    m_activeCount = 0;
+}
+
+void VoicePool::freeVoice(Voice& voice)
+{
+    if (voice.active) {
+        voice.active = false;
+        voice.held = false;
+        voice.fresh = false;
+        --m_activeCount;
+    }
+}
+
+Voice* VoicePool::findVoice(unsigned char note, unsigned char channel)
+{
+    for (auto& voice : m_voices) {
+        if (voice.active && voice.note == note && voice.channel == channel) {
+            return &voice;
+        }
+    }
+    return nullptr;
+}
+
+Voice* VoicePool::findFreeVoice()
+{
+    if (m_activeCount >= m_voices.size()) {
+        return nullptr;
+    }
+
+    for (auto& voice : m_voices) {
+        if (!voice.active) {
+            return &voice;
+        }
+    }
+    return nullptr;
+}
+
+Voice* VoicePool::selectVictim(unsigned char note, unsigned char channel)
+{
+    if (m_voices.empty()) {
+        return nullptr;
+    }
+
+    if (m_policy == VoiceStealPolicy::Quietest) {
+        Voice* quietest = &m_voices.front();
+        float quietestLevel = quietest->envelope.getLevel() * quietest->velocity;
+        for (auto& voice : m_voices) {
+            float level = voice.envelope.getLevel() * voice.velocity;
+            if (level < quietestLevel) {
+                quietest = &voice;
+                quietestLevel = level;
+            }
+        }
+        return quietest;
+    }
+
+    if (m_policy == VoiceStealPolicy::SameNote) {
+        if (Voice* sameNote = findVoice(note, channel)) {
+            return sameNote;
+        }
+    }
+
+    // Oldest: prefer voices that are already releasing over held ones
+    Voice* oldest = nullptr;
+    for (auto& voice : m_voices) {
+        if (oldest == nullptr ||
+            (oldest->held && !voice.held) ||
+            (oldest->held == voice.held && voice.age < oldest->age)) {
+            oldest = &voice;
+        }
+    }
+    return oldest;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+#include "Envelope/ADSREnvelope.h"
+
+/**
+ * @file VoicePool.h
+ * @brief Fixed-capacity pool of synthesizer voices with voice stealing
+ */
+
+/**
+ * @enum VoiceStealPolicy
+ * @brief Decides which voice is reused when a note arrives and the pool is full
+ */
+enum class VoiceStealPolicy {
+    Oldest,     ///< Steal the voice that was started first
+    Quietest,   ///< Steal the voice with the lowest current amplitude
+    SameNote    ///< Retrigger a voice already playing the same note, else steal the oldest
+};
+
+/**
+ * @struct Voice
+ * @brief State of a single sounding note
+ *
+ * Each voice carries its own oscillator phase and amplitude envelope, while
+ * the waveform generator itself is shared by all voices.
+ */
+struct Voice {
+    unsigned char note;         ///< MIDI note number (0-127)
+    unsigned char channel;      ///< MIDI channel (0-15)
+    float frequency;            ///< Oscillator frequency in Hz
+    float velocity;             ///< Note velocity scaled to [0.0-1.0]
+    float phase;                ///< Oscillator phase [0.0-1.0)
+    unsigned long long age;     ///< Start order, lower values started earlier
+    bool active;                ///< Voice is producing sound (held or releasing)
+    bool held;                  ///< Key is still down (false once released)
+    bool fresh;                 ///< Started since the last rendered block, which is rendered as held
+    ADSREnvelope envelope;      ///< Per-voice amplitude envelope
+
+    explicit Voice(const ADSREnvelope& envelopeTemplate)
+        : note(0), channel(0), frequency(0.0f), velocity(0.0f), phase(0.0f),
+          age(0), active(false), held(false), fresh(false), envelope(envelopeTemplate) {}
+};
+
+/**
+ * @class VoicePool
+ * @brief Preallocated set of voices tracked by note number and channel
+ *
+ * The pool is sized once by configure(), which is the only method that
+ * allocates. noteOn(), noteOff() and the rendering loop only touch the
+ * preallocated voices, so they are safe to use from the audio thread.
+ */
+class VoicePool {
+public:
+    /**
+     * @brief Constructs an empty pool; call configure() before use
+     */
+    VoicePool();
+
+    /**
+     * @brief Allocate the voices and select the stealing policy
+     *
+     * Any sounding voices are discarded. Must not be called from the audio thread.
+     *
+     * @param maxVoices Number of voices to preallocate (at least one)
+     * @param policy Policy used when a note arrives and no voice is free
+     * @param envelopeTemplate Envelope settings copied into every voice
+     */
+    void configure(unsigned int maxVoices, VoiceStealPolicy policy, const ADSREnvelope& envelopeTemplate);
+
+    /**
+     * @brief Start a note, reusing or stealing a voice as needed
+     * @param note MIDI note number
+     * @param channel MIDI channel
+     * @param frequency Oscillator frequency in Hz
+     * @param velocity Note velocity [0.0-1.0]
+     * @return The voice that now plays the note, or nullptr if the pool is empty
+     */
+    Voice* noteOn(unsigned char note, unsigned char channel, float frequency, float velocity);
+
+    /**
+     * @brief Release every held voice playing the given note on the given channel
+     */
+    void noteOff(unsigned char note, unsigned char channel);
+
+    /**
+     * @brief Release all held voices (they finish their envelope release)
+     */
+    void allNotesOff();
+
+    /**
+     * @brief Release all held voices of one MIDI channel
+     */
+    void channelNotesOff(unsigned char channel);
+
+    /**
+     * @brief Silence all voices immediately
+     */
+    void reset();
+
+    /**
+     * @brief Mark a voice as finished so it can be reused
+     */
+    void freeVoice(Voice& voice);
+
+    /**
+     * @brief Number of voices currently producing sound
+     */
+    unsigned int getActiveCount() const { return m_activeCount; }
+
+    /**
+     * @brief Total number of preallocated voices
+     */
+    unsigned int getCapacity() const { return static_cast<unsigned int>(m_voices.size()); }
+
+    /**
+     * @brief Access the voices for rendering
+     */
+    std::vector<Voice>& getVoices() { return m_voices; }
+
+private:
+    /** Find an active voice for this note and channel, or nullptr */
+    Voice* findVoice(unsigned char note, unsigned char channel);
+
+    /** Find an inactive voice, or nullptr when the pool is full */
+    Voice* findFreeVoice();
+
+    /** Pick a voice to steal according to the current policy */
+    Voice* selectVictim(unsigned char note, unsigned char channel);
+
+    std::vector<Voice> m_voices;      ///< Preallocated voices
+    VoiceStealPolicy m_policy;        ///< Current stealing policy
+    unsigned long long m_nextAge;     ///< Monotonic counter stamped into new voices
+    unsigned int m_activeCount;       ///< Number of active voices
+};
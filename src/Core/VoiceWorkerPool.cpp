@@ -0,0 +1,329 @@
+#include "VoiceWorkerPool.h"
+#include "RealtimeSetup.h"
+#include "RtSafetyCheck.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define VOICE_WORKERS_HAVE_FUTEX 1
+#else
+#define VOICE_WORKERS_HAVE_FUTEX 0
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace {
+    /** Tell the core we are busy-waiting, so a sibling hyperthread gets the pipeline */
+    inline void spinPause() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#endif
+    }
+
+#if VOICE_WORKERS_HAVE_FUTEX
+    long futex(std::atomic<uint32_t>& word, int operation, uint32_t value) {
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), operation, value, nullptr, nullptr, 0);
+    }
+#endif
+}
+
+constexpr unsigned int VoiceWorkerPool::kGroupVoices;
+constexpr unsigned int VoiceWorkerPool::kMinParallelWork;
+constexpr unsigned int VoiceWorkerPool::kMaxSpinMicros;
+
+VoiceWorkerPool::VoiceWorkerPool(unsigned int workerCount, unsigned int maxBlockFrames,
+                                 const std::vector<unsigned int>& reservedCpus)
+    : m_reservedCpus(reservedCpus), m_renderCount(0), m_task(nullptr), m_context(nullptr), m_itemCount(0),
+      m_floatMode(0), m_workerPriority(0), m_epoch(0), m_nextItem(0), m_busy(0), m_stop(false)
+{
+    workerCount = std::max(workerCount, 1u);
+
+    m_participants.resize(workerCount + 1);
+    for (auto& participant : m_participants) {
+        participant.mix.assign(maxBlockFrames, 0.0f);
+        participant.oscillator.assign(maxBlockFrames, 0.0f);
+        participant.envelope.assign(maxBlockFrames, 0.0f);
+        participant.block = 0;
+    }
+
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        m_threads.emplace_back(&VoiceWorkerPool::workerLoop, this, i + 1);
+    }
+    pinWorkers(reservedCpus);
+}
+
+VoiceWorkerPool::~VoiceWorkerPool()
+{
+    m_stop.store(true, std::memory_order_release);
+    m_epoch.fetch_add(2);
+    wakeWorkers();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void VoiceWorkerPool::renderVoice(Voice& voice, IWave& waveform, float sampleRate, float* output,
+                                  float* oscillator, float* envelope, unsigned int numFrames)
+{
+    waveform.generateBlock(voice.frequency, sampleRate, voice.phase, oscillator, numFrames);
+    // A note released before its first block still gets that block of attack,
+    // otherwise a tap shorter than one buffer would make no sound
+    voice.envelope.processBlock(voice.held || voice.fresh, sampleRate, envelope, numFrames);
+    voice.fresh = false;
+
+    const float velocity = voice.velocity;
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        output[i] += oscillator[i] * envelope[i] * velocity;
+    }
+}
+
+void VoiceWorkerPool::render(VoicePool& voicePool, IWave& waveform, float sampleRate, float* output, unsigned int numFrames)
+{
+    std::vector<Voice>& voices = voicePool.getVoices();
+    Participant& self = m_participants[0];
+
+    // Waking the workers costs a few microseconds; small blocks are cheaper inline
+    if (voicePool.getActiveCount() * numFrames < kMinParallelWork)
+    {
+        for (auto& voice : voices)
+        {
+            if (!voice.active) {
+                continue;
+            }
+            renderVoice(voice, waveform, sampleRate, output, self.oscillator.data(), self.envelope.data(), numFrames);
+            if (voice.envelope.isIdle()) {
+                voicePool.freeVoice(voice);
+            }
+        }
+        return;
+    }
+
+    VoiceJob job;
+    job.pool = this;
+    job.voices = voices.data();
+    job.voiceCount = static_cast<unsigned int>(voices.size());
+    job.waveform = &waveform;
+    job.sampleRate = sampleRate;
+    job.frames = numFrames;
+    job.block = ++m_renderCount;
+    if (job.block == 0) {
+        job.block = ++m_renderCount;    // 0 marks an unused buffer
+    }
+
+    run(&VoiceWorkerPool::renderGroup, &job, (job.voiceCount + kGroupVoices - 1) / kGroupVoices);
+
+    for (const auto& participant : m_participants) {
+        if (participant.block != job.block) {
+            continue;
+        }
+        const float* mix = participant.mix.data();
+        for (unsigned int i = 0; i < numFrames; ++i) {
+            output[i] += mix[i];
+        }
+    }
+
+    // Return the voices whose release has finished to the pool
+    for (auto& voice : voices) {
+        if (voice.active && voice.envelope.isIdle()) {
+            voicePool.freeVoice(voice);
+        }
+    }
+}
+
+void VoiceWorkerPool::run(Task task, void* context, unsigned int itemCount)
+{
+    // An odd epoch turns workers away while the job is rewritten; the ones
+    // already past the check only find the previous job's items all taken.
+    // It is still odd if the last call had to fall back.
+    uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+    if ((epoch & 1u) == 0) {
+        m_epoch.store(++epoch);
+    }
+    if (!spinUntilIdle()) {
+        // A worker was preempted in the claim loop and still reads the old
+        // job, so leave it alone and do all of this one here
+        for (unsigned int item = 0; item < itemCount; ++item) {
+            task(context, item, 0);
+        }
+        return;
+    }
+
+    m_task = task;
+    m_context = context;
+    m_itemCount = itemCount;
+    m_floatMode = RealtimeSetup::getFloatMode();
+    const int priority = RealtimeSetup::getThreadPriority();
+    m_workerPriority = priority > 1 ? priority - 1 : priority;
+    m_nextItem.store(0, std::memory_order_relaxed);
+    m_epoch.store(epoch + 1);
+    wakeWorkers();
+
+    runItems(0);
+
+    // Barrier: every item is claimed, so only items a worker is still
+    // rendering are waited for. Those cannot be taken over, so this wait is
+    // deliberately unbounded; it lasts at most one item's render, since the
+    // workers run just below this thread's priority on CPUs it does not use
+    // and neither this thread nor ordinary threads can preempt them. It
+    // spins rather than sleeps to avoid a syscall and timer slack here.
+    while (m_busy.load() != 0) {
+        spinPause();
+    }
+}
+
+bool VoiceWorkerPool::spinUntilIdle() const
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(kMaxSpinMicros);
+    while (m_busy.load() != 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        spinPause();
+    }
+    return true;
+}
+
+void VoiceWorkerPool::runItems(unsigned int participant)
+{
+    while (true)
+    {
+        const unsigned int item = m_nextItem.fetch_add(1, std::memory_order_relaxed);
+        if (item >= m_itemCount) {
+            return;
+        }
+        m_task(m_context, item, participant);
+    }
+}
+
+void VoiceWorkerPool::renderGroup(void* context, unsigned int group, unsigned int participantIndex)
+{
+    const VoiceJob& job = *static_cast<const VoiceJob*>(context);
+    Participant& participant = job.pool->m_participants[participantIndex];
+
+    // The first group of a block starts the participant's mix afresh
+    float* mix = participant.mix.data();
+    if (participant.block != job.block) {
+        std::fill(mix, mix + job.frames, 0.0f);
+        participant.block = job.block;
+    }
+
+    const unsigned int first = group * kGroupVoices;
+    const unsigned int last = std::min(first + kGroupVoices, job.voiceCount);
+    for (unsigned int v = first; v < last; ++v) {
+        Voice& voice = job.voices[v];
+        if (voice.active) {
+            renderVoice(voice, *job.waveform, job.sampleRate, mix,
+                        participant.oscillator.data(), participant.envelope.data(), job.frames);
+        }
+    }
+}
+
+void VoiceWorkerPool::workerLoop(unsigned int index)
+{
+    uint32_t seen = 0;
+    unsigned int floatMode = RealtimeSetup::getFloatMode();
+    int priority = 0;
+
+    while (true)
+    {
+        waitForEpoch(seen);
+        if (m_stop.load(std::memory_order_acquire)) {
+            return;
+        }
+        seen = m_epoch.load();
+        if (seen & 1u) {
+            continue; // Job being replaced, wait for the next one
+        }
+
+        // Announce the claim before checking the job is still current, so the
+        // audio thread either waits for us or we see it moved on
+        m_busy.fetch_add(1);
+        if (m_epoch.load() == seen) {
+            // Scheduling follows the audio thread, one level below it; a
+            // system call, but only when that priority changes
+            if (m_workerPriority != priority) {
+                priority = m_workerPriority;
+                RealtimeSetup::setThreadPriority(priority);
+            }
+
+            RtSafetyCheck::Scope realtime;
+
+            // Denormal handling follows the audio thread
+            if (m_floatMode != floatMode) {
+                floatMode = m_floatMode;
+                RealtimeSetup::setFloatMode(floatMode);
+            }
+            runItems(index);
+        }
+        m_busy.fetch_sub(1);
+    }
+}
+
+void VoiceWorkerPool::pinWorkers(const std::vector<unsigned int>& reservedCpus)
+{
+#if defined(__linux__)
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+
+    // CPUs the process may use, minus the audio thread's (or CPU 0, left to
+    // the system and the audio thread when it is not pinned)
+    std::vector<unsigned int> spare;
+    for (unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        const bool reserved = reservedCpus.empty()
+            ? cpu == 0
+            : std::find(reservedCpus.begin(), reservedCpus.end(), cpu) != reservedCpus.end();
+        if (CPU_ISSET(cpu, &allowed) && !reserved) {
+            spare.push_back(cpu);
+        }
+    }
+    if (spare.empty()) {
+        return;     // Nothing left over: let the scheduler place the workers
+    }
+
+    for (size_t i = 0; i < m_threads.size(); ++i) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(spare[i % spare.size()], &cpus);
+        pthread_setaffinity_np(m_threads[i].native_handle(), sizeof(cpus), &cpus);
+    }
+#else
+    (void)reservedCpus;
+#endif
+}
+
+void VoiceWorkerPool::waitForEpoch(uint32_t seen)
+{
+#if VOICE_WORKERS_HAVE_FUTEX
+    while (m_epoch.load(std::memory_order_acquire) == seen) {
+        futex(m_epoch, FUTEX_WAIT_PRIVATE, seen);
+    }
+#else
+    // The audio thread notifies without the lock, so a wake-up can be missed;
+    // the timeout bounds that to one block the other participants cover
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (m_epoch.load(std::memory_order_acquire) == seen) {
+        m_wake.wait_for(lock, std::chrono::milliseconds(1));
+    }
+#endif
+}
+
+void VoiceWorkerPool::wakeWorkers()
+{
+#if VOICE_WORKERS_HAVE_FUTEX
+    futex(m_epoch, FUTEX_WAKE_PRIVATE, INT_MAX);
+#else
+    m_wake.notify_all();
+#endif
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VoicePool.h"
+#include "Waves/IWave.h"
+
+/**
+ * @file VoiceWorkerPool.h
+ * @brief Worker threads that share the voice rendering of a block
+ */
+
+/**
+ * @class VoiceWorkerPool
+ * @brief Renders the active voices of a block on several cores
+ *
+ * The voices are split into groups of kGroupVoices. For each block the
+ * audio thread publishes the job, wakes the workers (a futex on Linux, a
+ * condition variable elsewhere) and then renders groups itself. Every
+ * participant claims the next unrendered group from a shared atomic
+ * counter, so whoever is free takes over the remaining work and a worker
+ * that wakes late simply finds nothing left. Each participant sums into its
+ * own preallocated buffer; after a spin barrier that only waits for workers
+ * inside the claim loop, the audio thread adds the buffers together. The
+ * epoch is odd while the audio thread rewrites the job, which keeps workers
+ * from reading a half-written one.
+ *
+ * The same machinery runs other per-block work through run(), e.g. the
+ * parts of a multi-timbral setup, one item per part.
+ *
+ * The audio thread never takes a lock, never allocates and never waits for
+ * a worker that is still asleep. Blocks with little work (few voices
+ * or few frames) are rendered inline, where waking the workers would cost
+ * more than it saves. Finished voices are returned to the pool by the audio
+ * thread after the barrier.
+ *
+ * The wait before a job is bounded: if a worker from the previous job has
+ * not left the claim loop within kMaxSpinMicros, it was preempted there;
+ * the audio thread then leaves the job untouched and renders every item of
+ * the new one itself. The wait after its own items is not bounded on
+ * purpose: it only covers items a worker has already started, which the
+ * audio thread cannot take over, so it spins until they are done. With the
+ * workers at the priority below and off the audio CPUs (see below), that
+ * is at most one item's render.
+ *
+ * Each job carries the audio thread's floating-point mode and SCHED_FIFO
+ * priority, which a worker adopts before running items: flush-to-zero set
+ * on the audio thread (see RealtimeSetup) holds for the voices rendered on
+ * the workers too, and the workers run one priority level below the audio
+ * thread, so ordinary threads cannot preempt them while it waits.
+ *
+ * Workers are pinned to one CPU each (Linux), chosen among the CPUs the
+ * process may use minus the ones reserved for the audio thread (CPU 0 when
+ * none are reserved). The threads are started by the constructor and joined
+ * by the destructor, both on a control thread.
+ */
+class VoiceWorkerPool
+{
+public:
+    static constexpr unsigned int kGroupVoices = 2;         ///< Voice slots per claimed group
+    static constexpr unsigned int kMinParallelWork = 4096;  ///< Voice frames below which a block is rendered inline
+    static constexpr unsigned int kMaxSpinMicros = 50;      ///< Longest busy-wait for the workers before falling back
+
+    /// Work item of run(); @p participant is 0 on the audio thread and 1..getWorkerCount() on the workers
+    typedef void (*Task)(void* context, unsigned int item, unsigned int participant);
+
+    /**
+     * @brief Start the workers (allocates, control thread only)
+     * @param workerCount    Threads in addition to the audio thread (at least 1)
+     * @param maxBlockFrames Largest block passed to render()
+     * @param reservedCpus   CPUs the audio thread is pinned to, kept free of workers
+     */
+    VoiceWorkerPool(unsigned int workerCount, unsigned int maxBlockFrames, const std::vector<unsigned int>& reservedCpus);
+    /** Stop and join the workers; the audio thread must no longer use the pool */
+    ~VoiceWorkerPool();
+
+    VoiceWorkerPool(const VoiceWorkerPool&) = delete;
+    VoiceWorkerPool& operator=(const VoiceWorkerPool&) = delete;
+
+    /**
+     * @brief Sum every active voice into a buffer (audio thread)
+     * @param voicePool  Voices to render; finished voices are freed
+     * @param waveform   Oscillator shared by the voices (called concurrently)
+     * @param sampleRate Sample rate in Hz
+     * @param output     Destination, accumulated into (cleared by the caller)
+     * @param numFrames  Number of frames, at most the prepared maximum
+     */
+    void render(VoicePool& voicePool, IWave& waveform, float sampleRate, float* output, unsigned int numFrames);
+
+    /**
+     * @brief Run a task once for every item, spread over the workers and the audio thread
+     *
+     * Audio thread only; returns when every item has finished. The task must
+     * be real-time safe and items must not depend on each other.
+     *
+     * @param task      Function called for each item
+     * @param context   Passed to every call of @p task
+     * @param itemCount Number of items
+     */
+    void run(Task task, void* context, unsigned int itemCount);
+
+    /**
+     * @brief Add one voice's block to a buffer
+     * @param oscillator Scratch buffer of numFrames samples
+     * @param envelope   Scratch buffer of numFrames samples
+     */
+    static void renderVoice(Voice& voice, IWave& waveform, float sampleRate, float* output,
+                            float* oscillator, float* envelope, unsigned int numFrames);
+
+    /// Worker threads (not counting the audio thread)
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+    /// CPUs the workers were kept off
+    const std::vector<unsigned int>& getReservedCpus() const { return m_reservedCpus; }
+
+private:
+    /// Buffers of one participant (index 0 is the audio thread)
+    struct Participant {
+        std::vector<float> mix;         ///< Sum of the groups this participant rendered
+        std::vector<float> oscillator;  ///< Scratch for one voice's oscillator block
+        std::vector<float> envelope;    ///< Scratch for one voice's envelope block
+        uint32_t block;                 ///< render() call the mix buffer holds, 0 if none
+    };
+
+    /// Voice rendering job of one render() call, the context of renderGroup()
+    struct VoiceJob {
+        VoiceWorkerPool* pool;          ///< Owner of the participant buffers
+        Voice* voices;                  ///< First voice of the pool
+        unsigned int voiceCount;        ///< Voices in the pool
+        IWave* waveform;                ///< Shared oscillator
+        float sampleRate;               ///< Sample rate in Hz
+        unsigned int frames;            ///< Frames in this block
+        uint32_t block;                 ///< Number of this render() call
+    };
+
+    /** Task that renders one group of voices into the participant's mix */
+    static void renderGroup(void* context, unsigned int group, unsigned int participant);
+    /** Thread body of worker @p index */
+    void workerLoop(unsigned int index);
+    /** Claim and run items until none are left */
+    void runItems(unsigned int participant);
+    /** Spin until no worker is claiming items; false if that took longer than kMaxSpinMicros */
+    bool spinUntilIdle() const;
+    /** Pin worker threads to the CPUs left over by @p reservedCpus */
+    void pinWorkers(const std::vector<unsigned int>& reservedCpus);
+    /** Block until the epoch differs from @p seen or the pool stops */
+    void waitForEpoch(uint32_t seen);
+    /** Wake every worker waiting in waitForEpoch() */
+    void wakeWorkers();
+
+    std::vector<Participant> m_participants;    ///< Audio thread first, then one per worker
+    std::vector<std::thread> m_threads;         ///< Worker threads
+    std::vector<unsigned int> m_reservedCpus;   ///< CPUs kept free of workers
+    uint32_t m_renderCount;                     ///< render() calls that used the workers (audio thread)
+
+    // Current job, only written by the audio thread while m_epoch is odd
+    Task m_task;                                ///< Function run for each item
+    void* m_context;                            ///< Argument of m_task
+    unsigned int m_itemCount;                   ///< Items in this job
+    unsigned int m_floatMode;                   ///< Floating-point mode of the audio thread
+    int m_workerPriority;                       ///< SCHED_FIFO priority for the workers, 0 for normal scheduling
+
+    std::atomic<uint32_t> m_epoch;              ///< Even: the job is current, odd: job being rewritten; the futex word
+    std::atomic<unsigned int> m_nextItem;       ///< Next item to claim
+    std::atomic<unsigned int> m_busy;           ///< Workers currently claiming or running items
+    std::atomic<bool> m_stop;                   ///< Tells the workers to exit
+
+    std::mutex m_wakeMutex;                     ///< Fallback wake-up where there is no futex
+    std::condition_variable m_wake;
+};
@@ -1,11 +1,24 @@
 #include "audioDevice.h"
+#include "RtSafetyCheck.h"
 #include "RtAudio.h"
+#include <algorithm>
+#include <chrono>
 
-AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames) :
+namespace {
+    constexpr int kRenderThreadPriority = 70;   ///< SCHED_FIFO priority of the render-ahead thread unless configured
+}
+
+AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames,
+                         unsigned int renderAhead) :
                                                                     itsAudioSystem  (audioSystem),
                                                                     m_dac          (std::make_unique<RtAudio>()),
                                                                     m_sampleRate    (sampleRate),
-                                                                    m_bufferFrames  (bufferFrames) 
+                                                                    m_bufferFrames  (bufferFrames),
+                                                                    m_renderAheadSamples(0),
+                                                                    m_renderRunning (false),
+                                                                    m_pendingStatus (0),
+                                                                    m_ringUnderruns (0),
+                                                                    m_threadSetupPending(false)
 {
     if (m_dac->getDeviceCount() < 1) 
     {
@@ -26,10 +39,39 @@ AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned in
         std::cerr << "Failed to open audio stream: " << error.getMessage() << std::endl;
         exit(EXIT_FAILURE);
     }
+
+    // RtAudio may adjust the buffer size; size the render buffers to match
+    m_bufferFrames = std::max(1u, bufferFrames);
+    m_leftBuffer.assign(m_bufferFrames, 0.0f);
+    m_rightBuffer.assign(m_bufferFrames, 0.0f);
+
+    if (renderAhead > 0) {
+        m_renderAheadSamples = static_cast<size_t>(renderAhead) * m_bufferFrames * 2;
+        m_ring = std::make_unique<SpscRing<float>>(m_renderAheadSamples);
+        m_interleaved.assign(m_bufferFrames * 2, 0.0f);
+    }
+}
+
+void AudioDevice::setRealtime(const AudioConfig& config)
+{
+    m_realtime.configure(config);
 }
 
 void AudioDevice::start() 
 {
+    m_realtime.lockMemory();
+
+    if (m_ring && !m_renderThread.joinable()) {
+        // Start playback with the full reserve; nothing else renders yet
+        while (renderAheadBuffer()) {
+        }
+        m_renderRunning.store(true, std::memory_order_relaxed);
+        m_renderThread = std::thread(&AudioDevice::renderLoop, this);
+    } else if (!m_ring) {
+        // The callback thread is set up from inside its first callback
+        m_threadSetupPending.store(true, std::memory_order_release);
+    }
+
     try {
         m_dac->startStream();
     } catch (RtAudioError& error) {
@@ -41,28 +83,126 @@ void AudioDevice::start()
 void AudioDevice::stop() 
 {
     if (m_dac->isStreamRunning()) m_dac->stopStream();
+    stopRenderThread();
 }
 
 AudioDevice::~AudioDevice() 
 {
+    stop();
     if (m_dac->isStreamOpen()) m_dac->closeStream();
 }
 
+void AudioDevice::stopRenderThread()
+{
+    if (m_renderThread.joinable()) {
+        m_renderRunning.store(false, std::memory_order_relaxed);
+        m_renderThread.join();
+    }
+}
+
+void AudioDevice::renderLoop()
+{
+    m_realtime.applyToCurrentThread(kRenderThreadPriority);
+
+    // Polling at a quarter of the buffer period keeps the callback free of
+    // wake-up calls while the reserve never drops by more than one buffer
+    const auto pause = std::chrono::duration<double>(0.25 * m_bufferFrames / m_sampleRate);
+    while (m_renderRunning.load(std::memory_order_relaxed)) {
+        if (!renderAheadBuffer()) {
+            std::this_thread::sleep_for(pause);
+        }
+    }
+}
+
+bool AudioDevice::renderAheadBuffer()
+{
+    const size_t samples = m_interleaved.size();
+    if (m_ring->readAvailable() + samples > m_renderAheadSamples) {
+        return false;
+    }
+
+    const auto renderStart = std::chrono::steady_clock::now();
+
+    float* left = m_leftBuffer.data();
+    float* right = m_rightBuffer.data();
+    itsAudioSystem->renderBlock(left, right, m_bufferFrames);
+
+    float* out = m_interleaved.data();
+    for (unsigned int i = 0; i < m_bufferFrames; i++) 
+    {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+    m_ring->write(out, samples);
+
+    // Same measure as in the callback: render time against the buffer period
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+    const double period = static_cast<double>(m_bufferFrames) / m_sampleRate;
+    const unsigned int status = m_pendingStatus.exchange(0, std::memory_order_relaxed);
+    m_loadMonitor.record(period > 0.0 ? static_cast<float>(elapsed / period) : 0.0f,
+                         (status & RTAUDIO_INPUT_OVERFLOW) != 0,
+                         (status & RTAUDIO_OUTPUT_UNDERFLOW) != 0);
+    return true;
+}
+
 int AudioDevice::audioCallback(void* outputBuffer, void* /*inputBuffer*/, unsigned int nBufferFrames,
-                                double /*streamTime*/, RtAudioStreamStatus /*status*/, void* userData) 
+                                double /*streamTime*/, RtAudioStreamStatus status, void* userData) 
 {
+    const auto callbackStart = std::chrono::steady_clock::now();
+    RtSafetyCheck::Scope realtime;
+
     auto* device = static_cast<AudioDevice*>(userData);
     float* buffer = static_cast<float*>(outputBuffer);
 
-    for (unsigned int i = 0; i < nBufferFrames; i++) 
+    // Render-ahead: only copy out what the render thread prepared
+    if (device->m_ring) 
     {
-        // Get the next stereo sample from the AudioSystem
-        std::pair<float, float> stereoSample = device->itsAudioSystem->getNextSample();
-    
-        // Write the processed stereo sample to the buffer
-        buffer[2 * i] = stereoSample.first;  // Left channel
-        buffer[2 * i + 1] = stereoSample.second;  // Right channel
+        const size_t wanted = static_cast<size_t>(nBufferFrames) * 2;
+        const size_t copied = device->m_ring->read(buffer, wanted);
+        if (copied < wanted) {
+            std::fill(buffer + copied, buffer + wanted, 0.0f);
+            device->m_ringUnderruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        device->m_pendingStatus.fetch_or(status, std::memory_order_relaxed);
+        return 0;
     }
 
+    // Once per start: priority, pinning and denormal mode of this thread
+    if (device->m_threadSetupPending.load(std::memory_order_acquire)) 
+    {
+        device->m_realtime.applyToCurrentThread();
+        device->m_threadSetupPending.store(false, std::memory_order_relaxed);
+    }
+
+    float* left = device->m_leftBuffer.data();
+    float* right = device->m_rightBuffer.data();
+    const unsigned int maxBlock = static_cast<unsigned int>(device->m_leftBuffer.size());
+
+    // Render in whole blocks; chunk in case the driver hands us more frames
+    // than were negotiated when the stream was opened
+    unsigned int offset = 0;
+    while (offset < nBufferFrames) 
+    {
+        unsigned int frames = std::min(nBufferFrames - offset, maxBlock);
+        device->itsAudioSystem->renderBlock(left, right, frames);
+
+        // Interleave the planar block into the RtAudio buffer
+        float* out = buffer + 2 * offset;
+        for (unsigned int i = 0; i < frames; i++) 
+        {
+            out[2 * i] = left[i];       // Left channel
+            out[2 * i + 1] = right[i];  // Right channel
+        }
+
+        offset += frames;
+    }
+
+    // Time spent relative to the deadline for this buffer
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - callbackStart).count();
+    const double period = static_cast<double>(nBufferFrames) / device->m_sampleRate;
+    device->m_loadMonitor.record(period > 0.0 ? static_cast<float>(elapsed / period) : 0.0f,
+                                 (status & RTAUDIO_INPUT_OVERFLOW) != 0,
+                                 (status & RTAUDIO_OUTPUT_UNDERFLOW) != 0);
+
     return 0;
 }
@@ -3,8 +3,13 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <thread>
 #include "audioSystem.h"
 #include "Effects/IEffect.h"
+#include "DspLoadMonitor.h"
+#include "SpscRing.h"
+#include "RealtimeSetup.h"
 #include "RtAudio.h"
 
 /**
@@ -14,6 +19,13 @@
  * This class provides an interface to the physical audio hardware through RtAudio.
  * It handles setting up audio streams, managing buffer sizes, and coordinating
  * real-time audio processing through the AudioSystem.
+ *
+ * By default the AudioSystem renders inside the RtAudio callback. With
+ * render-ahead enabled, a dedicated high-priority thread renders buffers
+ * into a lock-free ring up to the configured depth, and the callback only
+ * copies the oldest one out. A render spike then only eats into the reserve
+ * instead of causing an xrun, at the cost of that much extra latency, which
+ * suits playback-only use such as the sequencer but not live playing.
  */
 class AudioDevice 
 {
@@ -25,31 +37,88 @@ public:
      * @param audioSystem Pointer to the AudioSystem that will process audio data
      * @param sampleRate The sample rate to use for audio processing (e.g., 44100, 48000)
      * @param bufferFrames The number of frames per audio buffer
+     * @param renderAhead Buffers to keep rendered ahead on a separate thread (0 renders in the callback)
      */
-    AudioDevice                 (AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames);
+    AudioDevice                 (AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames,
+                                 unsigned int renderAhead = 0);
 
     /**
      * @brief Destructor - ensures proper cleanup of audio resources
      */
     ~AudioDevice                ();
 
+    /**
+     * @brief Takes the <realtime> settings applied by start()
+     * 
+     * Call before start(). The thread settings go to the thread that renders:
+     * the callback thread, or the render-ahead thread when there is one.
+     * 
+     * @param config Configuration holding the realtime* fields
+     */
+    void setRealtime            (const AudioConfig& config);
+
     /**
      * @brief Starts the audio processing stream
      * 
      * Opens the audio stream and begins real-time audio processing using the
-     * configured parameters and callback function.
+     * configured parameters and callback function. With render-ahead, the
+     * ring is filled first and the render thread started.
      */
     void start                  ();
 
     /**
      * @brief Stops the audio processing stream
      * 
-     * Safely closes the audio stream and stops all processing.
+     * Safely closes the audio stream and stops all processing, including
+     * the render-ahead thread.
      */
     void stop                   ();
 
+    /**
+     * @brief Callback load percentiles and xrun counts since the last reset
+     * 
+     * Safe to poll from any thread while the stream is running.
+     */
+    DspLoadStats getLoadStats   () const { return m_loadMonitor.getStats(); }
+
+    /**
+     * @brief Clears the load statistics (takes effect on the next callback)
+     */
+    void resetLoadStats         () { m_loadMonitor.reset(); }
+
+    /**
+     * @brief Callbacks that found the render-ahead ring short and played silence
+     * 
+     * Always 0 when rendering in the callback. Safe to poll from any thread.
+     */
+    unsigned long long getRingUnderruns() const { return m_ringUnderruns.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Real-time settings requested and obtained by the rendering thread
+     * 
+     * The thread settings are applied on the first callback after start(),
+     * so they read as pending until then. Safe to poll from any thread.
+     */
+    RealtimeStatus getRealtimeStatus() const { return m_realtime.getStatus(); }
+
 private:
 
+    /**
+     * @brief Renders one buffer into the ring if it is below the render-ahead depth
+     * @return false if the ring was already full
+     */
+    bool renderAheadBuffer      ();
+
+    /**
+     * @brief Body of the render-ahead thread: keeps the ring topped up until stopped
+     */
+    void renderLoop             ();
+
+    /**
+     * @brief Stops and joins the render-ahead thread, if running
+     */
+    void stopRenderThread       ();
+
     /**
      * @brief Static callback function called by RtAudio when audio data is needed
      * @param outputBuffer Pointer to the output (playback) buffer
@@ -95,4 +164,43 @@ private:
      * and risk of audio dropouts.
      */
     unsigned int        m_bufferFrames;
+
+    /**
+     * @brief Planar scratch buffers the AudioSystem renders each block into
+     * 
+     * Sized once to the negotiated buffer length when the stream is opened,
+     * so the callback never allocates. The callback (or, with render-ahead,
+     * the render thread) interleaves them into the output.
+     */
+    std::vector<float>  m_leftBuffer;
+    std::vector<float>  m_rightBuffer;
+
+    /**
+     * @brief Render-ahead state; m_ring is null when rendering in the callback
+     * 
+     * The render thread is the ring's only writer and the callback its only
+     * reader. The callback hands the RtAudio status flags to the render
+     * thread through m_pendingStatus, so the load monitor keeps one writer.
+     */
+    std::unique_ptr<SpscRing<float>> m_ring;            ///< Interleaved stereo buffers rendered ahead
+    std::vector<float>  m_interleaved;                  ///< One interleaved buffer, render thread scratch
+    size_t              m_renderAheadSamples;           ///< Depth the ring is kept filled to, in samples
+    std::thread         m_renderThread;                 ///< Thread running renderLoop()
+    std::atomic<bool>   m_renderRunning;                ///< Cleared to stop the render thread
+    std::atomic<unsigned int> m_pendingStatus;          ///< RtAudio status flags not yet recorded
+    std::atomic<unsigned long long> m_ringUnderruns;    ///< Callbacks that found the ring short
+
+    /**
+     * @brief Scheduling, pinning, denormal mode and memory locking of the audio path
+     */
+    RealtimeSetup       m_realtime;
+    std::atomic<bool>   m_threadSetupPending;           ///< The next callback applies m_realtime to its thread
+
+    /**
+     * @brief Callback timing histogram and xrun counters
+     * 
+     * Written only by the audio callback; each callback's wall time is
+     * recorded relative to its buffer period (nBufferFrames / sampleRate).
+     */
+    DspLoadMonitor      m_loadMonitor;
 };
@@ -1,15 +1,30 @@
 #include <cmath>
 #include <algorithm> // For std::find and std::transform
 #include <cctype>    // For std::tolower
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
 #include "audioSystem.h"
+#include "RtSafetyCheck.h"
 #include "Waves/SquareWave.h" // Include the square wave implementation
 #include "Waves/SineWave.h"
 #include "Waves/SawtoothWave.h"
 #include "Waves/TriangleWave.h"
+#include "Waves/WavetableWave.h"
+#include "Waves/PolyBlepWave.h"
 #include "Effects/OctaveEffect.h"
 #include "Effects/DelayEffect.h"
-#include "Effects/LowPassEffect.h"
+#include "Effects/FilterEffect.h"
+#include "Effects/ConvolutionReverbEffect.h"
+#include "Effects/ReverbEffect.h"
+#include "Effects/WaveshaperEffect.h"
+#include "Effects/OversampledEffect.h"
+#include "Effects/ChorusEffect.h"
+#include "Effects/FlangerEffect.h"
+#include "Effects/PhaserEffect.h"
 #include "Effects/EffectParameters.h"
+#include "IO/WavFile.h"
 
 namespace {
     /**
@@ -21,12 +36,307 @@ namespace {
                       [](unsigned char c) { return std::tolower(c); });
         return result;
     }
+
+    /**
+     * @brief Convert a frequency to the nearest MIDI note number (A4 = 440 Hz = 69)
+     */
+    unsigned char frequencyToMidiNote(float frequency) {
+        float noteNumber = 69.0f + 12.0f * std::log2(frequency / 440.0f);
+        return static_cast<unsigned char>(std::min(std::max(std::round(noteNumber), 0.0f), 127.0f));
+    }
+
+    /**
+     * @brief Convert a MIDI note number to its equal-tempered frequency
+     */
+    float midiNoteToFrequency(unsigned char note) {
+        return 440.0f * std::pow(2.0f, (static_cast<float>(note) - 69.0f) / 12.0f);
+    }
+
+    /**
+     * @brief Map an effect name or alias to its canonical lowercase name
+     */
+    std::string canonicalEffectName(const std::string& name) {
+        std::string effectLower = toLowercase(name);
+        if (effectLower == "echo") {
+            return "delay";
+        }
+        if (effectLower == "lpf" || effectLower == "filter") {
+            return "lowpass";
+        }
+        if (effectLower == "hpf") {
+            return "highpass";
+        }
+        if (effectLower == "bpf") {
+            return "bandpass";
+        }
+        if (effectLower == "fdn") {
+            return "reverb";
+        }
+        if (effectLower == "convreverb" || effectLower == "ir") {
+            return "convolution";
+        }
+        if (effectLower == "distortion" || effectLower == "drive") {
+            return "overdrive";
+        }
+        if (effectLower == "clip") {
+            return "hardclip";
+        }
+        if (effectLower == "fold") {
+            return "foldback";
+        }
+        if (effectLower == "flange") {
+            return "flanger";
+        }
+        if (effectLower == "phase") {
+            return "phaser";
+        }
+        return effectLower;
+    }
+
+    /**
+     * @brief Create the waveform generator for a configured name (case-insensitive)
+     */
+    std::shared_ptr<IWave> createWaveform(const std::string& name) {
+        std::string waveformLower = toLowercase(name);
+
+        if (waveformLower == "sine") {
+            return std::make_shared<SineWave>();
+        } else if (waveformLower == "sawtooth" || waveformLower == "saw") {
+            return std::make_shared<SawtoothWave>();
+        } else if (waveformLower == "triangle" || waveformLower == "tri") {
+            return std::make_shared<TriangleWave>();
+        } else if (waveformLower == "sine_wt") {
+            return std::make_shared<WavetableWave>(WavetableShape::Sine);
+        } else if (waveformLower == "square_wt") {
+            return std::make_shared<WavetableWave>(WavetableShape::Square);
+        } else if (waveformLower == "sawtooth_wt" || waveformLower == "saw_wt") {
+            return std::make_shared<WavetableWave>(WavetableShape::Sawtooth);
+        } else if (waveformLower == "triangle_wt" || waveformLower == "tri_wt") {
+            return std::make_shared<WavetableWave>(WavetableShape::Triangle);
+        } else if (waveformLower == "square_blep") {
+            return std::make_shared<PolyBlepWave>(PolyBlepShape::Square);
+        } else if (waveformLower == "sawtooth_blep" || waveformLower == "saw_blep") {
+            return std::make_shared<PolyBlepWave>(PolyBlepShape::Sawtooth);
+        } else if (waveformLower == "triangle_blep" || waveformLower == "tri_blep") {
+            return std::make_shared<PolyBlepWave>(PolyBlepShape::Triangle);
+        }
+
+        // Default to square wave for empty or unrecognized waveforms
+        return std::make_shared<SquareWave>();
+    }
+
+    /**
+     * @brief Create the convolution reverb from the configured impulse response
+     *
+     * Falls back to a synthetic 2.5 s hall when no file is configured; returns
+     * nullptr (and logs) if the configured file cannot be used.
+     */
+    std::shared_ptr<IEffect> createConvolution(const AudioConfig& config, float sampleRate) {
+        std::vector<float> left;
+        std::vector<float> right;
+        float irSampleRate = sampleRate;
+
+        try {
+            if (config.convolutionImpulse.empty()) {
+                ConvolutionReverbEffect::makeSyntheticImpulse(2.5f, sampleRate, left, right);
+            } else {
+                WavData impulse = readWavFile(config.convolutionImpulse);
+                irSampleRate = static_cast<float>(impulse.sampleRate);
+                left = std::move(impulse.channels[0]);
+                if (impulse.channels.size() > 1) {
+                    right = std::move(impulse.channels[1]);
+                }
+            }
+            return std::make_shared<ConvolutionReverbEffect>(std::move(left), std::move(right), irSampleRate,
+                                                             config.convolutionPartition, config.convolutionMix);
+        } catch (const std::exception& e) {
+            std::cerr << "Convolution reverb disabled: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief True for the FilterEffect modes, which share their parameter ids
+     */
+    bool isFilterEffect(const std::string& effectLower) {
+        return effectLower == "lowpass" || effectLower == "highpass" || effectLower == "bandpass" ||
+               effectLower == "notch" || effectLower == "lowshelf" || effectLower == "highshelf";
+    }
+
+    /**
+     * @brief True for the effects that can follow the chain's shared LFO
+     */
+    bool isModulatedEffect(const std::string& effectLower) {
+        return effectLower == "chorus" || effectLower == "flanger" || effectLower == "phaser";
+    }
+
+    /**
+     * @brief Create an effect from its canonical name, or nullptr if unknown
+     * @param sharedLfo Chain LFO for the modulated effects, or nullptr for their own
+     */
+    std::shared_ptr<IEffect> createEffect(const std::string& effectLower, const AudioConfig& config, float sampleRate,
+                                          const std::shared_ptr<const BlockLfo>& sharedLfo) {
+        if (effectLower == "octave") {
+            return std::make_shared<OctaveEffect>();
+        } else if (effectLower == "delay") {
+            return std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, sampleRate);
+        } else if (effectLower == "lowpass") {
+            return std::make_shared<FilterEffect>(FilterEffect::Mode::LowPass, 1000.0f, 0.7071f, sampleRate);
+        } else if (effectLower == "highpass") {
+            return std::make_shared<FilterEffect>(FilterEffect::Mode::HighPass, 200.0f, 0.7071f, sampleRate);
+        } else if (effectLower == "bandpass") {
+            return std::make_shared<FilterEffect>(FilterEffect::Mode::BandPass, 1000.0f, 0.7071f, sampleRate);
+        } else if (effectLower == "notch") {
+            return std::make_shared<FilterEffect>(FilterEffect::Mode::Notch, 1000.0f, 0.7071f, sampleRate);
+        } else if (effectLower == "lowshelf") {
+            return std::make_shared<FilterEffect>(FilterEffect::Mode::LowShelf, 200.0f, 0.7071f, sampleRate);
+        } else if (effectLower == "highshelf") {
+            return std::make_shared<FilterEffect>(FilterEffect::Mode::HighShelf, 4000.0f, 0.7071f, sampleRate);
+        } else if (effectLower == "reverb") {
+            return std::make_shared<ReverbEffect>(0.5f, 2.0f, 0.5f, 0.25f, sampleRate);
+        } else if (effectLower == "convolution") {
+            return createConvolution(config, sampleRate);
+        } else if (effectLower == "overdrive") {
+            return std::make_shared<OversampledEffect<WaveshaperEffect>>(config.oversampling, WaveshaperEffect::Shape::Tanh);
+        } else if (effectLower == "hardclip") {
+            return std::make_shared<OversampledEffect<WaveshaperEffect>>(config.oversampling, WaveshaperEffect::Shape::HardClip);
+        } else if (effectLower == "foldback") {
+            return std::make_shared<OversampledEffect<WaveshaperEffect>>(config.oversampling, WaveshaperEffect::Shape::Foldback);
+        } else if (effectLower == "chorus") {
+            return std::make_shared<ChorusEffect>(0.8f, 0.5f, 0.5f, sampleRate, sharedLfo);
+        } else if (effectLower == "flanger") {
+            return std::make_shared<FlangerEffect>(0.2f, 0.7f, 0.5f, 0.5f, sampleRate, sharedLfo);
+        } else if (effectLower == "phaser") {
+            return std::make_shared<PhaserEffect>(0.4f, 0.7f, 0.5f, 0.5f, sampleRate, sharedLfo);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief True if the configured chain or graph has a chorus, flanger or phaser
+     */
+    bool usesModulatedEffect(const AudioConfig& config) {
+        if (!config.effectGraph.empty()) {
+            return std::any_of(config.effectGraph.begin(), config.effectGraph.end(),
+                               [](const EffectGraphNode& node) { return isModulatedEffect(canonicalEffectName(node.effect)); });
+        }
+        return std::any_of(config.effects.begin(), config.effects.end(),
+                           [](const std::string& name) { return isModulatedEffect(canonicalEffectName(name)); });
+    }
+
+    /**
+     * @brief Create the effects of the configured graph and compile it into the chain
+     *
+     * Nodes naming an unknown effect act as plain mixers. The chain's effect
+     * slots are filled in schedule order.
+     *
+     * @throws std::invalid_argument if the graph cannot be compiled (the chain is left unchanged)
+     */
+    void buildEffectGraph(const AudioConfig& config, float sampleRate, unsigned int maxBlockFrames, SignalChain& chain) {
+        std::vector<std::shared_ptr<IEffect>> nodeEffects;
+        std::vector<std::string> nodeEffectNames;
+        for (const auto& node : config.effectGraph) {
+            std::string effectLower = canonicalEffectName(node.effect);
+            std::shared_ptr<IEffect> effect;
+            if (!effectLower.empty()) {
+                effect = createEffect(effectLower, config, sampleRate, chain.lfo);
+            }
+            if (effect) {
+                effect->prepare(sampleRate, maxBlockFrames);
+            }
+            nodeEffects.push_back(effect);
+            nodeEffectNames.push_back(effectLower);
+        }
+
+        auto graph = std::make_shared<EffectGraph>(config.effectGraph, nodeEffects, maxBlockFrames);
+        for (unsigned int node : graph->getOrder()) {
+            if (nodeEffects[node]) {
+                chain.effects.push_back(nodeEffects[node]);
+                chain.effectNames.push_back(nodeEffectNames[node]);
+            }
+        }
+        chain.graph = graph;
+        chain.graphEffects = chain.effects.size();
+    }
+
+    /**
+     * @brief True if two configurations produce identical voice pools
+     */
+    bool sameVoiceSettings(const AudioConfig& a, const AudioConfig& b) {
+        return a.maxVoices == b.maxVoices &&
+               toLowercase(a.voiceStealPolicy) == toLowercase(b.voiceStealPolicy) &&
+               a.attackTime == b.attackTime &&
+               a.decayTime == b.decayTime &&
+               a.sustainLevel == b.sustainLevel &&
+               a.releaseTime == b.releaseTime;
+    }
+
+    /**
+     * @brief Voice render workers to run, limited to one per spare core
+     */
+    unsigned int voiceWorkerCount(const AudioConfig& config) {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        if (cores == 0) {
+            return config.voiceWorkers;     // Unknown core count, trust the configuration
+        }
+        return std::min(config.voiceWorkers, cores - 1);
+    }
+
+    /**
+     * @brief True if two configurations produce identical master buses
+     */
+    bool sameMasterSettings(const AudioConfig& a, const AudioConfig& b) {
+        return a.compressorEnabled == b.compressorEnabled &&
+               a.compressorThreshold == b.compressorThreshold &&
+               a.compressorRatio == b.compressorRatio &&
+               a.compressorAttack == b.compressorAttack &&
+               a.compressorRelease == b.compressorRelease &&
+               a.compressorKnee == b.compressorKnee &&
+               a.compressorMakeup == b.compressorMakeup &&
+               a.limiterEnabled == b.limiterEnabled &&
+               a.limiterCeiling == b.limiterCeiling &&
+               a.limiterLookahead == b.limiterLookahead &&
+               a.limiterRelease == b.limiterRelease;
+    }
+
+    /**
+     * @brief Wrap-around safe "generation a was published after b"
+     */
+    bool isNewerGeneration(unsigned int a, unsigned int b) {
+        return static_cast<int>(a - b) > 0;
+    }
+
+    /**
+     * @brief Latency of a part's graph and effects in frames, without the master bus
+     */
+    unsigned int effectLatency(const SignalChain& part) {
+        unsigned int latency = part.graph ? part.graph->getLatency() : 0;
+        for (size_t i = part.graphEffects; i < part.effects.size(); ++i) {
+            latency += part.effects[i]->getLatency();
+        }
+        return latency;
+    }
 }
 
-AudioSystem::AudioSystem(float sampleRate) : m_frequency(0.0f),
-                                             m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f),
-                                             m_phase(0.0f),
-                                             m_noteOn(false) 
+constexpr unsigned int AudioSystem::kMaxBlockFrames;
+constexpr unsigned int AudioSystem::kPartSlots;
+constexpr unsigned int AudioSystem::kCommandQueueSize;
+
+AudioSystem::AudioSystem(float sampleRate) : m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f),
+                                             m_activeVoiceCount(0),
+                                             m_latencyFrames(0),
+                                             m_compressorReduction(0.0f),
+                                             m_limiterReduction(0.0f),
+                                             m_droppedCommands(0),
+                                             m_activeChain(nullptr),
+                                             m_fadingChain(nullptr),
+                                             m_fadePosition(0),
+                                             m_parts(kPartSlots),
+                                             m_renderFrames(0),
+                                             m_pendingChain(nullptr),
+                                             m_retiredCount(0),
+                                             m_publishedChain(nullptr),
+                                             m_chainGeneration(0)
 {
     // Validate sample rate
     if (sampleRate <= 0.0f) {
@@ -34,58 +344,228 @@ AudioSystem::AudioSystem(float sampleRate) : m_frequency(0.0f),
         m_sampleRate = 44100.0f;
     }
     
-    // Default to square wave
-    m_waveform = std::make_shared<SquareWave>();
+    for (auto& state : m_parts) {
+        state.left.assign(kMaxBlockFrames, 0.0f);
+        state.right.assign(kMaxBlockFrames, 0.0f);
+        state.fadeLeft.assign(kMaxBlockFrames, 0.0f);
+        state.fadeRight.assign(kMaxBlockFrames, 0.0f);
+        state.oscillator.assign(kMaxBlockFrames, 0.0f);
+        state.envelope.assign(kMaxBlockFrames, 0.0f);
+        state.tailFrames = 0;
+        state.tailPending = false;
+        state.sounding = false;
+    }
+    
+    // Start with a square wave, no effects and the default number of voices.
+    // Nothing is rendering yet, so the chain becomes active directly.
+    m_activeChain = new SignalChain();
+    m_activeChain->waveform = std::make_shared<SquareWave>();
+    m_activeChain->voicePool = createVoicePool(m_voiceConfig);
+    m_activeChain->masterBus = std::make_shared<MasterBus>(m_masterConfig, m_sampleRate, kMaxBlockFrames);
+    m_activeChain->latencyFrames = m_activeChain->masterBus->getLatency();
+    m_latencyFrames.store(m_activeChain->latencyFrames, std::memory_order_relaxed);
+    m_publishedChain = m_activeChain;
+}
+
+AudioSystem::~AudioSystem()
+{
+    // The stream is stopped, so the audio thread no longer owns any chain
+    releaseRetiredChains();
+    delete m_pendingChain.exchange(nullptr, std::memory_order_acq_rel);
+    delete m_fadingChain;
+    delete m_activeChain;
+}
+
+std::shared_ptr<VoicePool> AudioSystem::createVoicePool(const AudioConfig& config)
+{
+    std::string policyLower = toLowercase(config.voiceStealPolicy);
+
+    VoiceStealPolicy policy = VoiceStealPolicy::Oldest;
+    if (policyLower == "quietest") {
+        policy = VoiceStealPolicy::Quietest;
+    } else if (policyLower == "samenote" || policyLower == "same-note" || policyLower == "same_note") {
+        policy = VoiceStealPolicy::SameNote;
+    }
+    // Fallback to oldest for empty or unrecognized policies
+
+    ADSREnvelope envelope(config.attackTime, config.decayTime, config.sustainLevel, config.releaseTime);
+    auto voicePool = std::make_shared<VoicePool>();
+    voicePool->configure(config.maxVoices, policy, envelope);
+    return voicePool;
+}
+
+std::unique_ptr<SignalChain> AudioSystem::copyPublishedChain() const
+{
+    auto chain = std::make_unique<SignalChain>(*m_publishedChain);
+    // The copy shares its effects with the running chain, so running both
+    // side by side in a crossfade would process them twice
+    chain->crossfadeFrames = 0;
+    return chain;
+}
+
+void AudioSystem::publishChain(std::unique_ptr<SignalChain> chain)
+{
+    // Free what the audio thread retired since the last publish; otherwise a
+    // run of setWaveform()/addEffect() calls fills the garbage queue and the
+    // audio thread stops adopting new chains
+    releaseRetiredChains();
+
+    chain->generation = ++m_chainGeneration;
+    chain->latencyFrames = chain->masterBus->getLatency() + effectLatency(*chain);
+
+    // The parts had their latency set when they were built
+    unsigned int latency = chain->latencyFrames;
+    for (const auto& part : chain->parts) {
+        latency = std::max(latency, part->latencyFrames);
+    }
+    m_latencyFrames.store(latency, std::memory_order_relaxed);
+    m_publishedChain = chain.get();
+
+    // A chain that was still pending was never seen by the audio thread, so
+    // it can be freed right here
+    delete m_pendingChain.exchange(chain.release(), std::memory_order_acq_rel);
+}
+
+void AudioSystem::collectGarbage()
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    releaseRetiredChains();
+}
+
+void AudioSystem::releaseRetiredChains()
+{
+    SignalChain* chain = nullptr;
+    while (m_retiredChains.pop(chain))
+    {
+        delete chain;
+        m_retiredCount.fetch_sub(1, std::memory_order_release);
+    }
 }
 
 void AudioSystem::setWaveform(std::shared_ptr<IWave> waveform)
 {
-    if (waveform) {
-        m_waveform = waveform;
+    if (!waveform) {
+        return; // If waveform is null, keep existing waveform
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    auto chain = copyPublishedChain();
+    chain->waveform = waveform;
+    publishChain(std::move(chain));
+}
+
+void AudioSystem::buildPart(const AudioConfig& config, SignalChain& part) const
+{
+    part.waveform = createWaveform(config.waveform);
+
+    // One LFO for all modulated effects, if requested and needed
+    if (config.lfoShared && usesModulatedEffect(config)) {
+        part.lfo = std::make_shared<BlockLfo>(config.lfoRate);
+        part.lfo->prepare(m_sampleRate, kMaxBlockFrames);
+    }
+
+    // A configured graph replaces the serial list
+    if (!config.effectGraph.empty()) {
+        try {
+            buildEffectGraph(config, m_sampleRate, kMaxBlockFrames, part);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Effect graph disabled, using the effect list: " << e.what() << std::endl;
+        }
+    }
+
+    // Otherwise instantiate the effects listed in the configuration (case-insensitive)
+    if (!part.graph) {
+        for (const auto& name : config.effects)
+        {
+            std::string effectLower = canonicalEffectName(name);
+            if (auto effect = createEffect(effectLower, config, m_sampleRate, part.lfo)) {
+                effect->prepare(m_sampleRate, kMaxBlockFrames);
+                part.effects.push_back(effect);
+                part.effectNames.push_back(effectLower);
+            }
+            // Silently ignore unrecognized effect names
+        }
     }
-    // If waveform is null, keep existing waveform
 }
 
 // Configure the oscillator and effects based on the provided AudioConfig
 void AudioSystem::configure(const AudioConfig& config)
 {
-    // Select waveform (case-insensitive)
-    std::string waveformLower = toLowercase(config.waveform);
-    
-    if (waveformLower == "sine") {
-        m_waveform = std::make_shared<SineWave>();
-    } else if (waveformLower == "sawtooth" || waveformLower == "saw") {
-        m_waveform = std::make_shared<SawtoothWave>();
-    } else if (waveformLower == "triangle" || waveformLower == "tri") {
-        m_waveform = std::make_shared<TriangleWave>();
-    } else if (waveformLower == "square" || waveformLower.empty()) {
-        // Default to square wave for empty or unrecognized waveforms
-        m_waveform = std::make_shared<SquareWave>();
-    } else {
-        // Fallback to square wave for unrecognized waveforms
-        m_waveform = std::make_shared<SquareWave>();
+    // Build the whole chain before touching any shared state
+    auto chain = std::make_unique<SignalChain>();
+    buildPart(config, *chain);
+
+    if (config.chainCrossfadeTime > 0.0f) {
+        chain->crossfadeFrames = static_cast<unsigned int>(config.chainCrossfadeTime * m_sampleRate + 0.5f);
     }
 
-    // Clear existing effects
-    m_effects.clear();
+    // The channel parts, in channel order so that a part keeps its slot
+    // (and can crossfade) when the configuration is applied again
+    std::vector<AudioPartConfig> partConfigs = config.parts;
+    std::stable_sort(partConfigs.begin(), partConfigs.end(),
+              [](const AudioPartConfig& a, const AudioPartConfig& b) { return a.channel < b.channel; });
+    for (const auto& partConfig : partConfigs) {
+        if (partConfig.channel >= 16 || !partConfig.settings || chain->channelSlots[partConfig.channel] != 0) {
+            continue;
+        }
+        auto part = std::make_shared<SignalChain>();
+        buildPart(*partConfig.settings, *part);
+        chain->parts.push_back(part);
+        chain->channelSlots[partConfig.channel] = static_cast<unsigned char>(chain->parts.size());
+    }
 
-    // Instantiate effects listed in the configuration (case-insensitive)
-    for (const auto& name : config.effects)
-    {
-        std::string effectLower = toLowercase(name);
-        
-        if (effectLower == "octave") {
-            auto eff = std::make_shared<OctaveEffect>();
-            m_effects.push_back(eff);
-        } else if (effectLower == "delay" || effectLower == "echo") {
-            auto eff = std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, m_sampleRate);
-            m_effects.push_back(eff);
-        } else if (effectLower == "lowpass" || effectLower == "lpf" || effectLower == "filter") {
-            auto eff = std::make_shared<LowPassEffect>(1000.0f, m_sampleRate);
-            m_effects.push_back(eff);
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    // Keep the sounding voices unless the polyphony or envelope changed
+    if (sameVoiceSettings(config, m_voiceConfig)) {
+        chain->voicePool = m_publishedChain->voicePool;
+    } else {
+        chain->voicePool = createVoicePool(config);
+        m_voiceConfig = config;
+    }
+
+    // Likewise for each part, matched by channel
+    for (const auto& partConfig : partConfigs) {
+        const unsigned char slot = partConfig.channel < 16 ? chain->channelSlots[partConfig.channel] : 0;
+        if (slot == 0 || chain->getSlot(slot).voicePool) {
+            continue;
+        }
+        SignalChain& part = chain->getSlot(slot);
+        auto previous = std::find_if(m_partConfigs.begin(), m_partConfigs.end(),
+                                     [&](const AudioPartConfig& other) { return other.channel == partConfig.channel; });
+        if (previous != m_partConfigs.end() && sameVoiceSettings(*partConfig.settings, *previous->settings)) {
+            part.voicePool = m_publishedChain->getChannelPart(static_cast<unsigned char>(partConfig.channel)).voicePool;
+        } else {
+            part.voicePool = createVoicePool(*partConfig.settings);
         }
-        // Silently ignore unrecognized effect names
     }
+    m_partConfigs = partConfigs;
+
+    // Keep the worker threads unless their number or the audio thread's CPUs changed
+    const unsigned int workers = voiceWorkerCount(config);
+    const auto& previousWorkers = m_publishedChain->voiceWorkers;
+    if (workers == 0) {
+        chain->voiceWorkers.reset();
+    } else if (previousWorkers && previousWorkers->getWorkerCount() == workers &&
+               previousWorkers->getReservedCpus() == config.realtimeCpus) {
+        chain->voiceWorkers = previousWorkers;
+    } else {
+        chain->voiceWorkers = std::make_shared<VoiceWorkerPool>(workers, kMaxBlockFrames, config.realtimeCpus);
+    }
+
+    // Likewise keep the master dynamics (and the audio in the lookahead)
+    if (sameMasterSettings(config, m_masterConfig)) {
+        chain->masterBus = m_publishedChain->masterBus;
+    } else {
+        chain->masterBus = std::make_shared<MasterBus>(config, m_sampleRate, kMaxBlockFrames);
+        m_masterConfig = config;
+    }
+
+    for (const auto& part : chain->parts) {
+        part->latencyFrames = chain->masterBus->getLatency() + effectLatency(*part);
+    }
+
+    publishChain(std::move(chain));
 }
 
 void AudioSystem::triggerNote(float newFrequency)
@@ -95,61 +575,550 @@ void AudioSystem::triggerNote(float newFrequency)
         return; // Ignore invalid frequencies
     }
     
-    m_frequency = newFrequency;
-    m_noteOn = true;
-    m_phase = 0.0f;
+    noteOn(frequencyToMidiNote(newFrequency), 0, newFrequency, 1.0f);
+}
 
-    // Configure effects with the new frequency and sample rate
-    for (auto& effect : m_effects)
+bool AudioSystem::noteOn(unsigned char note, unsigned char channel, float frequency, float velocity)
+{
+    // Validate frequency range (20 Hz to 20 kHz is typical audio range)
+    if (frequency <= 0.0f || frequency > 20000.0f) {
+        return true; // Ignore invalid frequencies
+    }
+
+    AudioCommand command{};
+    command.type = AudioCommandType::NoteOn;
+    command.note = note;
+    command.channel = channel;
+    command.value = frequency;
+    command.velocity = velocity;
+    return pushCommand(command);
+}
+
+bool AudioSystem::noteOff(unsigned char note, unsigned char channel)
+{
+    AudioCommand command{};
+    command.type = AudioCommandType::NoteOff;
+    command.note = note;
+    command.channel = channel;
+    return pushCommand(command);
+}
+
+bool AudioSystem::channelNotesOff(unsigned char channel)
+{
+    AudioCommand command{};
+    command.type = AudioCommandType::ChannelNotesOff;
+    command.channel = channel;
+    return pushCommand(command);
+}
+
+bool AudioSystem::triggerNoteOff() 
+{
+    AudioCommand command{};
+    command.type = AudioCommandType::AllNotesOff;
+    return pushCommand(command);
+}
+
+bool AudioSystem::pushCommand(const AudioCommand& command)
+{
+    if (m_commands.push(command)) {
+        return true;
+    }
+    m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void AudioSystem::processCommands()
+{
+    AudioCommand command;
+    while (m_commands.pop(command))
     {
-        if (auto octave = std::dynamic_pointer_cast<OctaveEffect>(effect))
+        switch (command.type)
         {
-            octave->setFrequency(newFrequency);
-            octave->setSampleRate(m_sampleRate);
+            case AudioCommandType::NoteOn:
+                handleNoteOn(command.note, command.channel, command.value, command.velocity);
+                break;
+
+            case AudioCommandType::NoteOff:
+                handleNoteOff(command.note, command.channel);
+                break;
+
+            case AudioCommandType::AllNotesOff:
+            {
+                NoteEvent event;
+                event.type = NoteEvent::Type::AllOff;
+                event.note = 0;
+                event.channel = 0;
+                event.frequency = 0.0f;
+                event.velocity = 0.0f;
+
+                for (unsigned int slot = 0; slot < m_activeChain->getSlotCount(); ++slot) {
+                    SignalChain& part = m_activeChain->getSlot(slot);
+                    part.voicePool->allNotesOff();
+                    notifyEffects(part, event);
+                }
+                break;
+            }
+
+            case AudioCommandType::ChannelNotesOff:
+            {
+                // Released note by note, so effects tracking the held keys
+                // keep the ones other channels of the part still hold
+                SignalChain& part = m_activeChain->getChannelPart(command.channel);
+                for (const auto& voice : part.voicePool->getVoices()) {
+                    if (voice.active && voice.held && voice.channel == command.channel) {
+                        handleNoteOff(voice.note, command.channel);
+                    }
+                }
+                break;
+            }
+
+            case AudioCommandType::SetEffectParameter:
+            {
+                // The slot was resolved against a chain that was published
+                // before the command was queued, so it may still be pending
+                if (isNewerGeneration(command.chainGeneration, m_activeChain->generation)) {
+                    adoptPendingChain();
+                }
+
+                // Commands for a chain that has since been replaced are dropped
+                const auto& effects = m_activeChain->effects;
+                if (command.chainGeneration == m_activeChain->generation &&
+                    command.effectSlot < effects.size() && effects[command.effectSlot]) {
+                    effects[command.effectSlot]->setParameter(command.parameterId, command.value);
+                }
+                break;
+            }
+
+            case AudioCommandType::ResetEffects:
+                for (unsigned int slot = 0; slot < m_activeChain->getSlotCount(); ++slot) {
+                    if (m_activeChain->getSlot(slot).graph) {
+                        m_activeChain->getSlot(slot).graph->reset();
+                    }
+                    for (const auto& effect : m_activeChain->getSlot(slot).effects) {
+                        if (effect) {
+                            effect->reset();
+                        }
+                    }
+                }
+                break;
         }
-        else if (auto delay = std::dynamic_pointer_cast<DelayEffect>(effect))
-        {
-            delay->setSampleRate(m_sampleRate);
+    }
+}
+
+void AudioSystem::handleNoteOn(unsigned char note, unsigned char channel, float frequency, float velocity)
+{
+    SignalChain& part = m_activeChain->getChannelPart(channel);
+    if (part.voicePool->noteOn(note, channel, frequency, velocity) == nullptr) {
+        return;
+    }
+
+    // Effects are not reset here: other voices may still be sounding through them
+    NoteEvent event;
+    event.type = NoteEvent::Type::On;
+    event.note = note;
+    event.channel = channel;
+    event.frequency = frequency;
+    event.velocity = velocity;
+    notifyEffects(part, event);
+}
+
+void AudioSystem::handleNoteOff(unsigned char note, unsigned char channel)
+{
+    SignalChain& part = m_activeChain->getChannelPart(channel);
+    part.voicePool->noteOff(note, channel);
+
+    NoteEvent event;
+    event.type = NoteEvent::Type::Off;
+    event.note = note;
+    event.channel = channel;
+    event.frequency = midiNoteToFrequency(note);
+    event.velocity = 0.0f;
+    notifyEffects(part, event);
+}
+
+void AudioSystem::notifyEffects(SignalChain& part, const NoteEvent& event)
+{
+    for (const auto& effect : part.effects) {
+        if (effect) {
+            effect->onNoteEvent(event);
         }
-        else if (auto lp = std::dynamic_pointer_cast<LowPassEffect>(effect))
-        {
-            lp->setSampleRate(m_sampleRate);
+    }
+}
+
+std::pair<float, float> AudioSystem::getNextSample() 
+{
+    // Single-frame block keeps the per-sample API on the same code path
+    float left = 0.0f;
+    float right = 0.0f;
+    renderBlock(&left, &right, 1);
+
+    return {left, right};
+}
+
+void AudioSystem::renderBlock(float* left, float* right, unsigned int numFrames)
+{
+    RtSafetyCheck::Scope realtime;
+
+    // Switch chains before applying the commands queued against the new one
+    adoptPendingChain();
+
+    // Apply everything the control threads queued since the last block
+    processCommands();
+
+    // Parts without voices or a ringing tail cost nothing
+    SignalChain& chain = *m_activeChain;
+    unsigned int renderCount = 0;
+    for (unsigned int slot = 0; slot < chain.getSlotCount(); ++slot) {
+        if (preparePart(slot)) {
+            m_renderSlots[renderCount++] = slot;
         }
     }
 
-    resetEffects();
+    if (renderCount == 0)
+    {
+        std::fill(left, left + numFrames, 0.0f);
+        std::fill(right, right + numFrames, 0.0f);
+        // Nothing is audible, so there is nothing to crossfade either
+        finishCrossfade();
+        m_activeVoiceCount.store(0, std::memory_order_relaxed);
+        m_compressorReduction.store(0.0f, std::memory_order_relaxed);
+        m_limiterReduction.store(0.0f, std::memory_order_relaxed);
+        return;
+    }
+
+    // Several parts are spread over the workers whole; a single part spreads its voices
+    VoiceWorkerPool* workers = chain.voiceWorkers.get();
+    const bool parallelParts = workers != nullptr && renderCount > 1;
+
+    // Work in chunks that fit the preallocated scratch buffers
+    for (unsigned int offset = 0; offset < numFrames; offset += kMaxBlockFrames)
+    {
+        unsigned int frames = numFrames - offset;
+        if (frames > kMaxBlockFrames) {
+            frames = kMaxBlockFrames;
+        }
+
+        if (parallelParts) {
+            m_renderFrames = frames;
+            workers->run(&AudioSystem::renderPartTask, this, renderCount);
+        } else {
+            for (unsigned int i = 0; i < renderCount; ++i) {
+                renderPart(m_renderSlots[i], frames, workers);
+            }
+        }
+
+        // Mix the parts into the output
+        float* blockLeft = left + offset;
+        float* blockRight = right + offset;
+        const PartRender& first = m_parts[m_renderSlots[0]];
+        std::copy(first.left.data(), first.left.data() + frames, blockLeft);
+        std::copy(first.right.data(), first.right.data() + frames, blockRight);
+        for (unsigned int i = 1; i < renderCount; ++i) {
+            const PartRender& state = m_parts[m_renderSlots[i]];
+            for (unsigned int n = 0; n < frames; ++n) {
+                blockLeft[n] += state.left[n];
+                blockRight[n] += state.right[n];
+            }
+        }
+
+        if (m_fadingChain != nullptr) {
+            advanceCrossfade(frames);
+        }
+    }
+
+    unsigned int activeVoices = 0;
+    for (unsigned int slot = 0; slot < chain.getSlotCount(); ++slot) {
+        activeVoices += chain.getSlot(slot).voicePool->getActiveCount();
+    }
+    m_activeVoiceCount.store(activeVoices, std::memory_order_relaxed);
+    processMaster(left, right, numFrames);
+
+    bool audible = false;
+    for (unsigned int i = 0; i < renderCount; ++i) {
+        PartRender& state = m_parts[m_renderSlots[i]];
+        if (!state.sounding) {
+            state.tailFrames -= std::min(state.tailFrames, numFrames);
+        }
+        audible = audible || state.sounding || state.tailFrames > 0;
+    }
+
+    // The lookahead has been flushed; the next note starts on a clean master bus
+    if (!audible) {
+        chain.masterBus->reset();
+    }
 }
 
-void AudioSystem::triggerNoteOff() 
+bool AudioSystem::preparePart(unsigned int slot)
 {
-    m_noteOn = false;
+    PartRender& state = m_parts[slot];
+    const SignalChain& part = m_activeChain->getSlot(slot);
+    const SignalChain* fading = getFadingPart(slot, part);
+
+    state.sounding = part.voicePool->getActiveCount() > 0 && part.waveform;
+    if (state.sounding) {
+        state.tailPending = true;
+        return true;
+    }
+
+    // The last voice has finished: the effects still ring for a while
+    if (state.tailPending) {
+        state.tailPending = false;
+        state.tailFrames = computeTailFrames(part, m_sampleRate);
+        if (fading != nullptr) {
+            state.tailFrames = std::max(state.tailFrames, computeTailFrames(*fading, m_sampleRate));
+        }
+    }
+
+    // Tails that decayed early leave only the latency to flush
+    if (state.tailFrames > 0 && isChainSilent(part) && (fading == nullptr || isChainSilent(*fading))) {
+        state.tailFrames = std::min(state.tailFrames, part.latencyFrames);
+    }
+    return state.tailFrames > 0;
 }
 
-std::pair<float, float> AudioSystem::getNextSample() 
+const SignalChain* AudioSystem::getFadingPart(unsigned int slot, const SignalChain& part) const
+{
+    if (m_fadingChain == nullptr || slot >= m_fadingChain->getSlotCount()) {
+        return nullptr;
+    }
+    const SignalChain* fading = &m_fadingChain->getSlot(slot);
+    return fading != &part ? fading : nullptr;
+}
+
+void AudioSystem::renderPartTask(void* context, unsigned int item, unsigned int /*participant*/)
+{
+    AudioSystem& audioSystem = *static_cast<AudioSystem*>(context);
+    audioSystem.renderPart(audioSystem.m_renderSlots[item], audioSystem.m_renderFrames, nullptr);
+}
+
+void AudioSystem::renderPart(unsigned int slot, unsigned int numFrames, VoiceWorkerPool* workers)
+{
+    PartRender& state = m_parts[slot];
+    SignalChain& part = m_activeChain->getSlot(slot);
+    const SignalChain* fading = getFadingPart(slot, part);
+    float* left = state.left.data();
+    float* right = state.right.data();
+
+    std::fill(left, left + numFrames, 0.0f);
+    if (state.sounding) {
+        renderVoices(part, state, numFrames, workers);
+    }
+
+    // The voice mix is mono; start both channels from it
+    std::copy(left, left + numFrames, right);
+
+    // During a crossfade the outgoing part runs on its own copy of the mix
+    if (fading != nullptr) {
+        std::copy(left, left + numFrames, state.fadeLeft.data());
+        std::copy(left, left + numFrames, state.fadeRight.data());
+        processChain(*fading, state.fadeLeft.data(), state.fadeRight.data(), numFrames, !state.sounding);
+    }
+
+    processChain(part, left, right, numFrames, !state.sounding);
+
+    if (fading != nullptr) {
+        mixCrossfade(state, numFrames);
+    }
+}
+
+void AudioSystem::processMaster(float* left, float* right, unsigned int numFrames)
+{
+    MasterBus& masterBus = *m_activeChain->masterBus;
+    masterBus.process(left, right, numFrames);
+    m_compressorReduction.store(masterBus.getCompressorReduction(), std::memory_order_relaxed);
+    m_limiterReduction.store(masterBus.getLimiterReduction(), std::memory_order_relaxed);
+}
+
+void AudioSystem::processChain(const SignalChain& chain, float* left, float* right, unsigned int numFrames,
+                               bool inputSilent)
+{
+    // The modulated effects read this block's values of the shared LFO
+    if (chain.lfo) {
+        chain.lfo->generate(numFrames);
+    }
+
+    // The graph runs its effects; any effects added later follow in series
+    size_t first = 0;
+    if (chain.graph) {
+        inputSilent = chain.graph->process(left, right, numFrames, inputSilent);
+        first = chain.graphEffects;
+    }
+
+    // Run the whole block through each effect in the chain
+    for (size_t i = first; i < chain.effects.size(); ++i)
+    {
+        IEffect* effect = chain.effects[i].get();
+        if (!effect) { // Null check for safety
+            continue;
+        }
+        // A silent effect fed silence would only output silence
+        if (inputSilent && effect->isSilent()) {
+            continue;
+        }
+        effect->processBlock(left, right, numFrames);
+        inputSilent = false;
+    }
+}
+
+unsigned int AudioSystem::computeTailFrames(const SignalChain& chain, float sampleRate)
 {
-    if (!m_noteOn || !m_waveform) 
+    // Each effect's tail is fed by the tail of the ones before it
+    double seconds = 0.0;
+    for (const auto& effect : chain.effects) {
+        if (effect) {
+            seconds += effect->getTailTime();
+        }
+    }
+
+    const double limit = static_cast<double>(std::numeric_limits<unsigned int>::max() - chain.latencyFrames);
+    const double frames = std::min(std::ceil(seconds * sampleRate), limit);
+    return static_cast<unsigned int>(frames) + chain.latencyFrames;
+}
+
+bool AudioSystem::isChainSilent(const SignalChain& chain)
+{
+    for (const auto& effect : chain.effects) {
+        if (effect && !effect->isSilent()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioSystem::mixCrossfade(PartRender& state, unsigned int numFrames) const
+{
+    const float* oldLeft = state.fadeLeft.data();
+    const float* oldRight = state.fadeRight.data();
+    float* left = state.left.data();
+    float* right = state.right.data();
+    const unsigned int fadeFrames = m_activeChain->crossfadeFrames;
+    const float step = 1.0f / static_cast<float>(fadeFrames);
+
+    // Both parts are fed the same dry signal, so a linear fade keeps the level
+    for (unsigned int i = 0; i < numFrames; ++i)
     {
-        return {0.0f, 0.0f};
+        const unsigned int position = m_fadePosition + i;
+        const float gain = position < fadeFrames ? static_cast<float>(position) * step : 1.0f;
+        left[i] = oldLeft[i] + (left[i] - oldLeft[i]) * gain;
+        right[i] = oldRight[i] + (right[i] - oldRight[i]) * gain;
+    }
+}
+
+void AudioSystem::advanceCrossfade(unsigned int numFrames)
+{
+    // Every part of the chunk faded from the same position
+    m_fadePosition += numFrames;
+    if (m_fadePosition >= m_activeChain->crossfadeFrames) {
+        finishCrossfade();
+    }
+}
+
+bool AudioSystem::adoptPendingChain()
+{
+    // Adopting may retire two chains (the one fading out and the active one);
+    // wait until the garbage queue is certain to have room for both
+    if (m_retiredCount.load(std::memory_order_acquire) + 2 > m_retiredChains.capacity()) {
+        return false;
     }
 
-    // Generate a sample using the waveform generator
-    float sample = m_waveform->generate(m_frequency, m_sampleRate, m_phase);
+    SignalChain* next = m_pendingChain.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr) {
+        return false;
+    }
 
-    // Create a stereo sample (initially identical in both channels)
-    std::pair<float, float> stereoSample{sample, sample};
+    // A fade still in progress is cut short
+    finishCrossfade();
 
-    // Apply effects to the stereo sample
-    stereoSample = applyEffects(stereoSample);
+    SignalChain* previous = m_activeChain;
+    releaseMovedChannels(*previous, *next);
+    m_activeChain = next;
 
-    return stereoSample;
+    // Slots beyond the new chain's parts start from scratch if they return
+    for (unsigned int slot = next->getSlotCount(); slot < kPartSlots; ++slot) {
+        m_parts[slot].tailFrames = 0;
+        m_parts[slot].tailPending = false;
+    }
+
+    if (next->crossfadeFrames > 0) {
+        m_fadingChain = previous;
+        m_fadePosition = 0;
+    } else {
+        retireChain(previous);
+    }
+    return true;
+}
+
+void AudioSystem::releaseMovedChannels(SignalChain& previous, SignalChain& next)
+{
+    for (unsigned char channel = 0; channel < 16; ++channel)
+    {
+        VoicePool* before = previous.getChannelPart(channel).voicePool.get();
+        if (before == next.getChannelPart(channel).voicePool.get()) {
+            continue;
+        }
+        // The channel's note-offs now go to another pool
+        for (unsigned int slot = 0; slot < next.getSlotCount(); ++slot) {
+            if (next.getSlot(slot).voicePool.get() == before) {
+                before->channelNotesOff(channel);
+            }
+        }
+    }
+}
+
+void AudioSystem::retireChain(SignalChain* chain)
+{
+    // Cannot fail: adoptPendingChain() checked for room up front
+    m_retiredChains.push(chain);
+    m_retiredCount.fetch_add(1, std::memory_order_release);
+}
+
+void AudioSystem::finishCrossfade()
+{
+    if (m_fadingChain != nullptr) {
+        retireChain(m_fadingChain);
+        m_fadingChain = nullptr;
+    }
+}
+
+void AudioSystem::renderVoices(SignalChain& part, PartRender& state, unsigned int numFrames, VoiceWorkerPool* workers)
+{
+    VoicePool& voicePool = *part.voicePool;
+    IWave& waveform = *part.waveform;
+    float* output = state.left.data();
+
+    if (workers != nullptr) {
+        workers->render(voicePool, waveform, m_sampleRate, output, numFrames);
+        return;
+    }
+
+    for (auto& voice : voicePool.getVoices())
+    {
+        if (!voice.active) {
+            continue;
+        }
+
+        VoiceWorkerPool::renderVoice(voice, waveform, m_sampleRate, output,
+                                     state.oscillator.data(), state.envelope.data(), numFrames);
+
+        // Return the voice to the pool once its release has finished
+        if (voice.envelope.isIdle()) {
+            voicePool.freeVoice(voice);
+        }
+    }
 }
 
 std::pair<float, float> AudioSystem::applyEffects(std::pair<float, float> stereoSample) 
 {
+    size_t first = 0;
+    if (m_activeChain->graph) {
+        m_activeChain->graph->process(&stereoSample.first, &stereoSample.second, 1);
+        first = m_activeChain->graphEffects;
+    }
+
     // Apply each effect in the chain to the stereo sample
-    for (const auto& effect : m_effects) 
+    for (size_t i = first; i < m_activeChain->effects.size(); ++i)
     {
-        if (effect) { // Null check for safety
+        if (const auto& effect = m_activeChain->effects[i]) { // Null check for safety
             stereoSample = effect->process(stereoSample);
         }
     }
@@ -162,66 +1131,143 @@ void AudioSystem::addEffect(std::shared_ptr<IEffect> effect)
     if (!effect) {
         return; // Don't add null effects
     }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    const auto& effects = m_publishedChain->effects;
     
-    // Check if the effect already exists in the vector
-    auto it = std::find(m_effects.begin(), m_effects.end(), effect);
+    // Check if the effect already exists in the chain
+    auto it = std::find(effects.begin(), effects.end(), effect);
     
-    if (it == m_effects.end()) 
+    if (it == effects.end()) 
     {
-        // Effect not found, so add it to the vector
-        m_effects.push_back(effect);
+        // Effect not found, so publish a chain with it appended (not addressable by name)
+        effect->prepare(m_sampleRate, kMaxBlockFrames);
+        auto chain = copyPublishedChain();
+        chain->effects.push_back(effect);
+        chain->effectNames.push_back(std::string());
+        publishChain(std::move(chain));
     } 
 }
 
 
-void AudioSystem::resetEffects() 
+bool AudioSystem::resetEffects() 
 {
-    for (const auto& effect : m_effects) 
-    {
-        if (effect) { // Null check for safety
-            effect->reset();
-        }
-    }
+    AudioCommand command{};
+    command.type = AudioCommandType::ResetEffects;
+    return pushCommand(command);
+}
+
+AudioCommand AudioSystem::effectParameter(unsigned int generation, size_t slot, unsigned int parameterId, float value)
+{
+    AudioCommand command{};
+    command.type = AudioCommandType::SetEffectParameter;
+    command.effectSlot = static_cast<unsigned char>(slot);
+    command.parameterId = parameterId;
+    command.chainGeneration = generation;
+    command.value = value;
+    return command;
 }
 
 bool AudioSystem::updateEffectParameters(const std::string& effectName, const IEffectParameters& parameters)
 {
-    std::string effectLower = toLowercase(effectName);
+    std::string effectLower = canonicalEffectName(effectName);
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    const auto& effectNames = m_publishedChain->effectNames;
+    const unsigned int generation = m_publishedChain->generation;
     
-    for (auto& effect : m_effects)
+    // Resolve the effect on the control thread; the audio thread only sees
+    // (chain, slot, parameter id, value) commands
+    for (size_t slot = 0; slot < effectNames.size(); ++slot)
     {
-        if (effectLower == "delay" || effectLower == "echo") {
-            if (auto delayEffect = std::dynamic_pointer_cast<DelayEffect>(effect)) {
-                if (auto delayParams = dynamic_cast<const DelayParameters*>(&parameters)) {
-                    delayEffect->setDelayTime(delayParams->delayTime);
-                    delayEffect->setFeedback(delayParams->feedback);
-                    delayEffect->setMix(delayParams->mix);
-                    return true;
-                }
+        if (effectNames[slot] != effectLower) {
+            continue;
+        }
+
+        // The parameters of one update are queued as a group, so a full
+        // queue never leaves an effect half updated
+        AudioCommand commands[6];
+        size_t count = 0;
+        auto set = [&](unsigned int parameterId, float value) {
+            commands[count++] = effectParameter(generation, slot, parameterId, value);
+        };
+
+        if (effectLower == "delay") {
+            if (auto delayParams = dynamic_cast<const DelayParameters*>(&parameters)) {
+                set(DelayEffect::DelayTime, delayParams->delayTime);
+                set(DelayEffect::Feedback, delayParams->feedback);
+                set(DelayEffect::Mix, delayParams->mix);
+                set(DelayEffect::Tempo, delayParams->tempo);
+                set(DelayEffect::SyncDivision, delayParams->syncDivision);
+                set(DelayEffect::PingPong, delayParams->pingPong ? 1.0f : 0.0f);
             }
         }
-        else if (effectLower == "lowpass" || effectLower == "lpf" || effectLower == "filter") {
-            if (auto lowPassEffect = std::dynamic_pointer_cast<LowPassEffect>(effect)) {
-                if (auto lowPassParams = dynamic_cast<const LowPassParameters*>(&parameters)) {
-                    lowPassEffect->setCutoff(lowPassParams->cutoffFreq);
-                    // Note: LowPassEffect doesn't have setResonance in the current implementation
-                    // This could be added to the effect later if needed
-                    return true;
-                }
+        else if (isFilterEffect(effectLower)) {
+            if (auto lowPassParams = dynamic_cast<const LowPassParameters*>(&parameters)) {
+                set(FilterEffect::FilterMode, static_cast<float>(lowPassParams->mode));
+                set(FilterEffect::Cutoff, lowPassParams->cutoffFreq);
+                set(FilterEffect::Resonance, lowPassParams->resonance);
+                set(FilterEffect::Gain, lowPassParams->gainDb);
+            }
+        }
+        else if (effectLower == "reverb") {
+            if (auto reverbParams = dynamic_cast<const ReverbParameters*>(&parameters)) {
+                set(ReverbEffect::Size, reverbParams->size);
+                set(ReverbEffect::Decay, reverbParams->decay);
+                set(ReverbEffect::Damping, reverbParams->damping);
+                set(ReverbEffect::Mix, reverbParams->mix);
+            }
+        }
+        else if (effectLower == "overdrive" || effectLower == "hardclip" || effectLower == "foldback") {
+            if (auto shaperParams = dynamic_cast<const WaveshaperParameters*>(&parameters)) {
+                // The oversampling wrapper forwards the ids to the waveshaper
+                set(WaveshaperEffect::CurveShape, static_cast<float>(shaperParams->shape));
+                set(WaveshaperEffect::Drive, shaperParams->driveDb);
+                set(WaveshaperEffect::Mix, shaperParams->mix);
+                set(WaveshaperEffect::Level, shaperParams->levelDb);
+            }
+        }
+        else if (effectLower == "chorus") {
+            if (auto modulationParams = dynamic_cast<const ModulationParameters*>(&parameters)) {
+                set(ChorusEffect::Rate, modulationParams->rate);
+                set(ChorusEffect::Depth, modulationParams->depth);
+                set(ChorusEffect::Mix, modulationParams->mix);
+            }
+        }
+        else if (effectLower == "flanger") {
+            if (auto modulationParams = dynamic_cast<const ModulationParameters*>(&parameters)) {
+                set(FlangerEffect::Rate, modulationParams->rate);
+                set(FlangerEffect::Depth, modulationParams->depth);
+                set(FlangerEffect::Feedback, modulationParams->feedback);
+                set(FlangerEffect::Mix, modulationParams->mix);
+            }
+        }
+        else if (effectLower == "phaser") {
+            if (auto modulationParams = dynamic_cast<const ModulationParameters*>(&parameters)) {
+                set(PhaserEffect::Rate, modulationParams->rate);
+                set(PhaserEffect::Depth, modulationParams->depth);
+                set(PhaserEffect::Feedback, modulationParams->feedback);
+                set(PhaserEffect::Mix, modulationParams->mix);
             }
         }
         else if (effectLower == "octave") {
-            if (auto octaveEffect = std::dynamic_pointer_cast<OctaveEffect>(effect)) {
-                if (auto octaveParams = dynamic_cast<const OctaveParameters*>(&parameters)) {
-                    // Convert octave shift to boolean (higher/lower)
-                    bool higher = octaveParams->octaveShift > 1.0f;
-                    octaveEffect->setHigher(higher);
-                    octaveEffect->setBlend(octaveParams->mix);
-                    return true;
-                }
+            if (auto octaveParams = dynamic_cast<const OctaveParameters*>(&parameters)) {
+                // Convert octave shift to boolean (higher/lower)
+                bool higher = octaveParams->octaveShift > 1.0f;
+                set(OctaveEffect::Higher, higher ? 1.0f : 0.0f);
+                set(OctaveEffect::Blend, octaveParams->mix);
+            }
+        }
+
+        // Only the first matching effect is updated, as before
+        if (count > 0) {
+            if (m_commands.pushAll(commands, count)) {
+                return true;
             }
+            m_droppedCommands.fetch_add(count, std::memory_order_relaxed);
+            return false;
         }
     }
     
-    return false; // Effect not found or parameters don't match
+    return false; // Effect not found, parameters don't match, or queue full
 }
@@ -4,10 +4,16 @@
 #include <memory>
 #include <utility>
 #include <string>
+#include <atomic>
+#include <mutex>
 #include "Effects/IEffect.h"
 #include "Effects/EffectParameters.h"
 #include "Waves/IWave.h"
 #include "AudioConfig.h"
+#include "VoicePool.h"
+#include "SignalChain.h"
+#include "AudioCommand.h"
+#include "MpscQueue.h"
 
 /**
  * @file audioSystem.h
@@ -23,8 +29,25 @@
  * 
  * The AudioSystem class handles the generation of simple audio tones based on
  * frequency input and processes them through a configurable chain of audio effects.
- * It provides interfaces for triggering notes, managing effects, and retrieving
- * processed audio samples.
+ * Notes are played polyphonically from a preallocated VoicePool; the voices are
+ * summed and the mix runs through the shared effect chain. It provides interfaces
+ * for triggering notes, managing effects, and retrieving processed audio samples.
+ *
+ * The engine is multi-timbral: AudioConfig::parts gives MIDI channels their
+ * own waveform, voices and effect chain, and the other channels play the main
+ * settings. The parts are mixed into the shared master bus. Parts without
+ * voices or a ringing tail are skipped; with voice workers configured, the
+ * parts sounding in a block are rendered in parallel.
+ *
+ * Threading: note and parameter methods may be called from any control thread
+ * (MIDI, GUI, sequencer). They only enqueue an AudioCommand on a lock-free
+ * queue; the audio thread applies the commands at the start of each
+ * renderBlock(), so the synthesis state is only ever touched by one thread.
+ * configure(), addEffect() and setWaveform() build a new SignalChain on the
+ * calling thread and publish it with one atomic pointer exchange; the audio
+ * thread adopts it at the next block boundary (optionally crossfading from the
+ * old effect chain) and hands the old chain back through a garbage queue that
+ * collectGarbage() empties on a control thread.
  */
 class AudioSystem
 {
@@ -35,25 +58,128 @@ public:
      */
     explicit AudioSystem(float sampleRate);
 
+    /**
+     * @brief Frees every chain; the audio stream must already be stopped
+     */
+    ~AudioSystem();
+
+    AudioSystem(const AudioSystem&) = delete;
+    AudioSystem& operator=(const AudioSystem&) = delete;
+
     /**
      * @brief Triggers a note with the specified frequency
+     *
+     * The note number is derived from the frequency and the note is played
+     * on channel 0 at full velocity.
+     *
      * @param newFrequency The frequency in Hz of the note to play
      */
     void triggerNote(float newFrequency);
 
     /**
-     * @brief Stops the currently playing note
+     * @brief Releases all currently playing notes
+     * @return false if the command queue was full and the command was dropped
+     */
+    bool triggerNoteOff();
+
+    /**
+     * @brief Starts a note on a free (or stolen) voice
+     * @param note MIDI note number (0-127)
+     * @param channel MIDI channel (0-15)
+     * @param frequency The frequency in Hz of the note to play
+     * @param velocity Note velocity [0.0-1.0]
+     * @return false if the command queue was full and the note was dropped
+     *         (an invalid frequency is ignored and returns true)
+     */
+    bool noteOn(unsigned char note, unsigned char channel, float frequency, float velocity);
+
+    /**
+     * @brief Releases the voices playing a note on a channel
+     *
+     * Never blocks. A dropped release leaves the note hanging, so callers
+     * with a running audio thread should retry until it is queued.
+     *
+     * @param note MIDI note number (0-127)
+     * @param channel MIDI channel (0-15)
+     * @return false if the command queue was full and the command was dropped
+     */
+    bool noteOff(unsigned char note, unsigned char channel);
+
+    /**
+     * @brief Releases every voice held on a channel (MIDI All Notes Off)
+     * @param channel MIDI channel (0-15)
+     * @return false if the command queue was full and the command was dropped
+     */
+    bool channelNotesOff(unsigned char channel);
+
+    /**
+     * @brief Commands dropped because the command queue was full, since construction
+     *
+     * Safe to poll from any thread.
+     */
+    unsigned long long getDroppedCommandCount() const { return m_droppedCommands.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of voices sounding at the end of the last rendered block
+     *
+     * Safe to poll from any thread.
+     */
+    unsigned int getActiveVoiceCount() const { return m_activeVoiceCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Processing delay of the effect chain and master bus in frames
+     *
+     * Sum of IEffect::getLatency() over the most recently published chain
+     * plus the master limiter's lookahead, for hosts that compensate for it.
+     * With several parts, the latency of the slowest one.
+     * Safe to poll from any thread.
+     */
+    unsigned int getLatency() const { return m_latencyFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Master compressor gain reduction at the end of the last block, in dB
+     *
+     * 0 when the compressor is disabled. Safe to poll from any thread.
+     */
+    float getCompressorReduction() const { return m_compressorReduction.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Master limiter gain reduction at the end of the last block, in dB
+     *
+     * 0 when the limiter is disabled. Safe to poll from any thread.
      */
-    void triggerNoteOff();
+    float getLimiterReduction() const { return m_limiterReduction.load(std::memory_order_relaxed); }
 
     /**
      * @brief Calculates and returns the next stereo audio sample
+     *
+     * Thin adapter over renderBlock() for callers that still work one frame
+     * at a time. Prefer renderBlock() on the audio path.
+     *
      * @return A pair of floats representing the left and right channel values
      */
     std::pair<float, float> getNextSample();
 
     /**
-     * @brief Adds an audio effect to the processing chain
+     * @brief Renders a block of stereo audio into planar output buffers
+     *
+     * Generates numFrames samples from the waveform and runs the whole block
+     * through each effect in the chain, so the per-sample virtual calls are
+     * replaced by one call per component per block.
+     *
+     * @param left Destination buffer for the left channel (numFrames samples)
+     * @param right Destination buffer for the right channel (numFrames samples)
+     * @param numFrames Number of frames to render
+     */
+    void renderBlock(float* left, float* right, unsigned int numFrames);
+
+    /**
+     * @brief Adds an audio effect to the processing chain of the main part
+     *
+     * Publishes a copy of the current chain with the effect appended. The
+     * existing effects are shared with the old chain, so the switch is not
+     * crossfaded.
+     *
      * @param effect Shared pointer to an effect implementing the IEffect interface
      */
     void addEffect(std::shared_ptr<IEffect> effect);
@@ -67,11 +193,18 @@ public:
 
     /**
      * @brief Resets all effects to their initial state
+     *
+     * Queued like the note commands; the reset happens on the audio thread.
+     *
+     * @return false if the command queue was full and the command was dropped
      */
-    void resetEffects();
+    bool resetEffects();
 
     /**
-     * @brief Sets the waveform generator
+     * @brief Sets the waveform generator of the main part
+     *
+     * Publishes a copy of the current chain with the new waveform.
+     *
      * @param waveform Shared pointer to a waveform generator implementing the IWave interface
      */
     void setWaveform(std::shared_ptr<IWave> waveform);
@@ -80,24 +213,234 @@ public:
      * @brief Apply a configuration to choose waveform and effect chain
      *
      * The configuration structure contains the name of the desired waveform
-     * and an ordered list of effect identifiers. Any existing effects are
-     * cleared and replaced based on this information.
+     * and an ordered list of effect identifiers. A complete new chain is
+     * built on the calling thread and published to the audio thread, which
+     * crossfades to it over AudioConfig::chainCrossfadeTime. The voice pool is
+     * only rebuilt (silencing sounding notes) when the voice settings change.
+     * Safe to call while the stream is running.
      */
     void configure(const AudioConfig& config);
 
+    /**
+     * @brief Frees the chains the audio thread has retired
+     *
+     * Every configure(), addEffect() and setWaveform() does this before
+     * publishing; control threads that reconfigure rarely should also call
+     * it periodically so old effects are not kept alive. Never call it from
+     * the audio thread.
+     */
+    void collectGarbage();
+
     /**
      * @brief Update effect parameters without recreating the effects chain
+     *
+     * The effect is looked up in the main part on the calling thread and the
+     * new values are queued for the audio thread.
+     *
      * @param effectName Name of the effect to update
      * @param parameters Parameters to apply to the effect
-     * @return true if the effect was found and updated, false otherwise
+     * @return true if the effect was found and all of its parameters were queued
+     *         together, false otherwise (a full queue takes none of them)
      */
     bool updateEffectParameters(const std::string& effectName, const IEffectParameters& parameters);
 
+    /**
+     * @brief Largest number of frames rendered per voice pass
+     *
+     * renderBlock() splits longer requests into chunks of this size so the
+     * per-voice scratch buffers can be preallocated.
+     */
+    static constexpr unsigned int kMaxBlockFrames = 256;
+
+    /**
+     * @brief Commands that fit in the queue between two blocks
+     *
+     * A caller feeding more at once than this without a running audio
+     * thread (e.g. an offline render) must render in between.
+     */
+    static constexpr unsigned int kCommandQueueSize = 256;
+
 private:
-    float m_frequency;                                ///< Current note frequency in Hz
+    /**
+     * @brief Builds a voice pool and envelope from the configuration
+     */
+    static std::shared_ptr<VoicePool> createVoicePool(const AudioConfig& config);
+
+    /**
+     * @brief Creates the waveform and effects of a part from the configuration
+     */
+    void buildPart(const AudioConfig& config, SignalChain& part) const;
+
+    /**
+     * @brief Copies the most recently published chain (control side, lock held)
+     */
+    std::unique_ptr<SignalChain> copyPublishedChain() const;
+
+    /**
+     * @brief Frees retired chains, stamps a generation on a chain and hands it to the audio thread (lock held)
+     */
+    void publishChain(std::unique_ptr<SignalChain> chain);
+
+    /**
+     * @brief Deletes every retired chain (control side, lock held)
+     */
+    void releaseRetiredChains();
+
+    /**
+     * @brief Switches to the pending chain, if any (audio thread only)
+     * @return true if a new chain became active
+     */
+    bool adoptPendingChain();
+
+    /**
+     * @brief Hands a chain to the garbage queue (audio thread only)
+     */
+    void retireChain(SignalChain* chain);
+
+    /**
+     * @brief Ends a running crossfade and retires the outgoing chain (audio thread only)
+     */
+    void finishCrossfade();
+
+    /**
+     * @brief Runs a block through every effect of a chain
+     * @param inputSilent True if the block holds no voice signal; silent
+     *                    effects at the head of the chain are then skipped
+     */
+    static void processChain(const SignalChain& chain, float* left, float* right, unsigned int numFrames,
+                             bool inputSilent = false);
+
+    /**
+     * @brief Frames the chain needs to play out its tails and latency once the voices stop
+     */
+    static unsigned int computeTailFrames(const SignalChain& chain, float sampleRate);
+
+    /**
+     * @brief True if every effect of the chain reports itself silent
+     */
+    static bool isChainSilent(const SignalChain& chain);
+
+    /// Audio-thread state and buffers of one part slot
+    struct PartRender {
+        std::vector<float> left;            ///< Part output, left channel
+        std::vector<float> right;           ///< Part output, right channel
+        std::vector<float> fadeLeft;        ///< Outgoing part's left output during a crossfade
+        std::vector<float> fadeRight;       ///< Outgoing part's right output during a crossfade
+        std::vector<float> oscillator;      ///< Scratch buffer for one voice's oscillator block
+        std::vector<float> envelope;        ///< Scratch buffer for one voice's envelope block
+        unsigned int tailFrames;            ///< Frames of effect tail left to render after the last voice
+        bool tailPending;                   ///< Voices played since the tail was last measured
+        bool sounding;                      ///< Voices are active in the current block
+    };
+
+    /**
+     * @brief Updates a part's tail state and tells whether it must be rendered this block
+     */
+    bool preparePart(unsigned int slot);
+
+    /**
+     * @brief Part of the fading chain that crossfades into @p part, or nullptr
+     */
+    const SignalChain* getFadingPart(unsigned int slot, const SignalChain& part) const;
+
+    /**
+     * @brief Renders one part's voices and effects into its slot buffers
+     * @param workers Pool to spread the voices over, or nullptr to render them here
+     */
+    void renderPart(unsigned int slot, unsigned int numFrames, VoiceWorkerPool* workers);
+
+    /**
+     * @brief VoiceWorkerPool task rendering the @p item-th part of the block
+     */
+    static void renderPartTask(void* context, unsigned int item, unsigned int participant);
+
+    /**
+     * @brief Blends the outgoing part's output (in the fade buffers) into the part's output
+     */
+    void mixCrossfade(PartRender& state, unsigned int numFrames) const;
+
+    /**
+     * @brief Moves the crossfade on by a chunk and ends it when complete (audio thread only)
+     */
+    void advanceCrossfade(unsigned int numFrames);
+
+    /**
+     * @brief Releases the voices of channels whose part changed with a new chain
+     *
+     * Held voices left behind in a pool that keeps rendering would otherwise
+     * never see their note-off.
+     */
+    static void releaseMovedChannels(SignalChain& previous, SignalChain& next);
+
+    /**
+     * @brief Applies all pending control commands (audio thread only)
+     */
+    void processCommands();
+
+    /**
+     * @brief Starts a voice and informs the effects of the new note (audio thread only)
+     */
+    void handleNoteOn(unsigned char note, unsigned char channel, float frequency, float velocity);
+
+    /**
+     * @brief Releases a voice and informs the effects (audio thread only)
+     */
+    void handleNoteOff(unsigned char note, unsigned char channel);
+
+    /**
+     * @brief Forwards a note event to every effect of a part (audio thread only)
+     */
+    static void notifyEffects(SignalChain& part, const NoteEvent& event);
+
+    /**
+     * @brief Queues a command, counting it as dropped if the queue is full
+     */
+    bool pushCommand(const AudioCommand& command);
+
+    /**
+     * @brief Builds a single effect parameter change
+     */
+    static AudioCommand effectParameter(unsigned int generation, size_t slot, unsigned int parameterId, float value);
+
+    /**
+     * @brief Sums the active voices of a part into its left buffer
+     * @param workers Pool to spread the voices over, or nullptr to render them here
+     */
+    void renderVoices(SignalChain& part, PartRender& state, unsigned int numFrames, VoiceWorkerPool* workers);
+
+    /**
+     * @brief Runs the mixed block through the active master bus and updates the meters
+     */
+    void processMaster(float* left, float* right, unsigned int numFrames);
+
+    static constexpr unsigned int kPartSlots = 17;    ///< Main part plus one part per MIDI channel
+
     float m_sampleRate;                               ///< Audio sample rate in Hz
-    float m_phase;                                    ///< Current phase of the oscillator (0.0 to 1.0)
-    bool m_noteOn;                                    ///< Flag indicating whether a note is currently playing
-    std::vector<std::shared_ptr<IEffect>> m_effects;  ///< Chain of audio effects to apply
-    std::shared_ptr<IWave> m_waveform;                ///< Waveform generator
+    std::atomic<unsigned int> m_activeVoiceCount;     ///< Voice count published for other threads
+    std::atomic<unsigned int> m_latencyFrames;        ///< Latency of the published chain, for other threads
+    std::atomic<float> m_compressorReduction;         ///< Master compressor metering, for other threads
+    std::atomic<float> m_limiterReduction;            ///< Master limiter metering, for other threads
+    MpscQueue<AudioCommand, kCommandQueueSize> m_commands;  ///< Control-to-audio command queue
+    std::atomic<unsigned long long> m_droppedCommands;      ///< Commands the full queue turned away
+
+    // Audio thread state
+    SignalChain* m_activeChain;                       ///< Chain being rendered (never null)
+    SignalChain* m_fadingChain;                       ///< Chain being faded out, or nullptr
+    unsigned int m_fadePosition;                      ///< Frames of the current crossfade already rendered
+    std::vector<PartRender> m_parts;                  ///< State of each part slot
+    unsigned int m_renderSlots[kPartSlots];           ///< Slots rendered in the current block
+    unsigned int m_renderFrames;                      ///< Frames of the chunk the part tasks render
+
+    // Hand-over between control threads and the audio thread
+    std::atomic<SignalChain*> m_pendingChain;         ///< Published chain not yet adopted, or nullptr
+    MpscQueue<SignalChain*, 16> m_retiredChains;      ///< Chains the audio thread is done with
+    std::atomic<unsigned int> m_retiredCount;         ///< Chains pushed to m_retiredChains and not yet freed
+
+    // Control side, guarded by m_controlMutex (never locked by the audio thread)
+    std::mutex m_controlMutex;                        ///< Serializes chain builders and the garbage collector
+    SignalChain* m_publishedChain;                    ///< Newest chain handed out (active or pending)
+    AudioConfig m_voiceConfig;                        ///< Settings the published voice pool was built from
+    AudioConfig m_masterConfig;                       ///< Settings the published master bus was built from
+    std::vector<AudioPartConfig> m_partConfigs;       ///< Parts the published chain was built from
+    unsigned int m_chainGeneration;                   ///< Generation of m_publishedChain
 };
@@ -0,0 +1,65 @@
+#include "BlockLfo.h"
+#include <algorithm>
+#include <cmath>
+
+BlockLfo::BlockLfo(float rate)
+    : m_sampleRate(44100.0f), m_rate(0.5f), m_cos(1.0f), m_sin(0.0f), m_rotCos(1.0f), m_rotSin(0.0f)
+{
+    setRate(rate);
+}
+
+void BlockLfo::prepare(float sampleRate, unsigned int maxBlockFrames)
+{
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+    }
+    m_sine.assign(maxBlockFrames, 0.0f);
+    m_cosine.assign(maxBlockFrames, 1.0f);
+    updateRotation();
+    reset();
+}
+
+void BlockLfo::generate(unsigned int numFrames)
+{
+    numFrames = std::min(numFrames, getMaxBlockFrames());
+    float* sine = m_sine.data();
+    float* cosine = m_cosine.data();
+    const float rotCos = m_rotCos;
+    const float rotSin = m_rotSin;
+    float c = m_cos;
+    float s = m_sin;
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        sine[i] = s;
+        cosine[i] = c;
+        const float nextC = c * rotCos - s * rotSin;
+        s = s * rotCos + c * rotSin;
+        c = nextC;
+    }
+
+    // Keep the phasor on the unit circle despite rounding
+    const float norm = 1.0f / std::sqrt(c * c + s * s);
+    m_cos = c * norm;
+    m_sin = s * norm;
+}
+
+void BlockLfo::reset()
+{
+    m_cos = 1.0f;
+    m_sin = 0.0f;
+}
+
+void BlockLfo::setRate(float rate)
+{
+    m_rate = std::min(std::max(rate, 0.01f), 20.0f);
+    updateRotation();
+}
+
+void BlockLfo::updateRotation()
+{
+    const double pi = std::acos(-1.0);
+    const double omega = 2.0 * pi * m_rate / m_sampleRate;
+    m_rotCos = static_cast<float>(std::cos(omega));
+    m_rotSin = static_cast<float>(std::sin(omega));
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @file BlockLfo.h
+ * @brief Sine/cosine LFO rendered a block at a time
+ */
+
+/**
+ * @class BlockLfo
+ * @brief Quadrature low-frequency oscillator that fills whole blocks
+ *
+ * generate() writes a block of sine and cosine values by rotating a unit
+ * phasor once per sample (two multiplies and adds per output, no sin()
+ * calls); the phasor is renormalized once per block. The cosine output is
+ * the same LFO a quarter period ahead, which modulated effects use for a
+ * wide stereo image, and any other phase offset is a weighted sum of the two.
+ *
+ * Several effects can read the buffers of one BlockLfo: SignalChain owns a
+ * shared instance, generates it once per block before running the effects,
+ * and the modulated effects sweep in sync.
+ */
+class BlockLfo
+{
+public:
+    /**
+     * @brief Construct an LFO; call prepare() before generate()
+     * @param rate Frequency in Hz [0.01 - 20]
+     */
+    explicit BlockLfo(float rate = 0.5f);
+
+    /**
+     * @brief Size the buffers and set the sample rate (allocates, control thread only)
+     * @param sampleRate     Sampling rate of the audio system
+     * @param maxBlockFrames Largest block passed to generate()
+     */
+    void prepare(float sampleRate, unsigned int maxBlockFrames);
+
+    /**
+     * @brief Render the next numFrames values into getSine() and getCosine()
+     * @param numFrames Frames to render, at most getMaxBlockFrames()
+     */
+    void generate(unsigned int numFrames);
+
+    /** Restart at phase zero */
+    void reset();
+
+    /// Set the frequency in Hz [0.01 - 20]
+    void setRate(float rate);
+    /// Frequency in Hz
+    float getRate() const { return m_rate; }
+
+    /// Sine values of the last generated block [-1, 1]
+    const float* getSine() const { return m_sine.data(); }
+    /// Cosine values of the last generated block [-1, 1]
+    const float* getCosine() const { return m_cosine.data(); }
+    /// Capacity of the block buffers (0 until prepared)
+    unsigned int getMaxBlockFrames() const { return static_cast<unsigned int>(m_sine.size()); }
+
+private:
+    float m_sampleRate;             ///< Current sampling rate
+    float m_rate;                   ///< Frequency in Hz
+    float m_cos;                    ///< Phasor real part
+    float m_sin;                    ///< Phasor imaginary part
+    float m_rotCos;                 ///< Per-sample rotation
+    float m_rotSin;
+    std::vector<float> m_sine;      ///< Last block, sine
+    std::vector<float> m_cosine;    ///< Last block, cosine
+
+    /** Recompute the per-sample rotation */
+    void updateRotation();
+};
@@ -0,0 +1,86 @@
+#include "FFT.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// -----------------------------------------------------------------------------
+// FFT implementation
+// -----------------------------------------------------------------------------
+
+FFT::FFT(unsigned int size) : m_size(size)
+{
+    if (size < 2 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("FFT size must be a power of two: " + std::to_string(size));
+    }
+
+    unsigned int bits = 0;
+    while ((1u << bits) < size) {
+        ++bits;
+    }
+
+    m_bitReversed.resize(size);
+    for (unsigned int i = 0; i < size; ++i) {
+        unsigned int reversed = 0;
+        for (unsigned int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        m_bitReversed[i] = reversed;
+    }
+
+    // Computed in double so large transforms keep full float accuracy
+    const double pi = std::acos(-1.0);
+    m_twiddles.resize(size / 2);
+    for (unsigned int k = 0; k < size / 2; ++k) {
+        double angle = -2.0 * pi * k / size;
+        m_twiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)),
+                                            static_cast<float>(std::sin(angle)));
+    }
+}
+
+void FFT::forward(std::complex<float>* data) const
+{
+    transform(data, false);
+}
+
+void FFT::inverse(std::complex<float>* data) const
+{
+    transform(data, true);
+}
+
+void FFT::transform(std::complex<float>* data, bool conjugate) const
+{
+    for (unsigned int i = 0; i < m_size; ++i) {
+        unsigned int j = m_bitReversed[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    const float sign = conjugate ? -1.0f : 1.0f;
+
+    for (unsigned int length = 2; length <= m_size; length <<= 1)
+    {
+        const unsigned int half = length / 2;
+        const unsigned int stride = m_size / length;
+
+        for (unsigned int start = 0; start < m_size; start += length)
+        {
+            for (unsigned int k = 0; k < half; ++k)
+            {
+                // Explicit complex multiply; std::complex's operator* adds
+                // NaN/Inf recovery that the compiler cannot drop by default
+                const std::complex<float>& w = m_twiddles[k * stride];
+                const float wr = w.real();
+                const float wi = sign * w.imag();
+                const std::complex<float> odd = data[start + k + half];
+                const float tr = odd.real() * wr - odd.imag() * wi;
+                const float ti = odd.real() * wi + odd.imag() * wr;
+
+                const std::complex<float> even = data[start + k];
+                data[start + k] = std::complex<float>(even.real() + tr, even.imag() + ti);
+                data[start + k + half] = std::complex<float>(even.real() - tr, even.imag() - ti);
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+/**
+ * @file FFT.h
+ * @brief Radix-2 complex FFT with precomputed tables
+ */
+
+/**
+ * @class FFT
+ * @brief In-place complex FFT of a fixed power-of-two size
+ *
+ * The twiddle factors and bit-reversal permutation are computed once in the
+ * constructor; transform() itself neither allocates nor calls trigonometric
+ * functions, so it can run on the audio thread.
+ */
+class FFT
+{
+public:
+    /**
+     * @brief Prepare tables for a transform size
+     * @param size Number of points, a power of two >= 2
+     * @throws std::invalid_argument if size is not a power of two
+     */
+    explicit FFT(unsigned int size);
+
+    /**
+     * @brief Forward transform in place (no scaling)
+     * @param data size() complex values
+     */
+    void forward(std::complex<float>* data) const;
+
+    /**
+     * @brief Inverse transform in place (no 1/N scaling)
+     * @param data size() complex values
+     */
+    void inverse(std::complex<float>* data) const;
+
+    /**
+     * @brief Number of points
+     */
+    unsigned int size() const { return m_size; }
+
+private:
+    /** Shared butterfly passes; @p conjugate selects the inverse twiddles */
+    void transform(std::complex<float>* data, bool conjugate) const;
+
+    unsigned int m_size;                        ///< Number of points
+    std::vector<unsigned int> m_bitReversed;    ///< Permutation applied before the passes
+    std::vector<std::complex<float>> m_twiddles;///< exp(-2*pi*i*k/size) for k < size/2
+};
@@ -0,0 +1,233 @@
+#include "HalfBandFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HALFBAND_HAS_SSE 1
+#include <emmintrin.h>
+// Let the SSE kernel be built even when the baseline target lacks SSE2
+#if defined(__GNUC__) && !defined(__SSE2__)
+#define HALFBAND_SSE_TARGET __attribute__((target("sse2")))
+#else
+#define HALFBAND_SSE_TARGET
+#endif
+#else
+#define HALFBAND_HAS_SSE 0
+#endif
+
+namespace {
+    /**
+     * @brief Zeroth-order modified Bessel function of the first kind (power series)
+     */
+    double besselI0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12) {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    constexpr unsigned int kChunk = 64;   ///< Low-rate samples filtered per pass over the history
+
+    /**
+     * @brief Portable dot product; length is a multiple of 4
+     */
+    inline float dotScalar(const float* a, const float* b, unsigned int length) {
+        float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+        for (unsigned int i = 0; i < length; i += 4) {
+            sum0 += a[i] * b[i];
+            sum1 += a[i + 1] * b[i + 1];
+            sum2 += a[i + 2] * b[i + 2];
+            sum3 += a[i + 3] * b[i + 3];
+        }
+        return (sum0 + sum2) + (sum1 + sum3);
+    }
+
+    /**
+     * @brief Upsampler over one chunk: history holds length - 1 old samples then the chunk
+     */
+    inline void upsampleScalar(const float* coefficients, const float* history, unsigned int length,
+                               unsigned int centre, float* output, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            const float* window = history + i;
+            output[2 * i] = dotScalar(coefficients, window, length);
+            output[2 * i + 1] = window[centre];
+        }
+    }
+
+    /**
+     * @brief Downsampler over one chunk of even/odd input pairs
+     */
+    inline void downsampleScalar(const float* coefficients, const float* even, const float* odd,
+                                 unsigned int length, unsigned int centre, float* output, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            output[i] = 0.5f * (dotScalar(coefficients, even + i, length) + odd[i + centre - 1]);
+        }
+    }
+
+#if HALFBAND_HAS_SSE
+    /**
+     * @brief SSE dot product; length is a multiple of 4
+     */
+    HALFBAND_SSE_TARGET
+    inline float dotSse(const float* a, const float* b, unsigned int length) {
+        __m128 sum = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+        for (unsigned int i = 4; i < length; i += 4) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        // Horizontal sum of the four lanes
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(sum);
+    }
+
+    HALFBAND_SSE_TARGET
+    void upsampleSse(const float* coefficients, const float* history, unsigned int length,
+                     unsigned int centre, float* output, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            const float* window = history + i;
+            output[2 * i] = dotSse(coefficients, window, length);
+            output[2 * i + 1] = window[centre];
+        }
+    }
+
+    HALFBAND_SSE_TARGET
+    void downsampleSse(const float* coefficients, const float* even, const float* odd,
+                       unsigned int length, unsigned int centre, float* output, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            output[i] = 0.5f * (dotSse(coefficients, even + i, length) + odd[i + centre - 1]);
+        }
+    }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// HalfBandFilter implementation
+// -----------------------------------------------------------------------------
+
+HalfBandFilter::HalfBandFilter(unsigned int taps, float beta)
+    : m_taps(taps), m_length(0), m_centre(0), m_useSimd(isSimdAvailable())
+{
+    if (taps < 3 || taps % 4 != 3) {
+        throw std::invalid_argument("Half-band filter length must be 4 * m + 3: " + std::to_string(taps));
+    }
+
+    // Non-zero taps sit at the even indices 0, 2, ..., taps - 1; the centre
+    // (taps - 1) / 2 is odd and belongs to the pure-delay branch
+    const unsigned int branch = (taps + 1) / 2;
+    const unsigned int centre = (taps - 1) / 2;
+    m_length = (branch + 3) & ~3u;
+    m_centre = m_length - 1 - (centre - 1) / 2;
+
+    // Kaiser-windowed sinc with its cutoff at a quarter of the high rate
+    const double pi = std::acos(-1.0);
+    std::vector<double> side(branch);
+    double sum = 0.0;
+    for (unsigned int k = 0; k < branch; ++k) {
+        double offset = static_cast<double>(2 * k) - centre;
+        double sinc = std::sin(0.5 * pi * offset) / (pi * offset);
+        double ratio = offset / centre;
+        double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / besselI0(beta);
+        side[k] = sinc * window;
+        sum += side[k];
+    }
+
+    // The branch sums to 0.5 for unity DC gain; store it doubled so the
+    // upsampler's zero-stuffing gain of 2 is folded in
+    m_coefficients.assign(m_length, 0.0f);
+    for (unsigned int k = 0; k < branch; ++k) {
+        m_coefficients[m_length - 1 - k] = static_cast<float>(side[k] / sum);
+    }
+
+    m_upHistory.assign(m_length - 1 + kChunk, 0.0f);
+    m_downEven.assign(m_length - 1 + kChunk, 0.0f);
+    m_downOdd.assign(m_length - 1 + kChunk, 0.0f);
+}
+
+void HalfBandFilter::upsample(const float* input, float* output, unsigned int numFrames)
+{
+    const unsigned int keep = m_length - 1;
+    float* history = m_upHistory.data();
+
+    while (numFrames > 0)
+    {
+        const unsigned int count = std::min(numFrames, kChunk);
+        std::copy(input, input + count, history + keep);
+
+#if HALFBAND_HAS_SSE
+        if (m_useSimd) {
+            upsampleSse(m_coefficients.data(), history, m_length, m_centre, output, count);
+        } else {
+            upsampleScalar(m_coefficients.data(), history, m_length, m_centre, output, count);
+        }
+#else
+        upsampleScalar(m_coefficients.data(), history, m_length, m_centre, output, count);
+#endif
+
+        // Slide the newest samples to the front for the next chunk
+        std::copy(history + count, history + count + keep, history);
+        input += count;
+        output += 2 * count;
+        numFrames -= count;
+    }
+}
+
+void HalfBandFilter::downsample(const float* input, float* output, unsigned int numFrames)
+{
+    const unsigned int keep = m_length - 1;
+    float* even = m_downEven.data();
+    float* odd = m_downOdd.data();
+
+    while (numFrames > 0)
+    {
+        const unsigned int count = std::min(numFrames, kChunk);
+        for (unsigned int i = 0; i < count; ++i) {
+            even[keep + i] = input[2 * i];
+            odd[keep + i] = input[2 * i + 1];
+        }
+
+        // The odd branch lags the even one by half a low-rate sample, hence
+        // it is read one slot older than the upsampler's delay tap
+#if HALFBAND_HAS_SSE
+        if (m_useSimd) {
+            downsampleSse(m_coefficients.data(), even, odd, m_length, m_centre, output, count);
+        } else {
+            downsampleScalar(m_coefficients.data(), even, odd, m_length, m_centre, output, count);
+        }
+#else
+        downsampleScalar(m_coefficients.data(), even, odd, m_length, m_centre, output, count);
+#endif
+
+        std::copy(even + count, even + count + keep, even);
+        std::copy(odd + count, odd + count + keep, odd);
+        input += 2 * count;
+        output += count;
+        numFrames -= count;
+    }
+}
+
+void HalfBandFilter::reset()
+{
+    std::fill(m_upHistory.begin(), m_upHistory.end(), 0.0f);
+    std::fill(m_downEven.begin(), m_downEven.end(), 0.0f);
+    std::fill(m_downOdd.begin(), m_downOdd.end(), 0.0f);
+}
+
+bool HalfBandFilter::isSimdAvailable()
+{
+#if HALFBAND_HAS_SSE && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#elif HALFBAND_HAS_SSE
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @file HalfBandFilter.h
+ * @brief Polyphase half-band FIR for 2x interpolation and decimation
+ */
+
+/**
+ * @class HalfBandFilter
+ * @brief One channel of a 2x up/down sampling stage
+ *
+ * A linear-phase half-band lowpass (cutoff at a quarter of the high rate)
+ * has every other tap equal to zero except the centre tap, which is 0.5.
+ * Split into its two polyphase branches, one branch is a pure delay and the
+ * other holds the (taps + 1) / 2 non-zero coefficients, so a 2x stage costs
+ * one short dot product per low-rate sample in each direction. The dot
+ * products run on SSE when the CPU supports it.
+ *
+ * The upsampler and downsampler keep independent histories, so one object
+ * serves both directions of a stage. Input is copied behind the history in
+ * chunks, so every dot product reads one contiguous window. All buffers are
+ * allocated in the constructor.
+ */
+class HalfBandFilter
+{
+public:
+    /**
+     * @brief Design the filter with a Kaiser-windowed sinc
+     * @param taps Filter length, of the form 4 * m + 3 so the outermost taps are non-zero
+     * @param beta Kaiser window shape; higher trades transition width for stopband attenuation
+     * @throws std::invalid_argument if taps is not of the form 4 * m + 3
+     */
+    HalfBandFilter(unsigned int taps, float beta);
+
+    /**
+     * @brief Interpolate by two
+     * @param input numFrames low-rate samples
+     * @param output Receives 2 * numFrames high-rate samples
+     */
+    void upsample(const float* input, float* output, unsigned int numFrames);
+
+    /**
+     * @brief Lowpass and decimate by two
+     * @param input 2 * numFrames high-rate samples
+     * @param output Receives numFrames low-rate samples
+     */
+    void downsample(const float* input, float* output, unsigned int numFrames);
+
+    /** Clear both histories */
+    void reset();
+
+    /** Filter length in high-rate samples */
+    unsigned int getTaps() const { return m_taps; }
+
+    /** Delay of one direction in high-rate samples ((taps - 1) / 2) */
+    unsigned int getDelay() const { return (m_taps - 1) / 2; }
+
+    /** True if this build and CPU can run the SSE dot product */
+    static bool isSimdAvailable();
+
+private:
+    unsigned int m_taps;                 ///< Full filter length (N)
+    unsigned int m_length;               ///< Polyphase branch length, padded to a multiple of 4
+    unsigned int m_centre;               ///< Window index of the pure-delay branch sample
+    bool m_useSimd;                      ///< Use the SSE dot product
+
+    std::vector<float> m_coefficients;   ///< Non-zero taps, oldest sample first (zero padded at the front)
+    std::vector<float> m_upHistory;      ///< Last m_length - 1 low-rate inputs followed by the current chunk
+    std::vector<float> m_downEven;       ///< Same layout for the even high-rate inputs
+    std::vector<float> m_downOdd;        ///< Same layout for the odd high-rate inputs
+};
@@ -0,0 +1,20 @@
+#include "ModulatedDelayLine.h"
+#include <algorithm>
+
+void ModulatedDelayLine::prepare(unsigned int maxDelaySamples)
+{
+    // One extra sample for the interpolation partner of the longest delay
+    unsigned int size = 1;
+    while (size < maxDelaySamples + 2) {
+        size <<= 1;
+    }
+    m_buffer.assign(size, 0.0f);
+    m_mask = size - 1;
+    m_index = 0;
+}
+
+void ModulatedDelayLine::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0f);
+    m_index = 0;
+}
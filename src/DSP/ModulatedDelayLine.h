@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @file ModulatedDelayLine.h
+ * @brief Mono delay line with a fractional, per-sample read position
+ */
+
+/**
+ * @class ModulatedDelayLine
+ * @brief Power-of-two ring buffer read with linear interpolation
+ *
+ * The building block of chorus and flanger: the read position moves every
+ * sample, so reads are fractional. read() and write() are inline and never
+ * allocate; only prepare() sizes the ring.
+ */
+class ModulatedDelayLine
+{
+public:
+    ModulatedDelayLine() : m_mask(0), m_index(0) {}
+
+    /**
+     * @brief Size the ring (allocates, control thread only)
+     * @param maxDelaySamples Longest delay read() will be asked for
+     */
+    void prepare(unsigned int maxDelaySamples);
+
+    /** Clear the line */
+    void reset();
+
+    /** Append one sample */
+    void write(float sample)
+    {
+        m_buffer[m_index] = sample;
+        m_index = (m_index + 1) & m_mask;
+    }
+
+    /**
+     * @brief Sample from delay samples ago (1 is the last one written)
+     * @param delay Fractional delay in samples [1, maxDelaySamples]
+     */
+    float read(float delay) const
+    {
+        const unsigned int whole = static_cast<unsigned int>(delay);
+        const float fraction = delay - static_cast<float>(whole);
+        const unsigned int newer = (m_index - whole) & m_mask;
+        const unsigned int older = (newer - 1) & m_mask;
+        return m_buffer[newer] + fraction * (m_buffer[older] - m_buffer[newer]);
+    }
+
+private:
+    std::vector<float> m_buffer;    ///< Ring of past samples
+    unsigned int m_mask;            ///< Ring size - 1
+    unsigned int m_index;           ///< Next write position
+};
@@ -0,0 +1,132 @@
+#include "Oversampler.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // Innermost stage: passband to 0.4 of the base rate (19.2 kHz at 48 kHz)
+    // with ~80 dB rejection from 0.6, for 25 frames of round-trip delay
+    constexpr unsigned int kInnerTaps = 51;
+    // Outer stages only separate the audio band from images near the upper
+    // rates, which leaves a wide transition band for a short filter
+    constexpr unsigned int kOuterTaps = 23;
+    constexpr float kKaiserBeta = 7.86f;   ///< ~80 dB stopband
+}
+
+// -----------------------------------------------------------------------------
+// Oversampler implementation
+// -----------------------------------------------------------------------------
+
+Oversampler::Oversampler(unsigned int factor)
+    : m_factor(factor), m_maxBlockFrames(0), m_latency(0), m_padPosition(0)
+{
+    if (factor != 1 && factor != 2 && factor != 4 && factor != 8) {
+        throw std::invalid_argument("Oversampling factor must be 1, 2, 4 or 8: " + std::to_string(factor));
+    }
+
+    // Round-trip delay in top-rate samples: each stage delays by taps - 1
+    // samples of its own high rate
+    unsigned int delay = 0;
+    unsigned int rate = 2;
+    while (rate <= factor) {
+        unsigned int taps = m_stagesLeft.empty() ? kInnerTaps : kOuterTaps;
+        m_stagesLeft.emplace_back(taps, kKaiserBeta);
+        m_stagesRight.emplace_back(taps, kKaiserBeta);
+        delay += (taps - 1) * (factor / rate);
+        rate *= 2;
+    }
+
+    unsigned int pad = (factor - delay % factor) % factor;
+    m_padLeft.assign(pad, 0.0f);
+    m_padRight.assign(pad, 0.0f);
+    m_latency = (delay + pad) / factor;
+
+    // Without stages the single level is a plain copy at the base rate
+    const size_t levels = std::max<size_t>(1, m_stagesLeft.size());
+    m_levelLeft.resize(levels);
+    m_levelRight.resize(levels);
+}
+
+void Oversampler::prepare(unsigned int maxBlockFrames)
+{
+    m_maxBlockFrames = maxBlockFrames;
+    unsigned int rate = m_stagesLeft.empty() ? 1 : 2;
+    for (size_t level = 0; level < m_levelLeft.size(); ++level) {
+        m_levelLeft[level].assign(static_cast<size_t>(maxBlockFrames) * rate, 0.0f);
+        m_levelRight[level].assign(static_cast<size_t>(maxBlockFrames) * rate, 0.0f);
+        rate *= 2;
+    }
+    reset();
+}
+
+void Oversampler::upsample(const float* left, const float* right, unsigned int numFrames)
+{
+    if (m_stagesLeft.empty()) {
+        std::copy(left, left + numFrames, m_levelLeft[0].begin());
+        std::copy(right, right + numFrames, m_levelRight[0].begin());
+        return;
+    }
+
+    m_stagesLeft[0].upsample(left, m_levelLeft[0].data(), numFrames);
+    m_stagesRight[0].upsample(right, m_levelRight[0].data(), numFrames);
+
+    unsigned int frames = 2 * numFrames;
+    for (size_t stage = 1; stage < m_stagesLeft.size(); ++stage) {
+        m_stagesLeft[stage].upsample(m_levelLeft[stage - 1].data(), m_levelLeft[stage].data(), frames);
+        m_stagesRight[stage].upsample(m_levelRight[stage - 1].data(), m_levelRight[stage].data(), frames);
+        frames *= 2;
+    }
+
+    applyPad(frames);
+}
+
+void Oversampler::downsample(float* left, float* right, unsigned int numFrames)
+{
+    if (m_stagesLeft.empty()) {
+        std::copy(m_levelLeft[0].begin(), m_levelLeft[0].begin() + numFrames, left);
+        std::copy(m_levelRight[0].begin(), m_levelRight[0].begin() + numFrames, right);
+        return;
+    }
+
+    // Walk back down; each stage writes into the buffer of the rate below
+    unsigned int frames = numFrames * (m_factor / 2);
+    for (size_t stage = m_stagesLeft.size() - 1; stage > 0; --stage) {
+        m_stagesLeft[stage].downsample(m_levelLeft[stage].data(), m_levelLeft[stage - 1].data(), frames);
+        m_stagesRight[stage].downsample(m_levelRight[stage].data(), m_levelRight[stage - 1].data(), frames);
+        frames /= 2;
+    }
+
+    m_stagesLeft[0].downsample(m_levelLeft[0].data(), left, numFrames);
+    m_stagesRight[0].downsample(m_levelRight[0].data(), right, numFrames);
+}
+
+void Oversampler::reset()
+{
+    for (auto& stage : m_stagesLeft) {
+        stage.reset();
+    }
+    for (auto& stage : m_stagesRight) {
+        stage.reset();
+    }
+    std::fill(m_padLeft.begin(), m_padLeft.end(), 0.0f);
+    std::fill(m_padRight.begin(), m_padRight.end(), 0.0f);
+    m_padPosition = 0;
+}
+
+void Oversampler::applyPad(unsigned int samples)
+{
+    const unsigned int pad = static_cast<unsigned int>(m_padLeft.size());
+    if (pad == 0) {
+        return;
+    }
+
+    float* left = m_levelLeft.back().data();
+    float* right = m_levelRight.back().data();
+    unsigned int position = m_padPosition;
+    for (unsigned int i = 0; i < samples; ++i) {
+        std::swap(left[i], m_padLeft[position]);
+        std::swap(right[i], m_padRight[position]);
+        position = position + 1 < pad ? position + 1 : 0;
+    }
+    m_padPosition = position;
+}
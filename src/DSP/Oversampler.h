@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "HalfBandFilter.h"
+
+/**
+ * @file Oversampler.h
+ * @brief Stereo 2x/4x/8x resampling through cascaded half-band stages
+ */
+
+/**
+ * @class Oversampler
+ * @brief Moves stereo blocks to a multiple of the sample rate and back
+ *
+ * Each factor of two is one HalfBandFilter stage. The innermost stage (next
+ * to the base rate) sets the audible passband and gets the long filter; the
+ * outer stages only have to reject images far above the audio band and use
+ * short ones. The round-trip delay is padded at the top rate to a whole
+ * number of base-rate frames, reported by getLatency().
+ *
+ * Usage per block: upsample(), process getLeft()/getRight() at the high rate
+ * (numFrames * getFactor() samples), then downsample().
+ */
+class Oversampler
+{
+public:
+    /**
+     * @brief Create the stages for a factor
+     * @param factor 1, 2, 4 or 8
+     * @throws std::invalid_argument for any other factor
+     */
+    explicit Oversampler(unsigned int factor);
+
+    /**
+     * @brief Allocate the intermediate buffers (allocates, control thread only)
+     * @param maxBlockFrames Largest base-rate block passed to upsample()
+     */
+    void prepare(unsigned int maxBlockFrames);
+
+    /** Interpolate numFrames base-rate frames into the high-rate buffers */
+    void upsample(const float* left, const float* right, unsigned int numFrames);
+    /** Decimate the high-rate buffers back into numFrames base-rate frames */
+    void downsample(float* left, float* right, unsigned int numFrames);
+    /** Clear all filter histories */
+    void reset();
+
+    /** High-rate left channel of the current block */
+    float* getLeft() { return m_levelLeft.back().data(); }
+    /** High-rate right channel of the current block */
+    float* getRight() { return m_levelRight.back().data(); }
+
+    /** Oversampling factor */
+    unsigned int getFactor() const { return m_factor; }
+    /** Largest block accepted by upsample() */
+    unsigned int getMaxBlockFrames() const { return m_maxBlockFrames; }
+    /** Round-trip delay in base-rate frames */
+    unsigned int getLatency() const { return m_latency; }
+
+private:
+    unsigned int m_factor;                          ///< Overall factor (1, 2, 4, 8)
+    unsigned int m_maxBlockFrames;                  ///< Base-rate capacity of the buffers
+    unsigned int m_latency;                         ///< Round-trip delay in base-rate frames
+    std::vector<HalfBandFilter> m_stagesLeft;       ///< One stage per factor of two, innermost first
+    std::vector<HalfBandFilter> m_stagesRight;
+    std::vector<std::vector<float>> m_levelLeft;    ///< Signal at each rate, index 0 is 2x
+    std::vector<std::vector<float>> m_levelRight;
+    std::vector<float> m_padLeft;                   ///< Top-rate delay that rounds the latency
+    std::vector<float> m_padRight;
+    unsigned int m_padPosition;                     ///< Ring position in the pad delay
+
+    /** Delay the top-rate buffers by the pad length */
+    void applyPad(unsigned int samples);
+};
@@ -0,0 +1,125 @@
+#include "PartitionedConvolver.h"
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+// PartitionedConvolver implementation
+// -----------------------------------------------------------------------------
+
+PartitionedConvolver::PartitionedConvolver(unsigned int blockSize, const float* irLeft,
+                                           const float* irRight, size_t irLength)
+    : m_blockSize(blockSize),
+      m_bins(blockSize + 1),
+      m_partitions(std::max<size_t>(1, (irLength + blockSize - 1) / blockSize)),
+      m_current(0),
+      m_fft(2 * blockSize)
+{
+    const size_t spectraSize = m_partitions * m_bins;
+    m_filterLeft.resize(spectraSize);
+    m_filterRight.resize(spectraSize);
+    m_inputLeft.assign(spectraSize, std::complex<float>());
+    m_inputRight.assign(spectraSize, std::complex<float>());
+    m_accumLeft.resize(m_bins);
+    m_accumRight.resize(m_bins);
+    m_historyLeft.assign(2 * blockSize, 0.0f);
+    m_historyRight.assign(2 * blockSize, 0.0f);
+    m_work.resize(2 * blockSize);
+
+    // Each partition is zero-padded to 2B points so the circular convolution
+    // of the overlap-save window leaves the second half alias-free
+    for (size_t p = 0; p < m_partitions; ++p)
+    {
+        std::fill(m_work.begin(), m_work.end(), std::complex<float>());
+        for (unsigned int i = 0; i < blockSize; ++i) {
+            size_t index = p * blockSize + i;
+            if (index < irLength) {
+                m_work[i] = std::complex<float>(irLeft[index], irRight[index]);
+            }
+        }
+        splitSpectra(&m_filterLeft[p * m_bins], &m_filterRight[p * m_bins]);
+    }
+}
+
+void PartitionedConvolver::process(const float* inLeft, const float* inRight, float* outLeft, float* outRight)
+{
+    const unsigned int size = 2 * m_blockSize;
+
+    // Slide the overlap-save window: previous block, then the new one
+    std::copy(m_historyLeft.begin() + m_blockSize, m_historyLeft.end(), m_historyLeft.begin());
+    std::copy(m_historyRight.begin() + m_blockSize, m_historyRight.end(), m_historyRight.begin());
+    std::copy(inLeft, inLeft + m_blockSize, m_historyLeft.begin() + m_blockSize);
+    std::copy(inRight, inRight + m_blockSize, m_historyRight.begin() + m_blockSize);
+
+    for (unsigned int i = 0; i < size; ++i) {
+        m_work[i] = std::complex<float>(m_historyLeft[i], m_historyRight[i]);
+    }
+    splitSpectra(&m_inputLeft[m_current * m_bins], &m_inputRight[m_current * m_bins]);
+
+    // Frequency-domain delay line: input spectrum j blocks old meets partition j
+    std::fill(m_accumLeft.begin(), m_accumLeft.end(), std::complex<float>());
+    std::fill(m_accumRight.begin(), m_accumRight.end(), std::complex<float>());
+
+    for (size_t p = 0; p < m_partitions; ++p)
+    {
+        const size_t slot = (m_current + m_partitions - p) % m_partitions;
+        const std::complex<float>* xl = &m_inputLeft[slot * m_bins];
+        const std::complex<float>* xr = &m_inputRight[slot * m_bins];
+        const std::complex<float>* hl = &m_filterLeft[p * m_bins];
+        const std::complex<float>* hr = &m_filterRight[p * m_bins];
+
+        for (unsigned int k = 0; k < m_bins; ++k)
+        {
+            m_accumLeft[k] += std::complex<float>(xl[k].real() * hl[k].real() - xl[k].imag() * hl[k].imag(),
+                                                  xl[k].real() * hl[k].imag() + xl[k].imag() * hl[k].real());
+            m_accumRight[k] += std::complex<float>(xr[k].real() * hr[k].real() - xr[k].imag() * hr[k].imag(),
+                                                   xr[k].real() * hr[k].imag() + xr[k].imag() * hr[k].real());
+        }
+    }
+
+    // Repack as the spectrum of (left + i*right); the upper half follows from
+    // the conjugate symmetry of the two real outputs
+    for (unsigned int k = 0; k < m_bins; ++k)
+    {
+        const std::complex<float> a = m_accumLeft[k];
+        const std::complex<float> b = m_accumRight[k];
+        m_work[k] = std::complex<float>(a.real() - b.imag(), a.imag() + b.real());
+        if (k > 0 && k < m_blockSize) {
+            m_work[size - k] = std::complex<float>(a.real() + b.imag(), b.real() - a.imag());
+        }
+    }
+    m_fft.inverse(m_work.data());
+
+    const float scale = 1.0f / static_cast<float>(size);
+    for (unsigned int i = 0; i < m_blockSize; ++i) {
+        outLeft[i] = m_work[m_blockSize + i].real() * scale;
+        outRight[i] = m_work[m_blockSize + i].imag() * scale;
+    }
+
+    m_current = (m_current + 1) % m_partitions;
+}
+
+void PartitionedConvolver::reset()
+{
+    std::fill(m_inputLeft.begin(), m_inputLeft.end(), std::complex<float>());
+    std::fill(m_inputRight.begin(), m_inputRight.end(), std::complex<float>());
+    std::fill(m_historyLeft.begin(), m_historyLeft.end(), 0.0f);
+    std::fill(m_historyRight.begin(), m_historyRight.end(), 0.0f);
+    m_current = 0;
+}
+
+void PartitionedConvolver::splitSpectra(std::complex<float>* left, std::complex<float>* right)
+{
+    m_fft.forward(m_work.data());
+
+    // For z = x + i*y with real x, y: X[k] = (Z[k] + conj(Z[-k])) / 2 and
+    // Y[k] = (Z[k] - conj(Z[-k])) / 2i
+    const unsigned int mask = 2 * m_blockSize - 1;
+    for (unsigned int k = 0; k < m_bins; ++k)
+    {
+        const std::complex<float> z = m_work[k];
+        const std::complex<float> mirror = std::conj(m_work[(2 * m_blockSize - k) & mask]);
+        const std::complex<float> sum = z + mirror;
+        const std::complex<float> difference = z - mirror;
+        left[k] = 0.5f * sum;
+        right[k] = std::complex<float>(0.5f * difference.imag(), -0.5f * difference.real());
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+#include <cstddef>
+#include "FFT.h"
+
+/**
+ * @file PartitionedConvolver.h
+ * @brief Uniformly partitioned overlap-save FFT convolution of a stereo signal
+ */
+
+/**
+ * @class PartitionedConvolver
+ * @brief Convolves stereo blocks with a stereo impulse response segment
+ *
+ * The impulse response is cut into partitions of blockSize samples whose
+ * spectra are computed once. Each call to process() takes exactly blockSize
+ * new input frames, transforms the last 2 * blockSize frames, multiplies the
+ * spectrum history against the partition spectra and returns blockSize
+ * output frames, so the cost per block is one forward and one inverse FFT
+ * of 2 * blockSize points plus one complex multiply-add per partition and bin,
+ * independent of the input.
+ *
+ * Left and right travel together as the real and imaginary parts of one
+ * complex FFT, which halves the transform work for stereo.
+ *
+ * All buffers are allocated in the constructor; process() and reset() do not
+ * allocate.
+ */
+class PartitionedConvolver
+{
+public:
+    /**
+     * @brief Precompute the partition spectra of an impulse response
+     * @param blockSize Frames per process() call, a power of two
+     * @param irLeft Left impulse response samples
+     * @param irRight Right impulse response samples
+     * @param irLength Number of samples in each impulse response
+     */
+    PartitionedConvolver(unsigned int blockSize, const float* irLeft, const float* irRight, size_t irLength);
+
+    /**
+     * @brief Convolve the next blockSize input frames
+     *
+     * Output frame i is the linear convolution at input frame i of this
+     * block, so the result has no latency beyond having to wait for the
+     * whole block.
+     */
+    void process(const float* inLeft, const float* inRight, float* outLeft, float* outRight);
+
+    /**
+     * @brief Clear the input history
+     */
+    void reset();
+
+    /// Frames per process() call
+    unsigned int getBlockSize() const { return m_blockSize; }
+    /// Number of impulse response partitions
+    size_t getPartitionCount() const { return m_partitions; }
+
+private:
+    unsigned int m_blockSize;   ///< Frames per block (B)
+    unsigned int m_bins;        ///< Non-redundant bins of a real 2B-point spectrum (B + 1)
+    size_t m_partitions;        ///< Impulse response partitions (P)
+    size_t m_current;           ///< Slot of the newest input spectrum
+    FFT m_fft;                  ///< 2B-point transform
+
+    std::vector<std::complex<float>> m_filterLeft;   ///< P x bins partition spectra
+    std::vector<std::complex<float>> m_filterRight;  ///< P x bins partition spectra
+    std::vector<std::complex<float>> m_inputLeft;    ///< P x bins input spectra, ring indexed by m_current
+    std::vector<std::complex<float>> m_inputRight;   ///< P x bins input spectra
+    std::vector<std::complex<float>> m_accumLeft;    ///< bins, left output spectrum
+    std::vector<std::complex<float>> m_accumRight;   ///< bins, right output spectrum
+    std::vector<float> m_historyLeft;                ///< Last 2B left input frames
+    std::vector<float> m_historyRight;               ///< Last 2B right input frames
+    std::vector<std::complex<float>> m_work;         ///< 2B-point transform buffer
+
+    /** Transform m_work (packed left + i*right) and split it into two real spectra */
+    void splitSpectra(std::complex<float>* left, std::complex<float>* right);
+};
@@ -0,0 +1,24 @@
+#include "SlidingWindowMax.h"
+#include <algorithm>
+
+void SlidingWindowMax::prepare(unsigned int windowLength)
+{
+    m_window = std::max(windowLength, 1u);
+
+    // A push briefly holds window + 1 entries before the front expires
+    unsigned int size = 1;
+    while (size < m_window + 1) {
+        size <<= 1;
+    }
+    m_mask = size - 1;
+    m_values.assign(size, 0.0f);
+    m_times.assign(size, 0);
+    reset();
+}
+
+void SlidingWindowMax::reset()
+{
+    m_head = 0;
+    m_tail = 0;
+    m_time = 0;
+}
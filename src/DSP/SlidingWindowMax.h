@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @file SlidingWindowMax.h
+ * @brief Running maximum over the last N values in amortized O(1)
+ */
+
+/**
+ * @class SlidingWindowMax
+ * @brief Monotonic-deque maximum of a fixed-length sliding window
+ *
+ * The deque holds only values that can still become the window maximum:
+ * they are stored in decreasing order, so a new value first drops every
+ * smaller one from the back and the front is always the current maximum.
+ * Each value is pushed and popped at most once, so a push costs O(1)
+ * amortized instead of a scan over the whole window.
+ *
+ * The deque lives in a power-of-two ring sized in prepare(); push() never
+ * allocates.
+ */
+class SlidingWindowMax
+{
+public:
+    SlidingWindowMax() : m_window(0), m_mask(0), m_head(0), m_tail(0), m_time(0) {}
+
+    /**
+     * @brief Size the ring for a window (allocates, control thread only)
+     * @param windowLength Number of most recent values the maximum covers (at least 1)
+     */
+    void prepare(unsigned int windowLength);
+
+    /** Forget every value */
+    void reset();
+
+    /**
+     * @brief Add a value and return the maximum of the last windowLength values
+     *
+     * Values older than the window count as absent, so right after reset()
+     * the result is the maximum of what has been pushed so far.
+     */
+    float push(float value)
+    {
+        // Drop the values this one outlives and outranks
+        while (m_tail != m_head && m_values[(m_tail - 1) & m_mask] <= value) {
+            --m_tail;
+        }
+        m_values[m_tail & m_mask] = value;
+        m_times[m_tail & m_mask] = m_time;
+        ++m_tail;
+
+        // Indices are unique and increasing, so at most the front expires
+        if (m_time - m_times[m_head & m_mask] >= m_window) {
+            ++m_head;
+        }
+        ++m_time;
+        return m_values[m_head & m_mask];
+    }
+
+    /** Window length in values */
+    unsigned int getWindowLength() const { return m_window; }
+
+private:
+    std::vector<float> m_values;        ///< Deque values, decreasing from head to tail
+    std::vector<unsigned int> m_times;  ///< Push index of each deque value
+    unsigned int m_window;              ///< Window length
+    unsigned int m_mask;                ///< Ring size - 1
+    unsigned int m_head;                ///< Front of the deque (free-running)
+    unsigned int m_tail;                ///< One past the back of the deque (free-running)
+    unsigned int m_time;                ///< Number of values pushed (free-running)
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file SmoothedParameter.h
+ * @brief Effect parameter that ramps to new values instead of jumping
+ */
+
+/// Shape of the ramp between two values
+enum class SmoothingType {
+    Linear,         ///< Constant step per sample (mix, feedback, gain in dB)
+    Exponential     ///< Constant ratio per sample, for strictly positive values (frequency, Q)
+};
+
+/**
+ * @class SmoothedParameter
+ * @brief Fixed-length ramp from the current value to the last target set
+ *
+ * setTargetValue() only stores the target in an atomic, so it may be called
+ * from any thread (GUI, MIDI or the audio thread's own command drain) while
+ * the audio thread renders. The audio thread picks the target up in
+ * isSmoothing(), which effects call once per block: while it returns false
+ * the value is constant and the effect can use its plain, unramped kernel;
+ * while it returns true, getBlock() renders the block's ramp values into an
+ * internal buffer (or getNextValue()/skip() step it per sample or per
+ * control period).
+ *
+ * A new target restarts the ramp from wherever the value currently is, so
+ * a slider being dragged never causes a jump. Until prepare() has been
+ * called the ramp length is zero and every change applies at once.
+ *
+ * @tparam T    float or double
+ * @tparam Type Linear or Exponential ramp
+ */
+template <typename T, SmoothingType Type = SmoothingType::Linear>
+class SmoothedParameter
+{
+    static_assert(std::is_floating_point<T>::value, "SmoothedParameter needs a floating-point type");
+
+public:
+    /**
+     * @brief Construct a parameter that starts at a value
+     * @param initialValue Current and target value
+     */
+    explicit SmoothedParameter(T initialValue = T(0))
+        : m_pending(sanitize(initialValue)), m_target(sanitize(initialValue)), m_current(m_target),
+          m_step(neutralStep()), m_rampFrames(0), m_countdown(0)
+    {
+    }
+
+    /**
+     * @brief Set the ramp length and size the block buffer (allocates, control thread only)
+     * @param sampleRate     Rate the value is advanced at, in Hz
+     * @param rampSeconds    Time a change takes to complete
+     * @param maxBlockFrames Largest block passed to getBlock() (0 if it is never used)
+     */
+    void prepare(float sampleRate, float rampSeconds, unsigned int maxBlockFrames)
+    {
+        m_rampFrames = std::max(1u, static_cast<unsigned int>(rampSeconds * sampleRate + 0.5f));
+        m_buffer.assign(maxBlockFrames, m_target);
+        reset();
+    }
+
+    /** Set the value to ramp to; safe to call from any thread */
+    void setTargetValue(T value)
+    {
+        m_pending.store(sanitize(value), std::memory_order_relaxed);
+    }
+
+    /** Jump to a value without a ramp (audio thread, or before playback starts) */
+    void setCurrentAndTargetValue(T value)
+    {
+        m_pending.store(sanitize(value), std::memory_order_relaxed);
+        reset();
+    }
+
+    /** Finish any ramp at once: the value becomes the last target set */
+    void reset()
+    {
+        m_target = m_pending.load(std::memory_order_relaxed);
+        m_current = m_target;
+        m_step = neutralStep();
+        m_countdown = 0;
+    }
+
+    /**
+     * @brief Pick up a new target and report whether the value is moving
+     *
+     * Audio thread. Costs one relaxed atomic load and a compare when the
+     * parameter is stable. Also true once when an unprepared parameter
+     * jumps, so effects that cache derived values see every change.
+     */
+    bool isSmoothing()
+    {
+        const T pending = m_pending.load(std::memory_order_relaxed);
+        if (pending != m_target) {
+            startRamp(pending);
+            return true;
+        }
+        return m_countdown > 0;
+    }
+
+    /** Advance one sample and return the new value (audio thread) */
+    T getNextValue()
+    {
+        if (m_countdown == 0) {
+            return m_target;
+        }
+        advance();
+        return m_current;
+    }
+
+    /** Advance several samples without producing values (audio thread) */
+    void skip(unsigned int numFrames)
+    {
+        if (numFrames >= m_countdown) {
+            m_current = m_target;
+            m_countdown = 0;
+            return;
+        }
+        m_countdown -= numFrames;
+        if (Type == SmoothingType::Linear) {
+            m_current += m_step * static_cast<T>(numFrames);
+        } else {
+            m_current *= std::pow(m_step, static_cast<T>(numFrames));
+        }
+    }
+
+    /**
+     * @brief Render the next values of the ramp (audio thread)
+     * @param numFrames Values to render, at most getMaxBlockFrames()
+     * @return Buffer holding numFrames values, valid until the next call
+     */
+    const T* getBlock(unsigned int numFrames)
+    {
+        T* out = m_buffer.data();
+        numFrames = std::min(numFrames, static_cast<unsigned int>(m_buffer.size()));
+        const unsigned int ramp = std::min(numFrames, m_countdown);
+        for (unsigned int i = 0; i < ramp; ++i) {
+            advance();
+            out[i] = m_current;
+        }
+        std::fill(out + ramp, out + numFrames, m_target);
+        return out;
+    }
+
+    /// Value of the last sample rendered
+    T getCurrentValue() const { return m_current; }
+    /// Last target set, possibly not yet picked up by the audio thread
+    T getTargetValue() const { return m_pending.load(std::memory_order_relaxed); }
+    /// Capacity of getBlock()
+    unsigned int getMaxBlockFrames() const { return static_cast<unsigned int>(m_buffer.size()); }
+
+private:
+    std::atomic<T> m_pending;   ///< Target written by the setters
+    T m_target;                 ///< Target of the current ramp
+    T m_current;                ///< Current value
+    T m_step;                   ///< Per-sample increment (Linear) or factor (Exponential)
+    unsigned int m_rampFrames;  ///< Ramp length in samples (0 until prepared)
+    unsigned int m_countdown;   ///< Samples left in the current ramp
+    std::vector<T> m_buffer;    ///< Values returned by getBlock()
+
+    static T neutralStep() { return Type == SmoothingType::Linear ? T(0) : T(1); }
+
+    /** Exponential ramps cannot pass through zero */
+    static T sanitize(T value)
+    {
+        return Type == SmoothingType::Linear ? value : std::max(value, std::numeric_limits<T>::min());
+    }
+
+    void startRamp(T target)
+    {
+        m_target = target;
+        if (m_rampFrames == 0) {
+            m_current = target;
+            m_countdown = 0;
+            return;
+        }
+        const T frames = static_cast<T>(m_rampFrames);
+        if (Type == SmoothingType::Linear) {
+            m_step = (target - m_current) / frames;
+        } else {
+            m_step = std::pow(target / m_current, T(1) / frames);
+        }
+        m_countdown = m_rampFrames;
+    }
+
+    void advance()
+    {
+        // The last step lands exactly on the target
+        if (--m_countdown == 0) {
+            m_current = m_target;
+        } else if (Type == SmoothingType::Linear) {
+            m_current += m_step;
+        } else {
+            m_current *= m_step;
+        }
+    }
+};
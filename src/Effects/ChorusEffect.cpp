@@ -0,0 +1,84 @@
+#include "ChorusEffect.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    constexpr float kBaseDelay = 0.015f;   ///< Centre of the sweep in seconds
+    constexpr float kMaxSweep = 0.006f;    ///< Sweep half-width at full depth in seconds
+}
+
+ChorusEffect::ChorusEffect(float rate, float depth, float mix, float sampleRate,
+                           std::shared_ptr<const BlockLfo> sharedLfo)
+    : ModulatedEffect(rate, std::move(sharedLfo)),
+      m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f), m_depth(0.5f), m_mix(0.5f)
+{
+    setDepth(depth);
+    setMix(mix);
+}
+
+void ChorusEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+    }
+    prepareLfo(m_sampleRate, maxBlockSize);
+    const unsigned int maxDelay = static_cast<unsigned int>((kBaseDelay + kMaxSweep) * m_sampleRate) + 1;
+    m_lineLeft.prepare(maxDelay);
+    m_lineRight.prepare(maxDelay);
+}
+
+void ChorusEffect::processModulated(float* left, float* right, unsigned int numFrames,
+                                    const float* sine, const float* cosine)
+{
+    const float base = kBaseDelay * m_sampleRate;
+    const float sweep = kMaxSweep * m_sampleRate * m_depth;
+    const float dry = 1.0f - m_mix;
+    const float wet = 0.5f * m_mix;   // Two taps per channel
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        m_lineLeft.write(left[i]);
+        m_lineRight.write(right[i]);
+
+        // Two taps per channel, swept in opposite directions
+        const float offsetLeft = sweep * sine[i];
+        const float offsetRight = sweep * cosine[i];
+        const float wetLeft = m_lineLeft.read(base + offsetLeft) + m_lineLeft.read(base - offsetLeft);
+        const float wetRight = m_lineRight.read(base + offsetRight) + m_lineRight.read(base - offsetRight);
+
+        left[i] = dry * left[i] + wet * wetLeft;
+        right[i] = dry * right[i] + wet * wetRight;
+    }
+}
+
+void ChorusEffect::reset()
+{
+    m_lineLeft.reset();
+    m_lineRight.reset();
+    resetLfo();
+}
+
+double ChorusEffect::getTailTime() const
+{
+    return static_cast<double>(kBaseDelay + kMaxSweep);
+}
+
+void ChorusEffect::setDepth(float depth)
+{
+    m_depth = std::min(std::max(depth, 0.0f), 1.0f);
+}
+
+void ChorusEffect::setMix(float mix)
+{
+    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+}
+
+void ChorusEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Rate:  setRate(value);  break;
+        case Depth: setDepth(value); break;
+        case Mix:   setMix(value);   break;
+        default: break;
+    }
+}
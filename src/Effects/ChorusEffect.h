@@ -0,0 +1,54 @@
+#pragma once
+#include "ModulatedEffect.h"
+#include "DSP/ModulatedDelayLine.h"
+
+/**
+ * @brief Stereo chorus
+ *
+ * Each channel is read from its delay line at two taps around 15 ms that
+ * the LFO sweeps in opposite directions, so the copies detune against the
+ * dry signal and against each other. The right channel follows the cosine
+ * of the LFO, a quarter period away from the left, which spreads the image.
+ */
+class ChorusEffect : public ModulatedEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Rate, Depth, Mix };
+
+    /**
+     * @brief Construct a ChorusEffect
+     * @param rate       LFO rate in Hz [0.01 - 20] (ignored with a shared LFO)
+     * @param depth      Sweep depth [0.0 - 1.0], up to +/-6 ms around the base delay
+     * @param mix        Blend between dry (0.0) and wet (1.0) signal
+     * @param sampleRate Sampling rate of the audio system
+     * @param sharedLfo  LFO generated by the chain, or nullptr for the effect's own
+     */
+    ChorusEffect(float rate = 0.8f, float depth = 0.5f, float mix = 0.5f, float sampleRate = 44100.0f,
+                 std::shared_ptr<const BlockLfo> sharedLfo = nullptr);
+
+    /** Size the delay lines for the sample rate */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Clear the delay lines */
+    void reset() override;
+    /** Longest delay of the sweep */
+    double getTailTime() const override;
+
+    /// Set the sweep depth [0.0 - 1.0]
+    void setDepth(float depth);
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+    /// Set a parameter by id (see ChorusEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+protected:
+    void processModulated(float* left, float* right, unsigned int numFrames,
+                          const float* sine, const float* cosine) override;
+
+private:
+    ModulatedDelayLine m_lineLeft;   ///< Left channel history
+    ModulatedDelayLine m_lineRight;  ///< Right channel history
+    float m_sampleRate;              ///< Current sampling rate
+    float m_depth;                   ///< Sweep depth
+    float m_mix;                     ///< Wet/dry mix
+};
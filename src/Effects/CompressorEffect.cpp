@@ -0,0 +1,168 @@
+#include "CompressorEffect.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float kMinLevel = 1e-6f;   ///< Detector floor (-120 dBFS), keeps log10 finite
+
+    float decibelsToGain(float decibels) {
+        return std::pow(10.0f, decibels / 20.0f);
+    }
+}
+
+constexpr unsigned int CompressorEffect::kControlFrames;
+
+CompressorEffect::CompressorEffect(float thresholdDb, float ratio, float attack, float release,
+                                   float kneeDb, float makeupDb, float sampleRate)
+    : m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f),
+      m_threshold(0.0f), m_ratio(1.0f), m_attack(0.01f), m_release(0.15f), m_knee(0.0f), m_makeup(0.0f),
+      m_attackCoefficient(0.0f), m_releaseCoefficient(0.0f),
+      m_reductionDb(0.0f), m_gain(1.0f), m_gainStep(0.0f), m_peak(0.0f), m_count(0)
+{
+    setThreshold(thresholdDb);
+    setRatio(ratio);
+    setKnee(kneeDb);
+    setMakeup(makeupDb);
+    setAttack(attack);
+    setRelease(release);
+    reset();
+}
+
+void CompressorEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    (void)maxBlockSize;
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+    }
+    updateCoefficients();
+    reset();
+}
+
+std::pair<float, float> CompressorEffect::process(std::pair<float, float> stereoSample)
+{
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void CompressorEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    while (numFrames > 0)
+    {
+        // Run to the end of the current sub-block
+        const unsigned int frames = std::min(numFrames, kControlFrames - m_count);
+        float gain = m_gain;
+        const float step = m_gainStep;
+        float peak = m_peak;
+
+        for (unsigned int i = 0; i < frames; ++i) {
+            peak = std::max(peak, std::max(std::fabs(left[i]), std::fabs(right[i])));
+            left[i] *= gain;
+            right[i] *= gain;
+            gain += step;
+        }
+
+        m_gain = gain;
+        m_peak = peak;
+        m_count += frames;
+        if (m_count == kControlFrames) {
+            updateGain();
+        }
+
+        left += frames;
+        right += frames;
+        numFrames -= frames;
+    }
+}
+
+void CompressorEffect::reset()
+{
+    m_reductionDb = 0.0f;
+    m_gain = decibelsToGain(m_makeup);
+    m_gainStep = 0.0f;
+    m_peak = 0.0f;
+    m_count = 0;
+}
+
+void CompressorEffect::updateGain()
+{
+    const float levelDb = 20.0f * std::log10(std::max(m_peak, kMinLevel));
+    const float target = computeGain(levelDb);
+
+    // Attack while the reduction deepens, release while it recovers
+    const float coefficient = target < m_reductionDb ? m_attackCoefficient : m_releaseCoefficient;
+    m_reductionDb = target + coefficient * (m_reductionDb - target);
+
+    const float nextGain = decibelsToGain(m_reductionDb + m_makeup);
+    m_gainStep = (nextGain - m_gain) / static_cast<float>(kControlFrames);
+    m_peak = 0.0f;
+    m_count = 0;
+}
+
+float CompressorEffect::computeGain(float levelDb) const
+{
+    const float over = levelDb - m_threshold;
+    const float slope = 1.0f / m_ratio - 1.0f;
+
+    if (2.0f * over <= -m_knee) {
+        return 0.0f;
+    }
+    if (2.0f * over < m_knee) {
+        // Quadratic blend between the two slopes inside the knee
+        const float x = over + 0.5f * m_knee;
+        return slope * x * x / (2.0f * m_knee);
+    }
+    return slope * over;
+}
+
+void CompressorEffect::updateCoefficients()
+{
+    // Time constants are per detector step, not per sample
+    const float stepRate = m_sampleRate / static_cast<float>(kControlFrames);
+    m_attackCoefficient = std::exp(-1.0f / (m_attack * stepRate));
+    m_releaseCoefficient = std::exp(-1.0f / (m_release * stepRate));
+}
+
+void CompressorEffect::setThreshold(float thresholdDb)
+{
+    m_threshold = std::min(std::max(thresholdDb, -60.0f), 0.0f);
+}
+
+void CompressorEffect::setRatio(float ratio)
+{
+    m_ratio = std::min(std::max(ratio, 1.0f), 20.0f);
+}
+
+void CompressorEffect::setAttack(float seconds)
+{
+    m_attack = std::min(std::max(seconds, 0.0001f), 1.0f);
+    updateCoefficients();
+}
+
+void CompressorEffect::setRelease(float seconds)
+{
+    m_release = std::min(std::max(seconds, 0.001f), 5.0f);
+    updateCoefficients();
+}
+
+void CompressorEffect::setKnee(float kneeDb)
+{
+    m_knee = std::min(std::max(kneeDb, 0.0f), 24.0f);
+}
+
+void CompressorEffect::setMakeup(float makeupDb)
+{
+    m_makeup = std::min(std::max(makeupDb, -12.0f), 24.0f);
+}
+
+void CompressorEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Threshold: setThreshold(value); break;
+        case Ratio:     setRatio(value);     break;
+        case Attack:    setAttack(value);    break;
+        case Release:   setRelease(value);   break;
+        case Knee:      setKnee(value);      break;
+        case Makeup:    setMakeup(value);    break;
+        default: break;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "IEffect.h"
+
+/**
+ * @brief Feed-forward stereo-linked compressor
+ *
+ * The detector follows the louder of the two channels. Level detection and
+ * the gain computer run at control rate: the input peak is collected over
+ * sub-blocks of kControlFrames frames and only then converted to decibels,
+ * compared with the soft-knee curve and smoothed with the attack or release
+ * time constant. The resulting gain is ramped linearly across the next
+ * sub-block, so the per-sample work is a multiply and an add whatever the
+ * host block size. The sub-block grid carries over between calls, so
+ * single-frame calls behave exactly like large blocks.
+ *
+ * Gain reduction is smoothed in the decibel domain, which keeps the attack
+ * and release times independent of how far the level is above the threshold.
+ */
+class CompressorEffect : public IEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Threshold, Ratio, Attack, Release, Knee, Makeup };
+
+    static constexpr unsigned int kControlFrames = 8;   ///< Frames per detector step
+
+    /**
+     * @brief Construct a CompressorEffect
+     * @param thresholdDb Level above which the gain is reduced, in dBFS [-60 - 0]
+     * @param ratio       Input/output slope above the threshold [1 - 20]
+     * @param attack      Time to apply gain reduction, in seconds [0.0001 - 1]
+     * @param release     Time to recover from gain reduction, in seconds [0.001 - 5]
+     * @param kneeDb      Width of the soft knee around the threshold, in dB [0 - 24]
+     * @param makeupDb    Gain added after compression, in dB [-12 - 24]
+     * @param sampleRate  Sampling rate of the audio system
+     */
+    CompressorEffect(float thresholdDb = -12.0f, float ratio = 3.0f, float attack = 0.01f, float release = 0.15f,
+                     float kneeDb = 6.0f, float makeupDb = 0.0f, float sampleRate = 44100.0f);
+
+    /** Recompute the time constants for the sample rate */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Process a stereo sample (routes through processBlock) */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+    /** Release all gain reduction */
+    void reset() override;
+
+    /// Set the threshold in dBFS [-60 - 0]
+    void setThreshold(float thresholdDb);
+    /// Set the ratio [1 - 20]
+    void setRatio(float ratio);
+    /// Set the attack time in seconds [0.0001 - 1]
+    void setAttack(float seconds);
+    /// Set the release time in seconds [0.001 - 5]
+    void setRelease(float seconds);
+    /// Set the knee width in dB [0 - 24]
+    void setKnee(float kneeDb);
+    /// Set the makeup gain in dB [-12 - 24]
+    void setMakeup(float makeupDb);
+    /// Set a parameter by id (see CompressorEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+    /// Current gain reduction in dB (0 or positive), for metering
+    float getGainReduction() const { return -m_reductionDb; }
+
+private:
+    float m_sampleRate;         ///< Current sampling rate
+    float m_threshold;          ///< Threshold in dBFS
+    float m_ratio;              ///< Compression ratio
+    float m_attack;             ///< Attack time in seconds
+    float m_release;            ///< Release time in seconds
+    float m_knee;               ///< Knee width in dB
+    float m_makeup;             ///< Makeup gain in dB
+
+    float m_attackCoefficient;  ///< Per-step smoothing while the reduction grows
+    float m_releaseCoefficient; ///< Per-step smoothing while the reduction shrinks
+    float m_reductionDb;        ///< Smoothed gain change in dB (0 or negative)
+    float m_gain;               ///< Linear gain applied to the current frame
+    float m_gainStep;           ///< Per-frame gain ramp toward the next target
+    float m_peak;               ///< Input peak of the current sub-block
+    unsigned int m_count;       ///< Frames of the current sub-block processed
+
+    /** Recompute the attack and release coefficients */
+    void updateCoefficients();
+    /** Gain change in dB from the soft-knee curve for an input level in dB */
+    float computeGain(float levelDb) const;
+    /** Finish a sub-block: detect, smooth and set the next gain ramp */
+    void updateGain();
+};
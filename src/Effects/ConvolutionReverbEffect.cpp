@@ -0,0 +1,322 @@
+#include "ConvolutionReverbEffect.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    constexpr unsigned int kTailRatio = 16;          ///< Worker block size in partitions
+    constexpr unsigned int kMaxTailBlock = 8192;     ///< Largest worker block in frames
+    constexpr float kMaxImpulseSeconds = 20.0f;      ///< Longer impulse responses are truncated
+
+    /**
+     * @brief Linearly resample a signal from one rate to another
+     */
+    std::vector<float> resample(const std::vector<float>& input, float fromRate, float toRate) {
+        if (fromRate == toRate || input.empty()) {
+            return input;
+        }
+
+        const double step = static_cast<double>(fromRate) / toRate;
+        const size_t length = static_cast<size_t>(std::ceil(input.size() / step));
+        std::vector<float> output(length);
+        for (size_t i = 0; i < length; ++i) {
+            double position = i * step;
+            size_t index = static_cast<size_t>(position);
+            float fraction = static_cast<float>(position - index);
+            float a = input[std::min(index, input.size() - 1)];
+            float b = index + 1 < input.size() ? input[index + 1] : 0.0f;
+            output[i] = a + fraction * (b - a);
+        }
+        return output;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// ConvolutionReverbEffect implementation
+// -----------------------------------------------------------------------------
+
+ConvolutionReverbEffect::ConvolutionReverbEffect(std::vector<float> irLeft, std::vector<float> irRight,
+                                                 float irSampleRate, unsigned int partitionSize, float mix)
+    : m_sourceLeft(std::move(irLeft)), m_sourceRight(std::move(irRight)),
+      m_sourceRate(irSampleRate > 0.0f ? irSampleRate : 44100.0f),
+      m_partitionSize(partitionSize), m_tailBlock(0), m_impulseLength(0), m_sampleRate(0.0f), m_mix(0.0f),
+      m_headPos(0), m_tailPos(0), m_fillBuffer(0), m_readBuffer(0), m_jobPending(false),
+      m_stop(false), m_jobReady(false), m_jobDone(true), m_jobInput(0), m_jobOutput(0), m_lateBlocks(0)
+{
+    if (m_sourceLeft.empty()) {
+        throw std::invalid_argument("Convolution reverb needs a non-empty impulse response");
+    }
+    if (partitionSize < 2 || (partitionSize & (partitionSize - 1)) != 0) {
+        throw std::invalid_argument("Convolution partition size must be a power of two");
+    }
+
+    // A mono impulse response feeds both channels
+    if (m_sourceRight.empty()) {
+        m_sourceRight = m_sourceLeft;
+    }
+    m_sourceRight.resize(m_sourceLeft.size(), 0.0f);
+
+    setMix(mix);
+}
+
+ConvolutionReverbEffect::~ConvolutionReverbEffect()
+{
+    stopWorker();
+}
+
+void ConvolutionReverbEffect::prepare(float sampleRate, unsigned int /*maxBlockSize*/)
+{
+    stopWorker();
+
+    std::vector<float> left = resample(m_sourceLeft, m_sourceRate, sampleRate);
+    std::vector<float> right = resample(m_sourceRight, m_sourceRate, sampleRate);
+    const size_t maxLength = static_cast<size_t>(kMaxImpulseSeconds * sampleRate);
+    m_impulseLength = std::min(left.size(), maxLength);
+    m_sampleRate = sampleRate;
+
+    // The tail starts where the worker's one-block deadline can be met:
+    // a tail block is complete after tailBlock frames and its first output
+    // sample is due tailBlock - partitionSize frames after that
+    const unsigned int B = m_partitionSize;
+    m_tailBlock = std::min(std::max(kTailRatio * B, B), std::max(kMaxTailBlock, B));
+    const size_t headLength = std::min<size_t>(2 * m_tailBlock - B, m_impulseLength);
+
+    m_head.reset(new PartitionedConvolver(B, left.data(), right.data(), headLength));
+    m_headInLeft.assign(B, 0.0f);
+    m_headInRight.assign(B, 0.0f);
+    m_headOutLeft.assign(B, 0.0f);
+    m_headOutRight.assign(B, 0.0f);
+
+    m_tail.reset();
+    if (m_impulseLength > headLength) {
+        m_tail.reset(new PartitionedConvolver(m_tailBlock, left.data() + headLength, right.data() + headLength,
+                                              m_impulseLength - headLength));
+        for (unsigned int buffer = 0; buffer < 2; ++buffer) {
+            m_tailInLeft[buffer].assign(m_tailBlock, 0.0f);
+            m_tailInRight[buffer].assign(m_tailBlock, 0.0f);
+            m_tailOutLeft[buffer].assign(m_tailBlock, 0.0f);
+            m_tailOutRight[buffer].assign(m_tailBlock, 0.0f);
+        }
+    }
+
+    clearState();
+
+    if (m_tail) {
+        m_stop.store(false);
+        m_worker = std::thread(&ConvolutionReverbEffect::workerLoop, this);
+    }
+}
+
+std::pair<float, float> ConvolutionReverbEffect::process(std::pair<float, float> stereoSample)
+{
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void ConvolutionReverbEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    if (!m_head) {
+        return; // Not prepared: pass through
+    }
+
+    const unsigned int B = m_partitionSize;
+    const float dry = 1.0f - m_mix;
+    const float wet = m_mix;
+    unsigned int frame = 0;
+
+    while (frame < numFrames)
+    {
+        // Run up to the next partition boundary; tail blocks are a multiple
+        // of B, so their boundaries coincide with head boundaries
+        const unsigned int count = std::min(numFrames - frame, B - m_headPos);
+        float* inLeft = left + frame;
+        float* inRight = right + frame;
+        const float* headOutLeft = m_headOutLeft.data() + m_headPos;
+        const float* headOutRight = m_headOutRight.data() + m_headPos;
+
+        std::copy(inLeft, inLeft + count, m_headInLeft.begin() + m_headPos);
+        std::copy(inRight, inRight + count, m_headInRight.begin() + m_headPos);
+
+        if (m_tail) {
+            std::copy(inLeft, inLeft + count, m_tailInLeft[m_fillBuffer].begin() + m_tailPos);
+            std::copy(inRight, inRight + count, m_tailInRight[m_fillBuffer].begin() + m_tailPos);
+            const float* tailOutLeft = m_tailOutLeft[m_readBuffer].data() + m_tailPos;
+            const float* tailOutRight = m_tailOutRight[m_readBuffer].data() + m_tailPos;
+
+            for (unsigned int i = 0; i < count; ++i) {
+                inLeft[i] = dry * inLeft[i] + wet * (headOutLeft[i] + tailOutLeft[i]);
+                inRight[i] = dry * inRight[i] + wet * (headOutRight[i] + tailOutRight[i]);
+            }
+            m_tailPos += count;
+        } else {
+            for (unsigned int i = 0; i < count; ++i) {
+                inLeft[i] = dry * inLeft[i] + wet * headOutLeft[i];
+                inRight[i] = dry * inRight[i] + wet * headOutRight[i];
+            }
+        }
+
+        m_headPos += count;
+        frame += count;
+
+        if (m_headPos == B) {
+            m_head->process(m_headInLeft.data(), m_headInRight.data(),
+                            m_headOutLeft.data(), m_headOutRight.data());
+            m_headPos = 0;
+        }
+        if (m_tail && m_tailPos == m_tailBlock) {
+            advanceTail();
+            m_tailPos = 0;
+        }
+    }
+}
+
+void ConvolutionReverbEffect::reset()
+{
+    if (m_jobPending) {
+        waitForJob();
+    }
+    if (m_head) {
+        m_head->reset();
+    }
+    if (m_tail) {
+        m_tail->reset();
+        for (unsigned int buffer = 0; buffer < 2; ++buffer) {
+            std::fill(m_tailInLeft[buffer].begin(), m_tailInLeft[buffer].end(), 0.0f);
+            std::fill(m_tailInRight[buffer].begin(), m_tailInRight[buffer].end(), 0.0f);
+            std::fill(m_tailOutLeft[buffer].begin(), m_tailOutLeft[buffer].end(), 0.0f);
+            std::fill(m_tailOutRight[buffer].begin(), m_tailOutRight[buffer].end(), 0.0f);
+        }
+    }
+    clearState();
+}
+
+double ConvolutionReverbEffect::getTailTime() const
+{
+    if (m_sampleRate <= 0.0f) {
+        return 0.0;
+    }
+    return static_cast<double>(m_impulseLength + m_partitionSize) / m_sampleRate;
+}
+
+void ConvolutionReverbEffect::setMix(float mix)
+{
+    // Clamp mix to valid range
+    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+}
+
+void ConvolutionReverbEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Mix: setMix(value); break;
+        default: break;
+    }
+}
+
+void ConvolutionReverbEffect::makeSyntheticImpulse(float seconds, float sampleRate,
+                                                   std::vector<float>& left, std::vector<float>& right)
+{
+    const size_t length = std::max<size_t>(1, static_cast<size_t>(seconds * sampleRate));
+    left.resize(length);
+    right.resize(length);
+
+    // -60 dB over the requested length; fixed seed so renders are repeatable
+    const float decay = std::log(1000.0f) / static_cast<float>(length);
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    double energyLeft = 0.0;
+    double energyRight = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        float envelope = std::exp(-decay * static_cast<float>(i));
+        left[i] = noise(generator) * envelope;
+        right[i] = noise(generator) * envelope;
+        energyLeft += left[i] * left[i];
+        energyRight += right[i] * right[i];
+    }
+
+    const float scaleLeft = energyLeft > 0.0 ? static_cast<float>(1.0 / std::sqrt(energyLeft)) : 0.0f;
+    const float scaleRight = energyRight > 0.0 ? static_cast<float>(1.0 / std::sqrt(energyRight)) : 0.0f;
+    for (size_t i = 0; i < length; ++i) {
+        left[i] *= scaleLeft;
+        right[i] *= scaleRight;
+    }
+}
+
+void ConvolutionReverbEffect::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop.load(std::memory_order_acquire))
+    {
+        // The audio thread notifies without taking the mutex, so a wake-up
+        // can be missed; the timeout bounds the delay that causes
+        m_wake.wait_for(lock, std::chrono::milliseconds(1), [this] {
+            return m_stop.load(std::memory_order_acquire) || m_jobReady.load(std::memory_order_acquire);
+        });
+        if (!m_jobReady.load(std::memory_order_acquire)) {
+            continue;
+        }
+        m_jobReady.store(false, std::memory_order_relaxed);
+
+        lock.unlock();
+        m_tail->process(m_tailInLeft[m_jobInput].data(), m_tailInRight[m_jobInput].data(),
+                        m_tailOutLeft[m_jobOutput].data(), m_tailOutRight[m_jobOutput].data());
+        m_jobDone.store(true, std::memory_order_release);
+        lock.lock();
+    }
+}
+
+void ConvolutionReverbEffect::stopWorker()
+{
+    if (!m_worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+void ConvolutionReverbEffect::waitForJob()
+{
+    if (!m_jobDone.load(std::memory_order_acquire)) {
+        m_lateBlocks.fetch_add(1, std::memory_order_relaxed);
+        while (!m_jobDone.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    m_jobPending = false;
+}
+
+void ConvolutionReverbEffect::advanceTail()
+{
+    // The previous job's output is due now
+    if (m_jobPending) {
+        waitForJob();
+        m_readBuffer = m_jobOutput;
+    }
+
+    m_jobInput = m_fillBuffer;
+    m_jobOutput = 1 - m_readBuffer;
+    m_fillBuffer = 1 - m_fillBuffer;
+    m_jobPending = true;
+    m_jobDone.store(false, std::memory_order_relaxed);
+    m_jobReady.store(true, std::memory_order_release);
+    m_wake.notify_one();
+}
+
+void ConvolutionReverbEffect::clearState()
+{
+    std::fill(m_headInLeft.begin(), m_headInLeft.end(), 0.0f);
+    std::fill(m_headInRight.begin(), m_headInRight.end(), 0.0f);
+    std::fill(m_headOutLeft.begin(), m_headOutLeft.end(), 0.0f);
+    std::fill(m_headOutRight.begin(), m_headOutRight.end(), 0.0f);
+    m_headPos = 0;
+    m_tailPos = 0;
+    m_fillBuffer = 0;
+    m_readBuffer = 0;
+    m_jobPending = false;
+}
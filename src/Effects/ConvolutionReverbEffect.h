@@ -0,0 +1,146 @@
+#pragma once
+#include "IEffect.h"
+#include "DSP/PartitionedConvolver.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Stereo convolution reverb driven by a recorded impulse response
+ *
+ * The impulse response is split in two uniformly partitioned overlap-save
+ * convolvers:
+ *
+ *  - the head (the first 2 * tailBlock - partitionSize samples) runs on the
+ *    audio thread in blocks of @p partitionSize frames;
+ *  - the tail (everything after) runs on a background worker in blocks of
+ *    tailBlock = 16 * partitionSize frames (at most 8192).
+ *
+ * Each tail block is handed to the worker as soon as it is complete, and its
+ * output is not needed until one full tail block later, so the worker has a
+ * whole tailBlock period of slack. The audio thread cost per callback is
+ * therefore bounded by the head size alone, independent of the impulse
+ * response length. The wet signal is delayed by @p partitionSize frames.
+ *
+ * prepare() resamples the impulse response, builds both convolvers and
+ * starts the worker; processBlock() and reset() never allocate. If the
+ * worker ever misses its deadline the audio thread waits for it, which
+ * keeps offline renders bit-exact at the cost of a late real-time block
+ * (counted by getLateBlocks()).
+ */
+class ConvolutionReverbEffect : public IEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Mix };
+
+    /**
+     * @brief Construct a reverb for an impulse response
+     * @param irLeft         Left impulse response samples
+     * @param irRight        Right impulse response samples (empty for a mono IR)
+     * @param irSampleRate   Sample rate the impulse response was recorded at
+     * @param partitionSize  Frames per audio-thread partition, a power of two
+     * @param mix            Blend between dry (0.0) and wet (1.0) signal
+     * @throws std::invalid_argument if the IR is empty or partitionSize is not a power of two
+     */
+    ConvolutionReverbEffect(std::vector<float> irLeft, std::vector<float> irRight, float irSampleRate,
+                            unsigned int partitionSize = 128, float mix = 0.3f);
+    ~ConvolutionReverbEffect() override;
+
+    ConvolutionReverbEffect(const ConvolutionReverbEffect&) = delete;
+    ConvolutionReverbEffect& operator=(const ConvolutionReverbEffect&) = delete;
+
+    /** Resample the IR, build the convolvers and start the tail worker (allocates) */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Process a stereo sample (routes through processBlock) */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+    /** Clear the reverb tail */
+    void reset() override;
+
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+    /// Set a parameter by id (see ConvolutionReverbEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+    /// Frames per audio-thread partition
+    unsigned int getPartitionSize() const { return m_partitionSize; }
+    /// Frames per worker partition (0 before prepare() or without a tail)
+    unsigned int getTailBlockSize() const { return m_tail ? m_tailBlock : 0; }
+    /// Impulse response length in samples at the prepared rate
+    size_t getImpulseLength() const { return m_impulseLength; }
+    /** Length of the impulse response plus the partition delay of the wet signal */
+    double getTailTime() const override;
+    /// Tail blocks the audio thread had to wait for
+    unsigned long getLateBlocks() const { return m_lateBlocks.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Build a decaying stereo noise impulse response
+     *
+     * Used when no impulse response file is configured and by the benchmark.
+     * The result is normalized to unit energy per channel.
+     *
+     * @param seconds    Length of the response (time to decay by 60 dB)
+     * @param sampleRate Sample rate in Hz
+     * @param left       Receives the left channel
+     * @param right      Receives the right channel
+     */
+    static void makeSyntheticImpulse(float seconds, float sampleRate,
+                                     std::vector<float>& left, std::vector<float>& right);
+
+private:
+    std::vector<float> m_sourceLeft;     ///< Impulse response as given
+    std::vector<float> m_sourceRight;    ///< Impulse response as given
+    float m_sourceRate;                  ///< Sample rate of the given IR
+    unsigned int m_partitionSize;        ///< Audio-thread block size (B)
+    unsigned int m_tailBlock;            ///< Worker block size
+    size_t m_impulseLength;              ///< IR length at the prepared rate
+    float m_sampleRate;                  ///< Prepared sample rate (0 before prepare())
+    float m_mix;                         ///< Wet/dry mix
+
+    std::unique_ptr<PartitionedConvolver> m_head;  ///< IR head, audio thread
+    std::unique_ptr<PartitionedConvolver> m_tail;  ///< IR tail, worker thread
+
+    // Audio-thread block state
+    std::vector<float> m_headInLeft;     ///< Input collected for the next head block
+    std::vector<float> m_headInRight;
+    std::vector<float> m_headOutLeft;    ///< Head output being played back
+    std::vector<float> m_headOutRight;
+    unsigned int m_headPos;              ///< Position inside the head block
+
+    // Double-buffered worker blocks, indexed [buffer][frame]
+    std::vector<float> m_tailInLeft[2];
+    std::vector<float> m_tailInRight[2];
+    std::vector<float> m_tailOutLeft[2];
+    std::vector<float> m_tailOutRight[2];
+    unsigned int m_tailPos;              ///< Position inside the tail block
+    unsigned int m_fillBuffer;           ///< Input buffer being filled by the audio thread
+    unsigned int m_readBuffer;           ///< Output buffer being played back
+    bool m_jobPending;                   ///< A tail block was handed to the worker
+
+    // Worker hand-off
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_jobReady;        ///< Set by the audio thread, cleared by the worker
+    std::atomic<bool> m_jobDone;         ///< Set by the worker when the job output is complete
+    unsigned int m_jobInput;             ///< Input buffer of the current job
+    unsigned int m_jobOutput;            ///< Output buffer of the current job
+    std::atomic<unsigned long> m_lateBlocks;
+
+    /** Worker thread body */
+    void workerLoop();
+    /** Stop and join the worker if running */
+    void stopWorker();
+    /** Wait until the worker has finished the current job */
+    void waitForJob();
+    /** Hand the completed tail block to the worker and swap buffers */
+    void advanceTail();
+    /** Zero all audio-thread state */
+    void clearState();
+};
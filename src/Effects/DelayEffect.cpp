@@ -1,36 +1,129 @@
 #include "DelayEffect.h"
 #include <algorithm>
+#include <cmath>
+
+constexpr float DelayEffect::kMaxDelayTime;
+
+namespace {
+    constexpr double kGlideTime = 0.1;   ///< Read position glide time constant in seconds
+    constexpr float kRampTime = 0.02f;   ///< Feedback and mix ramp length in seconds
+    constexpr unsigned int kQuietForever = 0x7fffffffu;   ///< Saturation value of the quiet-frame counter
+}
 
 // -----------------------------------------------------------------------------
 // DelayEffect implementation
 // -----------------------------------------------------------------------------
 
 DelayEffect::DelayEffect(float delayTime, float feedback, float mix, float sampleRate)
-    : m_index(0), m_delayTime(delayTime), m_feedback(feedback), m_mix(mix), m_sampleRate(sampleRate)
+    : m_index(0), m_delayTime(0.3f), m_feedback(0.0f), m_mix(0.0f),
+      m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f), m_tempo(120.0f), m_syncBeats(0.0f),
+      m_pingPong(false), m_delaySamples(0.0), m_targetSamples(0.0), m_glide(1.0), m_quietFrames(0)
 {
-    updateBufferSize();
+    setDelayTime(delayTime);
+    setFeedback(feedback);
+    setMix(mix);
+    allocateBuffers();
+}
+
+void DelayEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    // Only reallocate if the rate differs from the one given at construction
+    if (sampleRate > 0.0f && sampleRate != m_sampleRate) {
+        setSampleRate(sampleRate);
+    }
+    m_feedback.prepare(m_sampleRate, kRampTime, maxBlockSize);
+    m_mix.prepare(m_sampleRate, kRampTime, maxBlockSize);
 }
 
 std::pair<float, float> DelayEffect::process(std::pair<float, float> stereoSample)
 {
-    // Read the current delayed samples from the circular buffer
-    float delayedLeft = m_bufferLeft[m_index];
-    float delayedRight = m_bufferRight[m_index];
+    // Single-frame block keeps the per-sample API on the same code path
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void DelayEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    // Both flags must be polled so each picks up its new target
+    const bool mixMoving = m_mix.isSmoothing();
+    const bool feedbackMoving = m_feedback.isSmoothing();
+    const unsigned int capacity = m_mix.getMaxBlockFrames();
+    if ((!mixMoving && !feedbackMoving) || capacity == 0) {
+        processFrames(left, right, numFrames, nullptr, nullptr);
+        return;
+    }
+
+    while (numFrames > 0)
+    {
+        const unsigned int frames = std::min(numFrames, capacity);
+        processFrames(left, right, frames,
+                      mixMoving ? m_mix.getBlock(frames) : nullptr,
+                      feedbackMoving ? m_feedback.getBlock(frames) : nullptr);
+        left += frames;
+        right += frames;
+        numFrames -= frames;
+    }
+}
+
+void DelayEffect::processFrames(float* left, float* right, unsigned int numFrames,
+                                const float* mixRamp, const float* feedbackRamp)
+{
+    float* bufferLeft = m_bufferLeft.data();
+    float* bufferRight = m_bufferRight.data();
+    const unsigned int size = static_cast<unsigned int>(m_bufferLeft.size());
+    const float mixValue = m_mix.getCurrentValue();
+    const float feedbackValue = m_feedback.getCurrentValue();
+    const double target = m_targetSamples;
+    const double glide = m_glide;
+    double delay = m_delaySamples;
+    unsigned int index = m_index;
+    float writtenPeak = 0.0f;
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        const float wet = mixRamp ? mixRamp[i] : mixValue;
+        const float dry = 1.0f - wet;
+        const float feedback = feedbackRamp ? feedbackRamp[i] : feedbackValue;
+
+        // Glide the read position; a moving read head resamples like tape
+        delay += glide * (target - delay);
+
+        // Linear interpolation between the two samples around the read position
+        unsigned int whole = static_cast<unsigned int>(delay);
+        float fraction = static_cast<float>(delay - whole);
+        unsigned int newer = index >= whole ? index - whole : index + size - whole;
+        unsigned int older = newer > 0 ? newer - 1 : size - 1;
+
+        float delayedLeft = bufferLeft[newer] + fraction * (bufferLeft[older] - bufferLeft[newer]);
+        float delayedRight = bufferRight[newer] + fraction * (bufferRight[older] - bufferRight[newer]);
+
+        if (m_pingPong) {
+            // Mono input enters on the left and every repeat swaps sides
+            bufferLeft[index] = 0.5f * (left[i] + right[i]) + delayedRight * feedback;
+            bufferRight[index] = delayedLeft * feedback;
+        } else {
+            bufferLeft[index] = left[i] + delayedLeft * feedback;
+            bufferRight[index] = right[i] + delayedRight * feedback;
+        }
 
-    // Write the new input along with feedback into the buffer
-    m_bufferLeft[m_index] = stereoSample.first + delayedLeft * m_feedback;
-    m_bufferRight[m_index] = stereoSample.second + delayedRight * m_feedback;
+        writtenPeak = std::max(writtenPeak, std::max(std::fabs(bufferLeft[index]), std::fabs(bufferRight[index])));
 
-    // Blend dry and wet signals according to mix
-    float outLeft = (1.0f - m_mix) * stereoSample.first + m_mix * delayedLeft;
-    float outRight = (1.0f - m_mix) * stereoSample.second + m_mix * delayedRight;
+        left[i] = dry * left[i] + wet * delayedLeft;
+        right[i] = dry * right[i] + wet * delayedRight;
 
-    // Advance the buffer index and wrap around if needed
-    m_index++;
-    if (m_index >= m_bufferLeft.size())
-        m_index = 0;
+        if (++index >= size)
+            index = 0;
+    }
+
+    m_delaySamples = delay;
+    m_index = index;
 
-    return {outLeft, outRight};
+    // Count how long the line has only been fed silence
+    if (writtenPeak < kSilenceThreshold) {
+        m_quietFrames = std::min(m_quietFrames + numFrames, kQuietForever);
+    } else {
+        m_quietFrames = 0;
+    }
 }
 
 void DelayEffect::reset()
@@ -38,43 +131,120 @@ void DelayEffect::reset()
     std::fill(m_bufferLeft.begin(), m_bufferLeft.end(), 0.0f);
     std::fill(m_bufferRight.begin(), m_bufferRight.end(), 0.0f);
     m_index = 0;
+    m_delaySamples = m_targetSamples;
+    m_quietFrames = kQuietForever;
+    m_feedback.reset();
+    m_mix.reset();
 }
 
 void DelayEffect::setSampleRate(float sampleRate)
 {
     if (sampleRate > 0.0f) {
         m_sampleRate = sampleRate;
-        updateBufferSize();
+        allocateBuffers();
     }
 }
 
 void DelayEffect::setDelayTime(float delayTime)
 {
     // Limit delay time to reasonable range (0.001s to 5s)
-    if (delayTime >= 0.001f && delayTime <= 5.0f) {
+    if (delayTime >= 0.001f && delayTime <= kMaxDelayTime) {
         m_delayTime = delayTime;
-        updateBufferSize();
+        updateTarget();
     }
 }
 
 void DelayEffect::setFeedback(float feedback)
 {
     // Clamp feedback to prevent runaway feedback
-    m_feedback = std::min(std::max(feedback, 0.0f), 0.95f);
+    m_feedback.setTargetValue(std::min(std::max(feedback, 0.0f), 0.95f));
 }
 
 void DelayEffect::setMix(float mix)
 {
     // Clamp mix to valid range
-    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+    m_mix.setTargetValue(std::min(std::max(mix, 0.0f), 1.0f));
+}
+
+void DelayEffect::setTempo(float bpm)
+{
+    if (bpm >= 20.0f && bpm <= 400.0f) {
+        m_tempo = bpm;
+        updateTarget();
+    }
 }
 
-// Resize the delay buffers whenever parameters change
-void DelayEffect::updateBufferSize()
+void DelayEffect::setSyncDivision(float beats)
 {
-    unsigned int size = static_cast<unsigned int>(m_delayTime * m_sampleRate);
-    size = std::max(1u, size);
+    m_syncBeats = std::max(beats, 0.0f);
+    updateTarget();
+}
+
+void DelayEffect::setPingPong(bool pingPong)
+{
+    m_pingPong = pingPong;
+}
+
+void DelayEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case DelayTime:    setDelayTime(value);        break;
+        case Feedback:     setFeedback(value);         break;
+        case Mix:          setMix(value);              break;
+        case Tempo:        setTempo(value);            break;
+        case SyncDivision: setSyncDivision(value);     break;
+        case PingPong:     setPingPong(value >= 0.5f); break;
+        default: break;
+    }
+}
+
+float DelayEffect::getTargetDelayTime() const
+{
+    return static_cast<float>(m_targetSamples / m_sampleRate);
+}
+
+double DelayEffect::getTailTime() const
+{
+    const double delay = std::max(m_delaySamples, m_targetSamples) / m_sampleRate;
+    const double feedback = std::max(m_feedback.getCurrentValue(), m_feedback.getTargetValue());
+    if (feedback <= 0.0) {
+        return delay;
+    }
+    // Each repeat is quieter by the feedback gain
+    const double repeats = std::log(static_cast<double>(kSilenceThreshold)) / std::log(feedback);
+    return delay * (1.0 + std::ceil(repeats));
+}
+
+bool DelayEffect::isSilent() const
+{
+    // Everything the read head can still reach was written below the threshold
+    return m_quietFrames > std::max(m_delaySamples, m_targetSamples) + 1.0;
+}
+
+// Allocate the full-length delay line; only called on the control thread
+void DelayEffect::allocateBuffers()
+{
+    // One extra sample for the interpolation neighbour of the longest delay
+    unsigned int size = static_cast<unsigned int>(std::ceil(kMaxDelayTime * m_sampleRate)) + 2;
     m_bufferLeft.assign(size, 0.0f);
     m_bufferRight.assign(size, 0.0f);
-    m_index = 0; // reset buffer position
+    m_index = 0;
+    m_quietFrames = kQuietForever;
+
+    m_glide = 1.0 - std::exp(-1.0 / (kGlideTime * m_sampleRate));
+    updateTarget();
+    m_delaySamples = m_targetSamples;
+}
+
+void DelayEffect::updateTarget()
+{
+    float seconds = m_delayTime;
+    if (m_syncBeats > 0.0f) {
+        seconds = m_syncBeats * 60.0f / m_tempo;
+    }
+
+    // At least one sample so the read never overtakes the write, and never
+    // beyond the buffer capacity
+    double samples = static_cast<double>(seconds) * m_sampleRate;
+    m_targetSamples = std::min(std::max(samples, 1.0), static_cast<double>(kMaxDelayTime) * m_sampleRate);
 }
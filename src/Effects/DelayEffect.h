@@ -1,17 +1,30 @@
 #pragma once
 #include "IEffect.h"
+#include "DSP/SmoothedParameter.h"
 #include <vector>
 
 /**
- * @brief Simple delay line effect with feedback
+ * @brief Stereo delay line effect with feedback, tempo sync and ping-pong
  *
  * This effect stores past samples in a circular buffer to create an echo.
  * The @p feedback parameter determines how much of the delayed signal is
  * fed back into the buffer, while @p mix controls the wet/dry ratio.
+ *
+ * The buffer is allocated once for kMaxDelayTime at the prepared sample rate.
+ * The delay time only moves a fractional, linearly interpolated read
+ * position that glides towards its target, so turning the time knob bends
+ * the pitch like a tape delay instead of clicking, and no parameter change
+ * allocates or clears the echo tail. Feedback and mix ramp to new values
+ * over a few milliseconds so dragging their sliders does not zipper.
  */
 class DelayEffect : public IEffect
 {
 public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { DelayTime, Feedback, Mix, Tempo, SyncDivision, PingPong };
+
+    static constexpr float kMaxDelayTime = 5.0f;  ///< Longest delay in seconds (buffer capacity)
+
     /**
      * @brief Construct a DelayEffect with common parameters
      * @param delayTime  Delay time in seconds
@@ -22,29 +35,65 @@ public:
     DelayEffect(float delayTime = 0.3f, float feedback = 0.5f, float mix = 0.5f,
                 float sampleRate = 44100.0f);
 
+    /** Size the delay buffers for the sample rate and the parameter ramps for the block size */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
     /** Process a stereo sample and return the delayed result */
     std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
     /** Reset the internal delay buffer */
     void reset() override;
 
-    /// Change the sampling rate and resize the buffer accordingly
+    /// Change the sampling rate and reallocate the buffer (allocates, control thread only)
     void setSampleRate(float sampleRate);
-    /// Set the delay time in seconds
+    /// Set the free-running delay time in seconds [0.001 - 5.0]
     void setDelayTime(float delayTime);
     /// Set the feedback level [0.0 - 1.0]
     void setFeedback(float feedback);
     /// Set the wet/dry mix [0.0 - 1.0]
     void setMix(float mix);
+    /// Set the tempo in BPM used when a sync division is set
+    void setTempo(float bpm);
+    /// Sync the delay to a note length in beats (0.5 = eighth note), 0 for free time
+    void setSyncDivision(float beats);
+    /// Bounce echoes between the left and right channels
+    void setPingPong(bool pingPong);
+    /// Set a parameter by id (see DelayEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+    /// Delay time currently being glided towards, in seconds
+    float getTargetDelayTime() const;
+
+    /** Time for the echoes to fall below the silence threshold at the current feedback */
+    double getTailTime() const override;
+    /** True once nothing above the silence threshold is left in the delay line */
+    bool isSilent() const override;
 
 private:
     std::vector<float> m_bufferLeft;  ///< Circular buffer for left channel
     std::vector<float> m_bufferRight; ///< Circular buffer for right channel
-    unsigned int m_index;             ///< Current write/read index in buffers
-    float m_delayTime;                ///< Delay time in seconds
-    float m_feedback;                 ///< Feedback amount
-    float m_mix;                      ///< Wet/dry mix
+    unsigned int m_index;             ///< Current write index in buffers
+    float m_delayTime;                ///< Free-running delay time in seconds
+    SmoothedParameter<float> m_feedback; ///< Feedback amount
+    SmoothedParameter<float> m_mix;   ///< Wet/dry mix
     float m_sampleRate;               ///< Current sampling rate
+    float m_tempo;                    ///< Tempo in BPM for synced delays
+    float m_syncBeats;                ///< Synced note length in beats, 0 when free
+    bool m_pingPong;                  ///< Cross-feed the channels
+    double m_delaySamples;            ///< Smoothed delay in samples (fractional)
+    double m_targetSamples;           ///< Delay the read position glides towards
+    double m_glide;                   ///< Per-sample glide coefficient
+    unsigned int m_quietFrames;       ///< Consecutive frames written below the silence threshold
 
-    /** Resize internal buffers based on delay time and sample rate */
-    void updateBufferSize();
+    /** Allocate the buffers for kMaxDelayTime at the current sample rate */
+    void allocateBuffers();
+    /** Recompute the target read position from time, tempo and division */
+    void updateTarget();
+    /**
+     * @brief Run the delay line over a block
+     * @param mixRamp      Per-frame mix, or nullptr while the mix is constant
+     * @param feedbackRamp Per-frame feedback, or nullptr while the feedback is constant
+     */
+    void processFrames(float* left, float* right, unsigned int numFrames,
+                       const float* mixRamp, const float* feedbackRamp);
 };
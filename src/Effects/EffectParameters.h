@@ -20,9 +20,12 @@ public:
  */
 class DelayParameters : public IEffectParameters {
 public:
-    float delayTime = 0.3f;    // Delay time in seconds (0.1 - 2.0)
+    float delayTime = 0.3f;    // Delay time in seconds (0.01 - 5.0)
     float feedback = 0.3f;     // Feedback amount (0.0 - 0.9)
     float mix = 0.5f;          // Dry/wet mix (0.0 = dry, 1.0 = wet)
+    float tempo = 120.0f;      // Tempo in BPM for synced delays (20 - 400)
+    float syncDivision = 0.0f; // Synced note length in beats (0.5 = 1/8), 0 = free time
+    bool pingPong = false;     // Bounce repeats between left and right
 
     std::string getEffectName() const override { return "delay"; }
     
@@ -30,6 +33,9 @@ public:
         delayTime = 0.3f;
         feedback = 0.3f;
         mix = 0.5f;
+        tempo = 120.0f;
+        syncDivision = 0.0f;
+        pingPong = false;
     }
     
     std::unique_ptr<IEffectParameters> clone() const override {
@@ -37,29 +43,38 @@ public:
         params->delayTime = delayTime;
         params->feedback = feedback;
         params->mix = mix;
+        params->tempo = tempo;
+        params->syncDivision = syncDivision;
+        params->pingPong = pingPong;
         return params;
     }
 };
 
 /**
- * Parameters for LowPassEffect
+ * Parameters for the "lowpass" FilterEffect slot
  */
 class LowPassParameters : public IEffectParameters {
 public:
     float cutoffFreq = 1000.0f;  // Cutoff frequency in Hz (20 - 20000)
-    float resonance = 0.7f;      // Filter resonance (0.1 - 2.0)
+    float resonance = 0.7f;      // Filter resonance / Q (0.1 - 2.0)
+    int mode = 0;                // FilterEffect::Mode (0 = lowpass ... 5 = high shelf)
+    float gainDb = 0.0f;         // Shelf gain in dB (-24 - 24, shelf modes only)
 
     std::string getEffectName() const override { return "lowpass"; }
     
     void reset() override {
         cutoffFreq = 1000.0f;
         resonance = 0.7f;
+        mode = 0;
+        gainDb = 0.0f;
     }
     
     std::unique_ptr<IEffectParameters> clone() const override {
         auto params = std::make_unique<LowPassParameters>();
         params->cutoffFreq = cutoffFreq;
         params->resonance = resonance;
+        params->mode = mode;
+        params->gainDb = gainDb;
         return params;
     }
 };
@@ -87,6 +102,106 @@ public:
     }
 };
 
+/**
+ * Parameters for ReverbEffect
+ */
+class ReverbParameters : public IEffectParameters {
+public:
+    float size = 0.5f;           // Room size (0.0 - 1.0)
+    float decay = 2.0f;          // Time to fall by 60 dB in seconds (0.1 - 30)
+    float damping = 0.5f;        // High-frequency damping (0.0 - 1.0)
+    float mix = 0.25f;           // Dry/wet mix (0.0 = dry, 1.0 = wet)
+
+    std::string getEffectName() const override { return "reverb"; }
+    
+    void reset() override {
+        size = 0.5f;
+        decay = 2.0f;
+        damping = 0.5f;
+        mix = 0.25f;
+    }
+    
+    std::unique_ptr<IEffectParameters> clone() const override {
+        auto params = std::make_unique<ReverbParameters>();
+        params->size = size;
+        params->decay = decay;
+        params->damping = damping;
+        params->mix = mix;
+        return params;
+    }
+};
+
+/**
+ * Parameters for the oversampled WaveshaperEffect (overdrive, hardclip, foldback)
+ */
+class WaveshaperParameters : public IEffectParameters {
+public:
+    int shape = 0;               // Transfer curve (0 = tanh, 1 = hard clip, 2 = foldback)
+    float driveDb = 12.0f;       // Input gain in dB (0 - 48)
+    float mix = 1.0f;            // Dry/wet mix (0.0 = dry, 1.0 = wet)
+    float levelDb = -6.0f;       // Output level in dB (-24 - 12)
+
+    std::string getEffectName() const override { return "overdrive"; }
+    
+    void reset() override {
+        shape = 0;
+        driveDb = 12.0f;
+        mix = 1.0f;
+        levelDb = -6.0f;
+    }
+    
+    std::unique_ptr<IEffectParameters> clone() const override {
+        auto params = std::make_unique<WaveshaperParameters>();
+        params->shape = shape;
+        params->driveDb = driveDb;
+        params->mix = mix;
+        params->levelDb = levelDb;
+        return params;
+    }
+};
+
+/**
+ * Parameters for the LFO-driven effects (chorus, flanger, phaser)
+ *
+ * One class serves all three; the effect name picks the defaults. The chorus
+ * has no feedback, so it ignores that field.
+ */
+class ModulationParameters : public IEffectParameters {
+public:
+    std::string effect;          // "chorus", "flanger" or "phaser"
+    float rate;                  // LFO rate in Hz (0.01 - 20); no effect with a shared LFO
+    float depth;                 // Sweep depth (0.0 - 1.0)
+    float feedback;              // Feedback (-0.95 - 0.95), flanger and phaser only
+    float mix;                   // Dry/wet mix (0.0 = dry, 1.0 = wet)
+
+    explicit ModulationParameters(const std::string& effectName = "chorus") : effect(effectName) {
+        reset();
+    }
+
+    std::string getEffectName() const override { return effect; }
+    
+    void reset() override {
+        if (effect == "flanger") {
+            rate = 0.2f;
+            depth = 0.7f;
+            feedback = 0.5f;
+        } else if (effect == "phaser") {
+            rate = 0.4f;
+            depth = 0.7f;
+            feedback = 0.5f;
+        } else {
+            rate = 0.8f;
+            depth = 0.5f;
+            feedback = 0.0f;
+        }
+        mix = 0.5f;
+    }
+    
+    std::unique_ptr<IEffectParameters> clone() const override {
+        return std::make_unique<ModulationParameters>(*this);
+    }
+};
+
 /**
  * Container for all effect parameters
  */
@@ -0,0 +1,302 @@
+#include "FilterEffect.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FILTER_HAS_SSE 1
+#include <emmintrin.h>
+// Let the SSE kernel be built even when the baseline target lacks SSE2
+#if defined(__GNUC__) && !defined(__SSE2__)
+#define FILTER_SSE_TARGET __attribute__((target("sse2")))
+#else
+#define FILTER_SSE_TARGET
+#endif
+#else
+#define FILTER_HAS_SSE 0
+#endif
+
+constexpr unsigned int FilterEffect::kControlInterval;
+
+namespace {
+    constexpr float kPi = 3.14159265358979f;
+    constexpr float kRampTime = 0.02f;     ///< Cutoff, resonance and gain ramp length in seconds
+    constexpr float kMinCutoff = 10.0f;    ///< Lowest cutoff in Hz
+
+    /**
+     * @brief Portable kernel: both channels interleaved in one loop
+     */
+    void processScalar(const FilterEffect::Coefficients& c, FilterEffect::State& s,
+                       float* left, float* right, unsigned int numFrames) {
+        float ic1L = s.ic1[0], ic1R = s.ic1[1];
+        float ic2L = s.ic2[0], ic2R = s.ic2[1];
+
+        for (unsigned int i = 0; i < numFrames; ++i)
+        {
+            float v0L = left[i];
+            float v3L = v0L - ic2L;
+            float v1L = c.a1 * ic1L + c.a2 * v3L;
+            float v2L = ic2L + c.a2 * ic1L + c.a3 * v3L;
+            ic1L = 2.0f * v1L - ic1L;
+            ic2L = 2.0f * v2L - ic2L;
+            left[i] = c.m0 * v0L + c.m1 * v1L + c.m2 * v2L;
+
+            float v0R = right[i];
+            float v3R = v0R - ic2R;
+            float v1R = c.a1 * ic1R + c.a2 * v3R;
+            float v2R = ic2R + c.a2 * ic1R + c.a3 * v3R;
+            ic1R = 2.0f * v1R - ic1R;
+            ic2R = 2.0f * v2R - ic2R;
+            right[i] = c.m0 * v0R + c.m1 * v1R + c.m2 * v2R;
+        }
+
+        s.ic1[0] = ic1L; s.ic1[1] = ic1R;
+        s.ic2[0] = ic2L; s.ic2[1] = ic2R;
+    }
+
+#if FILTER_HAS_SSE
+    /**
+     * @brief SSE kernel: left and right run in lanes 0 and 1 of the same registers
+     */
+    FILTER_SSE_TARGET
+    void processSse(const FilterEffect::Coefficients& c, FilterEffect::State& s,
+                    float* left, float* right, unsigned int numFrames) {
+        const __m128 a1 = _mm_set1_ps(c.a1);
+        const __m128 a2 = _mm_set1_ps(c.a2);
+        const __m128 a3 = _mm_set1_ps(c.a3);
+        const __m128 m0 = _mm_set1_ps(c.m0);
+        const __m128 m1 = _mm_set1_ps(c.m1);
+        const __m128 m2 = _mm_set1_ps(c.m2);
+        const __m128 two = _mm_set1_ps(2.0f);
+        __m128 ic1 = _mm_setr_ps(s.ic1[0], s.ic1[1], 0.0f, 0.0f);
+        __m128 ic2 = _mm_setr_ps(s.ic2[0], s.ic2[1], 0.0f, 0.0f);
+
+        for (unsigned int i = 0; i < numFrames; ++i)
+        {
+            __m128 v0 = _mm_unpacklo_ps(_mm_load_ss(left + i), _mm_load_ss(right + i));
+            __m128 v3 = _mm_sub_ps(v0, ic2);
+            __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, ic1), _mm_mul_ps(a2, v3));
+            __m128 v2 = _mm_add_ps(ic2, _mm_add_ps(_mm_mul_ps(a2, ic1), _mm_mul_ps(a3, v3)));
+            ic1 = _mm_sub_ps(_mm_mul_ps(two, v1), ic1);
+            ic2 = _mm_sub_ps(_mm_mul_ps(two, v2), ic2);
+
+            __m128 out = _mm_add_ps(_mm_mul_ps(m0, v0), _mm_add_ps(_mm_mul_ps(m1, v1), _mm_mul_ps(m2, v2)));
+            _mm_store_ss(left + i, out);
+            _mm_store_ss(right + i, _mm_shuffle_ps(out, out, _MM_SHUFFLE(1, 1, 1, 1)));
+        }
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, ic1);
+        s.ic1[0] = lanes[0]; s.ic1[1] = lanes[1];
+        _mm_storeu_ps(lanes, ic2);
+        s.ic2[0] = lanes[0]; s.ic2[1] = lanes[1];
+    }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// FilterEffect implementation
+// -----------------------------------------------------------------------------
+
+FilterEffect::FilterEffect(Mode mode, float cutoff, float resonance, float sampleRate)
+    : m_mode(mode), m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f),
+      m_cutoff(std::max(cutoff, kMinCutoff)), m_resonance(0.7071f), m_gainDb(0.0f),
+      m_dirty(true), m_useSimd(isSimdAvailable()), m_untilUpdate(0)
+{
+    setResonance(resonance);
+    reset();
+    updateCoefficients();
+}
+
+void FilterEffect::prepare(float sampleRate, unsigned int /*maxBlockSize*/)
+{
+    setSampleRate(sampleRate);
+
+    // The ramps advance once per control interval; preparing also starts
+    // them at their targets rather than ramping in from the construction values
+    const float controlRate = m_sampleRate / static_cast<float>(kControlInterval);
+    m_cutoff.prepare(controlRate, kRampTime, 0);
+    m_resonance.prepare(controlRate, kRampTime, 0);
+    m_gainDb.prepare(controlRate, kRampTime, 0);
+    m_dirty = true;
+    updateCoefficients();
+}
+
+std::pair<float, float> FilterEffect::process(std::pair<float, float> stereoSample)
+{
+    // Single-frame block keeps the per-sample API on the same code path
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void FilterEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    while (numFrames > 0)
+    {
+        // Control rate: the glide and coefficients only move between sub-blocks
+        if (m_untilUpdate == 0) {
+            updateCoefficients();
+            m_untilUpdate = kControlInterval;
+        }
+
+        unsigned int frames = std::min(numFrames, m_untilUpdate);
+#if FILTER_HAS_SSE
+        if (m_useSimd) {
+            processSse(m_coefficients, m_state, left, right, frames);
+        } else {
+            processScalar(m_coefficients, m_state, left, right, frames);
+        }
+#else
+        processScalar(m_coefficients, m_state, left, right, frames);
+#endif
+
+        left += frames;
+        right += frames;
+        numFrames -= frames;
+        m_untilUpdate -= frames;
+    }
+}
+
+void FilterEffect::reset()
+{
+    m_state.ic1[0] = m_state.ic1[1] = 0.0f;
+    m_state.ic2[0] = m_state.ic2[1] = 0.0f;
+}
+
+void FilterEffect::setSampleRate(float sampleRate)
+{
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+        m_dirty = true;
+        m_untilUpdate = 0;
+    }
+}
+
+void FilterEffect::setCutoff(float cutoff)
+{
+    if (cutoff > 0.0f) {
+        m_cutoff.setTargetValue(std::max(cutoff, kMinCutoff));
+    }
+}
+
+void FilterEffect::setResonance(float resonance)
+{
+    m_resonance.setTargetValue(std::min(std::max(resonance, 0.1f), 20.0f));
+}
+
+void FilterEffect::setMode(Mode mode)
+{
+    m_mode = mode;
+    m_dirty = true;
+    m_untilUpdate = 0;
+}
+
+void FilterEffect::setGain(float gainDb)
+{
+    m_gainDb.setTargetValue(std::min(std::max(gainDb, -24.0f), 24.0f));
+}
+
+void FilterEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId)
+    {
+        case Cutoff:
+            setCutoff(value);
+            break;
+        case Resonance:
+            setResonance(value);
+            break;
+        case FilterMode:
+        {
+            int mode = static_cast<int>(value + 0.5f);
+            if (mode >= 0 && mode <= static_cast<int>(Mode::HighShelf)) {
+                setMode(static_cast<Mode>(mode));
+            }
+            break;
+        }
+        case Gain:
+            setGain(value);
+            break;
+    }
+}
+
+double FilterEffect::getTailTime() const
+{
+    // The poles decay as exp(-pi * fc / Q * t); the lowest cutoff and
+    // highest Q a ramp passes through ring longest
+    const double cutoff = std::min(m_cutoff.getCurrentValue(), m_cutoff.getTargetValue());
+    const double q = std::max(m_resonance.getCurrentValue(), m_resonance.getTargetValue());
+    return -std::log(static_cast<double>(kSilenceThreshold)) * q / (kPi * cutoff);
+}
+
+bool FilterEffect::isSilent() const
+{
+    const State& s = m_state;
+    return std::max(std::max(std::fabs(s.ic1[0]), std::fabs(s.ic1[1])),
+                    std::max(std::fabs(s.ic2[0]), std::fabs(s.ic2[1]))) < kSilenceThreshold;
+}
+
+void FilterEffect::setUseSimd(bool useSimd)
+{
+    m_useSimd = useSimd && isSimdAvailable();
+}
+
+bool FilterEffect::isSimdAvailable()
+{
+#if FILTER_HAS_SSE && defined(__GNUC__)
+    static const bool available = __builtin_cpu_supports("sse2");
+    return available;
+#elif FILTER_HAS_SSE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FilterEffect::updateCoefficients()
+{
+    // One ramp step per control interval (the ramps run at control rate)
+    if (m_cutoff.isSmoothing()) {
+        m_cutoff.getNextValue();
+        m_dirty = true;
+    }
+    if (m_resonance.isSmoothing()) {
+        m_resonance.getNextValue();
+        m_dirty = true;
+    }
+    if (m_gainDb.isSmoothing()) {
+        m_gainDb.getNextValue();
+        m_dirty = true;
+    }
+
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+
+    // Keep the cutoff strictly below Nyquist so tan() stays finite
+    const float cutoff = std::min(m_cutoff.getCurrentValue(), 0.49f * m_sampleRate);
+    float g = std::tan(kPi * cutoff / m_sampleRate);
+    const float k = 1.0f / m_resonance.getCurrentValue();
+    const float a = std::pow(10.0f, m_gainDb.getCurrentValue() / 40.0f);
+
+    Coefficients& c = m_coefficients;
+    switch (m_mode)
+    {
+        case Mode::LowPass:   c.m0 = 0.0f; c.m1 = 0.0f; c.m2 = 1.0f; break;
+        case Mode::HighPass:  c.m0 = 1.0f; c.m1 = -k;   c.m2 = -1.0f; break;
+        case Mode::BandPass:  c.m0 = 0.0f; c.m1 = k;    c.m2 = 0.0f; break;
+        case Mode::Notch:     c.m0 = 1.0f; c.m1 = -k;   c.m2 = 0.0f; break;
+        case Mode::LowShelf:
+            g /= std::sqrt(a);
+            c.m0 = 1.0f; c.m1 = k * (a - 1.0f); c.m2 = a * a - 1.0f;
+            break;
+        case Mode::HighShelf:
+            g *= std::sqrt(a);
+            c.m0 = a * a; c.m1 = k * (1.0f - a) * a; c.m2 = 1.0f - a * a;
+            break;
+    }
+
+    c.a1 = 1.0f / (1.0f + g * (g + k));
+    c.a2 = g * c.a1;
+    c.a3 = g * c.a2;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "IEffect.h"
+#include "DSP/SmoothedParameter.h"
+
+/**
+ * @brief Resonant multi-mode stereo filter
+ *
+ * A topology-preserving state-variable filter (the trapezoidal SVF), which
+ * has the same 12 dB/octave response as an RBJ biquad but stays well behaved
+ * while its cutoff is being swept. All modes are mixes of the SVF's lowpass,
+ * bandpass and input signals, so switching mode only changes three gains.
+ *
+ * Cutoff, resonance and shelf gain changes ramp to their targets (cutoff
+ * and resonance on an exponential curve, gain linearly in dB) and the
+ * coefficients (one std::tan) are recomputed once per kControlInterval
+ * frames while a ramp is running, rather than per sample, so MIDI CC sweeps
+ * stay cheap and a stable filter does no control work at all. Both channels are processed together
+ * in SSE lanes when the CPU supports it, with a scalar kernel as fallback;
+ * the choice is made at runtime.
+ */
+class FilterEffect : public IEffect
+{
+public:
+    /// Filter response
+    enum class Mode : unsigned int { LowPass, HighPass, BandPass, Notch, LowShelf, HighShelf };
+
+    /// Parameter ids accepted by setParameter(); Cutoff keeps the old LowPassEffect id
+    enum Parameter : unsigned int { Cutoff, Resonance, FilterMode, Gain };
+
+    static constexpr unsigned int kControlInterval = 32;  ///< Frames between coefficient updates while gliding
+
+    /**
+     * @brief Construct a FilterEffect
+     * @param mode       Filter response
+     * @param cutoff     Cutoff (or shelf/centre) frequency in Hertz
+     * @param resonance  Q factor, 0.7071 for a flat Butterworth response
+     * @param sampleRate Sampling rate used for processing
+     */
+    FilterEffect(Mode mode = Mode::LowPass, float cutoff = 1000.0f, float resonance = 0.7071f,
+                 float sampleRate = 44100.0f);
+
+    /// Store the sample rate and compute the coefficients
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /// Process a stereo sample through the filter
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /// Process a block of planar stereo samples in place
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+    /// Reset internal filter state
+    void reset() override;
+
+    /// Update the sampling rate
+    void setSampleRate(float sampleRate);
+    /// Set the cutoff frequency; the filter ramps there over a few milliseconds
+    void setCutoff(float cutoff);
+    /// Set the resonance (Q), clamped to [0.1, 20]
+    void setResonance(float resonance);
+    /// Set the filter response
+    void setMode(Mode mode);
+    /// Set the shelf gain in dB (shelf modes only), clamped to [-24, 24]
+    void setGain(float gainDb);
+    /// Set a parameter by id (see FilterEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+    /// Choose the SSE kernel when available (true) or force the scalar one (false)
+    void setUseSimd(bool useSimd);
+    /// True if the SSE kernel is in use
+    bool isUsingSimd() const { return m_useSimd; }
+    /// True if this CPU can run the SSE kernel
+    static bool isSimdAvailable();
+
+    /// Current response mode
+    Mode getMode() const { return m_mode; }
+
+    /** Ringing time of the resonance at the current cutoff and Q */
+    double getTailTime() const override;
+    /** True once both integrators have decayed below the silence threshold */
+    bool isSilent() const override;
+
+    /// Coefficients of one SVF section
+    struct Coefficients {
+        float a1, a2, a3;   ///< State update gains
+        float m0, m1, m2;   ///< Output mix of input, bandpass and lowpass
+    };
+
+    /// Integrator state for both channels
+    struct State {
+        float ic1[2];       ///< First integrator, {left, right}
+        float ic2[2];       ///< Second integrator, {left, right}
+    };
+
+private:
+    Mode m_mode;              ///< Current response
+    float m_sampleRate;       ///< System sampling rate
+    SmoothedParameter<float, SmoothingType::Exponential> m_cutoff;    ///< Cutoff in Hz
+    SmoothedParameter<float, SmoothingType::Exponential> m_resonance; ///< Q factor
+    SmoothedParameter<float> m_gainDb;                                ///< Shelf gain in dB
+    bool m_dirty;             ///< Coefficients need recomputing
+    bool m_useSimd;           ///< Use the SSE kernel
+    unsigned int m_untilUpdate; ///< Frames until the next control-rate update
+    Coefficients m_coefficients;
+    State m_state;
+
+    /** Advance the ramps and recompute the coefficients if anything changed */
+    void updateCoefficients();
+};
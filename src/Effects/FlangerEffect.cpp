@@ -0,0 +1,98 @@
+#include "FlangerEffect.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    constexpr float kMinDelay = 0.0002f;   ///< Shortest delay in seconds
+    constexpr float kMaxSweep = 0.0048f;   ///< Sweep range above kMinDelay at full depth
+}
+
+FlangerEffect::FlangerEffect(float rate, float depth, float feedback, float mix, float sampleRate,
+                             std::shared_ptr<const BlockLfo> sharedLfo)
+    : ModulatedEffect(rate, std::move(sharedLfo)),
+      m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f), m_depth(0.7f), m_feedback(0.5f), m_mix(0.5f)
+{
+    setDepth(depth);
+    setFeedback(feedback);
+    setMix(mix);
+}
+
+void FlangerEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+    }
+    prepareLfo(m_sampleRate, maxBlockSize);
+    const unsigned int maxDelay = static_cast<unsigned int>((kMinDelay + kMaxSweep) * m_sampleRate) + 1;
+    m_lineLeft.prepare(maxDelay);
+    m_lineRight.prepare(maxDelay);
+}
+
+void FlangerEffect::processModulated(float* left, float* right, unsigned int numFrames,
+                                     const float* sine, const float* cosine)
+{
+    // Sweep from the minimum delay up; at least one sample so the read
+    // never touches the sample about to be written
+    const float minimum = std::max(kMinDelay * m_sampleRate, 1.0f);
+    const float halfSweep = 0.5f * kMaxSweep * m_sampleRate * m_depth;
+    const float feedback = m_feedback;
+    const float dry = 1.0f - m_mix;
+    const float wet = m_mix;
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        const float delayedLeft = m_lineLeft.read(minimum + halfSweep * (1.0f + sine[i]));
+        const float delayedRight = m_lineRight.read(minimum + halfSweep * (1.0f + cosine[i]));
+
+        m_lineLeft.write(left[i] + feedback * delayedLeft);
+        m_lineRight.write(right[i] + feedback * delayedRight);
+
+        left[i] = dry * left[i] + wet * delayedLeft;
+        right[i] = dry * right[i] + wet * delayedRight;
+    }
+}
+
+void FlangerEffect::reset()
+{
+    m_lineLeft.reset();
+    m_lineRight.reset();
+    resetLfo();
+}
+
+double FlangerEffect::getTailTime() const
+{
+    const double delay = static_cast<double>(kMinDelay + kMaxSweep);
+    const double feedback = std::fabs(m_feedback);
+    if (feedback <= 0.0) {
+        return delay;
+    }
+    const double repeats = std::log(static_cast<double>(kSilenceThreshold)) / std::log(feedback);
+    return delay * (1.0 + std::ceil(repeats));
+}
+
+void FlangerEffect::setDepth(float depth)
+{
+    m_depth = std::min(std::max(depth, 0.0f), 1.0f);
+}
+
+void FlangerEffect::setFeedback(float feedback)
+{
+    m_feedback = std::min(std::max(feedback, -0.95f), 0.95f);
+}
+
+void FlangerEffect::setMix(float mix)
+{
+    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+}
+
+void FlangerEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Rate:     setRate(value);     break;
+        case Depth:    setDepth(value);    break;
+        case Feedback: setFeedback(value); break;
+        case Mix:      setMix(value);      break;
+        default: break;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "ModulatedEffect.h"
+#include "DSP/ModulatedDelayLine.h"
+
+/**
+ * @brief Stereo flanger
+ *
+ * A single short delay (0.2 - 5 ms) swept by the LFO and mixed with the dry
+ * signal gives a comb filter whose notches glide up and down. Feedback
+ * deepens the comb; negative feedback moves the peaks to the odd harmonics
+ * for a hollower sound. The right channel follows the cosine of the LFO.
+ */
+class FlangerEffect : public ModulatedEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Rate, Depth, Feedback, Mix };
+
+    /**
+     * @brief Construct a FlangerEffect
+     * @param rate       LFO rate in Hz [0.01 - 20] (ignored with a shared LFO)
+     * @param depth      Sweep depth [0.0 - 1.0], up to the full 0.2 - 5 ms range
+     * @param feedback   Delayed signal fed back into the line [-0.95 - 0.95]
+     * @param mix        Blend between dry (0.0) and wet (1.0) signal
+     * @param sampleRate Sampling rate of the audio system
+     * @param sharedLfo  LFO generated by the chain, or nullptr for the effect's own
+     */
+    FlangerEffect(float rate = 0.2f, float depth = 0.7f, float feedback = 0.5f, float mix = 0.5f,
+                  float sampleRate = 44100.0f, std::shared_ptr<const BlockLfo> sharedLfo = nullptr);
+
+    /** Size the delay lines for the sample rate */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Clear the delay lines */
+    void reset() override;
+    /** Longest delay times the repeats the feedback needs to decay */
+    double getTailTime() const override;
+
+    /// Set the sweep depth [0.0 - 1.0]
+    void setDepth(float depth);
+    /// Set the feedback [-0.95 - 0.95]
+    void setFeedback(float feedback);
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+    /// Set a parameter by id (see FlangerEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+protected:
+    void processModulated(float* left, float* right, unsigned int numFrames,
+                          const float* sine, const float* cosine) override;
+
+private:
+    ModulatedDelayLine m_lineLeft;   ///< Left channel line (input plus feedback)
+    ModulatedDelayLine m_lineRight;  ///< Right channel line
+    float m_sampleRate;              ///< Current sampling rate
+    float m_depth;                   ///< Sweep depth
+    float m_feedback;                ///< Feedback amount
+    float m_mix;                     ///< Wet/dry mix
+};
@@ -0,0 +1,18 @@
+#include "IEffect.h"
+
+constexpr float IEffect::kSilenceThreshold;
+
+// -----------------------------------------------------------------------------
+// IEffect default implementation
+// -----------------------------------------------------------------------------
+
+void IEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    // Fall back to the per-sample API for effects without a block kernel
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        std::pair<float, float> out = process({left[i], right[i]});
+        left[i] = out.first;
+        right[i] = out.second;
+    }
+}
@@ -7,6 +7,28 @@
  * @brief Interface for audio effect processors
  */
 
+/**
+ * @struct NoteEvent
+ * @brief Note activity forwarded to effects that follow the played pitch
+ */
+struct NoteEvent
+{
+    /**
+     * @brief What happened to the voice
+     */
+    enum class Type : unsigned char {
+        On,     ///< A voice started playing @c note
+        Off,    ///< The key for @c note was released
+        AllOff  ///< Every key was released (@c note is unused)
+    };
+
+    Type type;              ///< Kind of event
+    unsigned char note;     ///< MIDI note number (0-127)
+    unsigned char channel;  ///< MIDI channel (0-15)
+    float frequency;        ///< Note frequency in Hz
+    float velocity;         ///< Note velocity [0.0-1.0] (0 for Off)
+};
+
 /**
  * @interface IEffect
  * @brief Abstract interface for audio effects that process stereo samples
@@ -18,15 +40,47 @@
  * 
  * Effects should be designed to be stateless where possible, or provide proper
  * reset functionality for stateful effects.
+ * 
+ * Lifecycle: prepare() is called once on a control thread before the effect
+ * is handed to the audio thread; everything that allocates or depends on the
+ * sample rate belongs there. The audio thread then only calls processBlock(),
+ * setParameter(), onNoteEvent() and reset(), none of which may allocate.
  */
 class IEffect 
 {
 public:
+    /// Level below which a tail counts as decayed (-90 dBFS)
+    static constexpr float kSilenceThreshold = 3.1623e-5f;
+
     /**
      * @brief Virtual destructor to ensure proper cleanup of derived classes
      */
     virtual ~IEffect() = default;
 
+    /**
+     * @brief Prepare the effect for rendering
+     * 
+     * Called once on a control thread before the effect starts processing,
+     * so it is the place to size buffers and compute sample-rate dependent
+     * coefficients. processBlock() is never called with more than
+     * @p maxBlockSize frames afterwards.
+     * 
+     * @param sampleRate Sample rate in Hz
+     * @param maxBlockSize Largest number of frames passed to processBlock()
+     */
+    virtual void prepare(float sampleRate, unsigned int maxBlockSize) { (void)sampleRate; (void)maxBlockSize; }
+
+    /**
+     * @brief React to a note starting or being released
+     * 
+     * Called on the audio thread for every note event before the next block
+     * is processed. Most effects ignore notes; pitch-tracking effects use it
+     * to follow the played frequency. Must be cheap and must not allocate.
+     * 
+     * @param event The note event
+     */
+    virtual void onNoteEvent(const NoteEvent& event) { (void)event; }
+
     /**
      * @brief Process a stereo audio sample
      * 
@@ -42,6 +96,20 @@ public:
      */
     virtual std::pair<float, float> process(std::pair<float, float> stereoSample) = 0;
 
+    /**
+     * @brief Process a block of stereo audio in place
+     *
+     * The left and right channels are stored in separate (planar) buffers.
+     * The default implementation adapts to process() one frame at a time, so
+     * effects that only implement the per-sample API keep working. Effects on
+     * the hot path should override this with a dedicated block kernel.
+     *
+     * @param left Left channel samples, overwritten with the processed output
+     * @param right Right channel samples, overwritten with the processed output
+     * @param numFrames Number of frames in each buffer
+     */
+    virtual void processBlock(float* left, float* right, unsigned int numFrames);
+
     /**
      * @brief Reset the effect's internal state
      * 
@@ -54,4 +122,54 @@ public:
      * internal buffers and reset parameters to default states.
      */
     virtual void reset() {}
+
+    /**
+     * @brief Set a parameter identified by an effect-specific id
+     * 
+     * Generic entry point used by the audio thread to apply queued parameter
+     * commands without knowing the concrete effect type. Each effect defines
+     * its own parameter ids; unknown ids are ignored.
+     * 
+     * @param parameterId Effect-specific parameter identifier
+     * @param value New parameter value
+     */
+    virtual void setParameter(unsigned int parameterId, float value) { (void)parameterId; (void)value; }
+
+    /**
+     * @brief Delay the effect adds to the whole signal, in frames
+     * 
+     * Effects that process in blocks, look ahead or resample report their
+     * delay here so the host can add up the latency of the chain. Only valid
+     * after prepare(). Delays that are part of the sound (echoes, pre-delay)
+     * do not count.
+     * 
+     * @return Latency in frames at the prepared sample rate
+     */
+    virtual unsigned int getLatency() const { return 0; }
+
+    /**
+     * @brief How long the effect keeps sounding after its input falls silent
+     * 
+     * An upper bound, in seconds, on the time a full-scale signal needs to
+     * decay below kSilenceThreshold once the input stops (echoes, reverb
+     * tails, filter ringing). The host keeps running the chain for this long
+     * after the last voice has finished. Latency is reported separately and
+     * not included. Memoryless effects keep the default of 0.
+     * 
+     * @return Tail length in seconds for the current settings
+     */
+    virtual double getTailTime() const { return 0.0; }
+
+    /**
+     * @brief True if the effect holds nothing audible
+     * 
+     * Called on the audio thread between blocks while the host plays out
+     * the tails. A silent effect fed silence outputs silence, so the host
+     * may skip it, and once every effect is silent the host stops rendering
+     * the chain before the tails have run their full length. The default is
+     * exact for memoryless effects and conservative for effects with a tail:
+     * those that do not track their state are never silent, and the host
+     * simply waits out getTailTime().
+     */
+    virtual bool isSilent() const { return getTailTime() <= 0.0; }
 };
\ No newline at end of file
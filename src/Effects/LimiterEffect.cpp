@@ -0,0 +1,227 @@
+#include "LimiterEffect.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr unsigned int kTaps = 8;     ///< Interpolator taps per phase
+    constexpr unsigned int kPhases = 3;   ///< Points interpolated between two samples (4x)
+
+    /**
+     * @brief Hann-windowed sinc interpolator for the points 1/4, 2/4 and 3/4
+     *        of the way between the 4th and 5th of eight samples
+     */
+    struct TruePeakInterpolator {
+        float coefficients[kPhases][kTaps];
+
+        TruePeakInterpolator() {
+            const double pi = std::acos(-1.0);
+            for (unsigned int phase = 0; phase < kPhases; ++phase) {
+                const double position = 3.0 + (phase + 1) / 4.0;
+                double taps[kTaps];
+                double sum = 0.0;
+                for (unsigned int j = 0; j < kTaps; ++j) {
+                    double t = position - j;
+                    double window = 0.5 + 0.5 * std::cos(pi * t / 4.5);
+                    taps[j] = std::sin(pi * t) / (pi * t) * window;
+                    sum += taps[j];
+                }
+                // Unity gain at DC for every phase
+                for (unsigned int j = 0; j < kTaps; ++j) {
+                    coefficients[phase][j] = static_cast<float>(taps[j] / sum);
+                }
+            }
+        }
+    };
+
+    const TruePeakInterpolator kInterpolator;
+
+    /**
+     * @brief Largest magnitude of the three interpolated points of one channel
+     * @param window The last eight samples, oldest first
+     */
+    inline float interpolatedPeak(const float* window) {
+        float peak = 0.0f;
+        for (unsigned int phase = 0; phase < kPhases; ++phase) {
+            const float* c = kInterpolator.coefficients[phase];
+            float sum = 0.0f;
+            for (unsigned int j = 0; j < kTaps; ++j) {
+                sum += c[j] * window[j];
+            }
+            peak = std::max(peak, std::fabs(sum));
+        }
+        return peak;
+    }
+
+    float decibelsToGain(float decibels) {
+        return std::pow(10.0f, decibels / 20.0f);
+    }
+}
+
+constexpr unsigned int LimiterEffect::kDetectorDelay;
+
+LimiterEffect::LimiterEffect(float ceilingDb, float lookahead, float release, float sampleRate)
+    : m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f), m_ceiling(1.0f),
+      m_lookahead(std::min(std::max(lookahead, 0.0005f), 0.05f)), m_release(0.05f),
+      m_releaseCoefficient(0.0f), m_lookaheadFrames(0),
+      m_historyPosition(0), m_previousInterpolated(0.0f),
+      m_averagePosition(0), m_averageSum(0.0), m_smoothedGain(1.0f), m_currentGain(1.0f),
+      m_delayMask(0), m_delayPosition(0)
+{
+    setCeiling(ceilingDb);
+    setRelease(release);
+}
+
+void LimiterEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    (void)maxBlockSize;
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+    }
+    updateCoefficients();
+
+    m_lookaheadFrames = std::max(1u, static_cast<unsigned int>(m_lookahead * m_sampleRate + 0.5f));
+
+    // Holding over one frame more than the average guarantees every frame in
+    // the average has already seen the peak it is ramping toward
+    m_peakHold.prepare(m_lookaheadFrames + 1);
+    m_average.assign(m_lookaheadFrames, 1.0f);
+    m_history.assign(4 * kTaps, 0.0f);
+
+    unsigned int delaySize = 1;
+    while (delaySize < getLatency() + 1) {
+        delaySize <<= 1;
+    }
+    m_delayLeft.assign(delaySize, 0.0f);
+    m_delayRight.assign(delaySize, 0.0f);
+    m_delayMask = delaySize - 1;
+
+    reset();
+}
+
+std::pair<float, float> LimiterEffect::process(std::pair<float, float> stereoSample)
+{
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+float LimiterEffect::detectPeak(float left, float right)
+{
+    // Doubled rings: the last eight samples of a channel are always contiguous
+    float* historyLeft = m_history.data();
+    float* historyRight = historyLeft + 2 * kTaps;
+    const unsigned int position = m_historyPosition;
+    historyLeft[position] = historyLeft[position + kTaps] = left;
+    historyRight[position] = historyRight[position + kTaps] = right;
+    m_historyPosition = (position + 1) & (kTaps - 1);
+
+    const float* windowLeft = historyLeft + position + 1;
+    const float* windowRight = historyRight + position + 1;
+
+    const float interpolated = std::max(interpolatedPeak(windowLeft), interpolatedPeak(windowRight));
+    const float sample = std::max(std::fabs(windowLeft[kDetectorDelay - 1]), std::fabs(windowRight[kDetectorDelay - 1]));
+
+    // The sample sits between the previous interval and this one
+    const float peak = std::max(sample, std::max(interpolated, m_previousInterpolated));
+    m_previousInterpolated = interpolated;
+    return peak;
+}
+
+void LimiterEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    if (m_lookaheadFrames == 0) {
+        return; // Not prepared: pass through
+    }
+
+    const float ceiling = m_ceiling;
+    const float release = m_releaseCoefficient;
+    const unsigned int averageLength = m_lookaheadFrames;
+    const double averageScale = 1.0 / averageLength;
+    const unsigned int delay = getLatency();
+    const unsigned int mask = m_delayMask;
+    float* average = m_average.data();
+    float* delayLeft = m_delayLeft.data();
+    float* delayRight = m_delayRight.data();
+
+    float smoothed = m_smoothedGain;
+    double sum = m_averageSum;
+    unsigned int averagePosition = m_averagePosition;
+    unsigned int delayPosition = m_delayPosition;
+    float gain = m_currentGain;
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        // Gain that keeps the loudest upcoming peak at the ceiling
+        const float held = m_peakHold.push(detectPeak(left[i], right[i]));
+        const float target = held > ceiling ? ceiling / held : 1.0f;
+
+        // Drop at once, recover with the release time constant
+        smoothed = target < smoothed ? target : target + release * (smoothed - target);
+
+        // Averaging over the lookahead turns the drop into a ramp
+        sum += smoothed - average[averagePosition];
+        average[averagePosition] = smoothed;
+        averagePosition = averagePosition + 1 < averageLength ? averagePosition + 1 : 0;
+        gain = std::min(static_cast<float>(sum * averageScale), 1.0f);
+
+        delayLeft[delayPosition] = left[i];
+        delayRight[delayPosition] = right[i];
+        const unsigned int readPosition = (delayPosition - delay) & mask;
+        left[i] = delayLeft[readPosition] * gain;
+        right[i] = delayRight[readPosition] * gain;
+        delayPosition = (delayPosition + 1) & mask;
+    }
+
+    m_smoothedGain = smoothed;
+    m_averageSum = sum;
+    m_averagePosition = averagePosition;
+    m_delayPosition = delayPosition;
+    m_currentGain = gain;
+}
+
+void LimiterEffect::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_historyPosition = 0;
+    m_previousInterpolated = 0.0f;
+
+    m_peakHold.reset();
+    std::fill(m_average.begin(), m_average.end(), 1.0f);
+    m_averagePosition = 0;
+    m_averageSum = static_cast<double>(m_average.size());
+    m_smoothedGain = 1.0f;
+    m_currentGain = 1.0f;
+
+    std::fill(m_delayLeft.begin(), m_delayLeft.end(), 0.0f);
+    std::fill(m_delayRight.begin(), m_delayRight.end(), 0.0f);
+    m_delayPosition = 0;
+}
+
+void LimiterEffect::updateCoefficients()
+{
+    m_releaseCoefficient = std::exp(-1.0f / (m_release * m_sampleRate));
+}
+
+void LimiterEffect::setCeiling(float ceilingDb)
+{
+    m_ceiling = decibelsToGain(std::min(std::max(ceilingDb, -24.0f), 0.0f));
+}
+
+void LimiterEffect::setRelease(float seconds)
+{
+    m_release = std::min(std::max(seconds, 0.001f), 5.0f);
+    updateCoefficients();
+}
+
+void LimiterEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Ceiling: setCeiling(value); break;
+        case Release: setRelease(value); break;
+        default: break;
+    }
+}
+
+float LimiterEffect::getGainReduction() const
+{
+    return -20.0f * std::log10(std::max(m_currentGain, 1e-6f));
+}
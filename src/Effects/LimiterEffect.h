@@ -0,0 +1,91 @@
+#pragma once
+#include "IEffect.h"
+#include "DSP/SlidingWindowMax.h"
+#include <vector>
+
+/**
+ * @brief True-peak lookahead brickwall limiter
+ *
+ * The output is delayed by the lookahead so the gain can be brought down
+ * before a peak arrives instead of clipping it:
+ *  - The detector estimates the true (inter-sample) peak of both channels
+ *    with a 4x polyphase interpolator, so peaks that only appear after the
+ *    DAC's reconstruction filter are caught too.
+ *  - A sliding-window maximum over the lookahead gives the loudest peak
+ *    that will pass during the next lookahead frames, from which the gain
+ *    that keeps it at the ceiling follows.
+ *  - Release is a one-pole recovery; the gain is then averaged over the
+ *    lookahead, which turns every reduction into a smooth ramp that is
+ *    complete by the time the peak leaves the delay line.
+ *
+ * Because the averaged gain never exceeds the held minimum, the output
+ * stays at or below the ceiling. All buffers are sized in prepare().
+ */
+class LimiterEffect : public IEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Ceiling, Release };
+
+    static constexpr unsigned int kDetectorDelay = 4;   ///< Frames the true-peak interpolator lags its input
+
+    /**
+     * @brief Construct a LimiterEffect
+     * @param ceilingDb  Highest true-peak output level in dBTP [-24 - 0]
+     * @param lookahead  Lookahead time in seconds [0.0005 - 0.05]; sets most of the latency
+     * @param release    Time to recover from gain reduction, in seconds [0.001 - 5]
+     * @param sampleRate Sampling rate of the audio system
+     */
+    LimiterEffect(float ceilingDb = -1.0f, float lookahead = 0.005f, float release = 0.05f,
+                  float sampleRate = 44100.0f);
+
+    /** Size the lookahead buffers for the sample rate (allocates, control thread only) */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Process a stereo sample (routes through processBlock) */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+    /** Clear the delay line and release all gain reduction */
+    void reset() override;
+
+    /// Set the ceiling in dBTP [-24 - 0]
+    void setCeiling(float ceilingDb);
+    /// Set the release time in seconds [0.001 - 5]
+    void setRelease(float seconds);
+    /// Set a parameter by id (see LimiterEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+    /** Lookahead plus detector delay, in frames */
+    unsigned int getLatency() const override { return m_lookaheadFrames + kDetectorDelay; }
+    /// Current gain reduction in dB (0 or positive), for metering
+    float getGainReduction() const;
+
+private:
+    float m_sampleRate;                 ///< Current sampling rate
+    float m_ceiling;                    ///< Linear ceiling
+    float m_lookahead;                  ///< Lookahead time in seconds
+    float m_release;                    ///< Release time in seconds
+    float m_releaseCoefficient;         ///< Per-sample release smoothing
+    unsigned int m_lookaheadFrames;     ///< Lookahead in frames (0 until prepared)
+
+    std::vector<float> m_history;       ///< Detector input, 2 channels x doubled ring of 8
+    unsigned int m_historyPosition;     ///< Write position in the detector rings
+    float m_previousInterpolated;       ///< Largest interpolated peak of the previous interval
+
+    SlidingWindowMax m_peakHold;        ///< Loudest peak over the lookahead window
+    std::vector<float> m_average;       ///< Last m_lookaheadFrames smoothed gains
+    unsigned int m_averagePosition;     ///< Write position in m_average
+    double m_averageSum;                ///< Running sum of m_average
+    float m_smoothedGain;               ///< Held gain after release smoothing
+    float m_currentGain;                ///< Last gain applied
+
+    std::vector<float> m_delayLeft;     ///< Lookahead delay lines (power-of-two rings)
+    std::vector<float> m_delayRight;
+    unsigned int m_delayMask;           ///< Ring size - 1
+    unsigned int m_delayPosition;       ///< Write position in the delay lines
+
+    /** Recompute the release coefficient */
+    void updateCoefficients();
+    /** Push one frame into the detector and return its true-peak estimate */
+    float detectPeak(float left, float right);
+};
@@ -0,0 +1,50 @@
+#include "ModulatedEffect.h"
+#include <algorithm>
+#include <utility>
+
+ModulatedEffect::ModulatedEffect(float rate, std::shared_ptr<const BlockLfo> sharedLfo)
+    : m_lfo(rate), m_sharedLfo(std::move(sharedLfo))
+{
+}
+
+void ModulatedEffect::prepareLfo(float sampleRate, unsigned int maxBlockSize)
+{
+    m_lfo.prepare(sampleRate, maxBlockSize);
+}
+
+std::pair<float, float> ModulatedEffect::process(std::pair<float, float> stereoSample)
+{
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void ModulatedEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    // prepareLfo() runs in every subclass's prepare(), so an empty own LFO
+    // also means the subclass buffers are not sized yet
+    if (m_lfo.getMaxBlockFrames() == 0) {
+        return; // Not prepared: pass through
+    }
+
+    if (m_sharedLfo) {
+        // The owner generated exactly this block; longer blocks than the
+        // buffer only happen outside AudioSystem and reuse its values
+        const unsigned int capacity = m_sharedLfo->getMaxBlockFrames();
+        for (unsigned int offset = 0; capacity > 0 && offset < numFrames; offset += capacity) {
+            const unsigned int frames = std::min(numFrames - offset, capacity);
+            processModulated(left + offset, right + offset, frames, m_sharedLfo->getSine(), m_sharedLfo->getCosine());
+        }
+        return;
+    }
+
+    const unsigned int capacity = m_lfo.getMaxBlockFrames();
+    while (numFrames > 0)
+    {
+        const unsigned int frames = std::min(numFrames, capacity);
+        m_lfo.generate(frames);
+        processModulated(left, right, frames, m_lfo.getSine(), m_lfo.getCosine());
+        left += frames;
+        right += frames;
+        numFrames -= frames;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "IEffect.h"
+#include "DSP/BlockLfo.h"
+#include <memory>
+
+/**
+ * @brief Base class of the LFO-driven effects (chorus, flanger, phaser)
+ *
+ * Subclasses implement processModulated(), which receives the block's
+ * sine and cosine LFO values next to the audio, so the sweep costs no
+ * trigonometry per sample.
+ *
+ * The LFO is either the effect's own, rendered here per block at the
+ * effect's rate, or a BlockLfo shared with the rest of the chain. A shared
+ * LFO is generated by its owner before the effects run (SignalChain does so
+ * once per block), keeps all modulated effects in step and makes setRate()
+ * a no-op.
+ */
+class ModulatedEffect : public IEffect
+{
+public:
+    /** Process a stereo sample (routes through processBlock) */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+
+    /// Set the rate of the effect's own LFO in Hz [0.01 - 20]
+    void setRate(float rate) { m_lfo.setRate(rate); }
+    /// Rate of the LFO in use, in Hz
+    float getRate() const { return m_sharedLfo ? m_sharedLfo->getRate() : m_lfo.getRate(); }
+    /// True if the effect follows a shared LFO
+    bool usesSharedLfo() const { return m_sharedLfo != nullptr; }
+
+protected:
+    /**
+     * @param rate      Rate of the effect's own LFO in Hz
+     * @param sharedLfo LFO generated by the chain, or nullptr to use the effect's own
+     */
+    ModulatedEffect(float rate, std::shared_ptr<const BlockLfo> sharedLfo);
+
+    /** Size the effect's own LFO (allocates, call from prepare()) */
+    void prepareLfo(float sampleRate, unsigned int maxBlockSize);
+    /** Restart the effect's own LFO */
+    void resetLfo() { m_lfo.reset(); }
+
+    /**
+     * @brief Process audio with the matching LFO values
+     * @param sine   LFO sine, one value per frame [-1, 1]
+     * @param cosine LFO a quarter period ahead, one value per frame [-1, 1]
+     */
+    virtual void processModulated(float* left, float* right, unsigned int numFrames,
+                                  const float* sine, const float* cosine) = 0;
+
+private:
+    BlockLfo m_lfo;                             ///< Own LFO, used without a shared one
+    std::shared_ptr<const BlockLfo> m_sharedLfo; ///< Chain LFO, or nullptr
+};
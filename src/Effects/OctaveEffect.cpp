@@ -2,15 +2,54 @@
 #include <cmath>
 #include <algorithm>
 
+namespace {
+    constexpr float kRampTime = 0.02f;   ///< Blend and gate ramp length in seconds
+}
+
 OctaveEffect::OctaveEffect(bool higher, float blend)
     : m_higher(higher), 
       m_blend(std::min(std::max(blend, 0.0f), 1.0f)), 
+      m_gate(1.0f),
+      m_heldNotes{},
       m_phase(0.0f), 
       m_frequency(0.0f), 
       m_sampleRate(44100.0f) // Default sample rate
 {
 }
 
+void OctaveEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    setSampleRate(sampleRate);
+    m_blend.prepare(m_sampleRate, kRampTime, maxBlockSize);
+    m_gate.prepare(m_sampleRate, kRampTime, maxBlockSize);
+}
+
+void OctaveEffect::onNoteEvent(const NoteEvent& event)
+{
+    if (event.note >= 128) {
+        return;
+    }
+
+    // Track the held keys; the octave fades out once the last one is released
+    uint32_t& word = m_heldNotes[event.note / 32];
+    const uint32_t bit = 1u << (event.note % 32);
+    switch (event.type) {
+        case NoteEvent::Type::On:
+            word |= bit;
+            setFrequency(event.frequency);
+            break;
+        case NoteEvent::Type::Off:
+            word &= ~bit;
+            break;
+        case NoteEvent::Type::AllOff:
+            std::fill(m_heldNotes, m_heldNotes + 4, 0u);
+            break;
+    }
+
+    const bool held = (m_heldNotes[0] | m_heldNotes[1] | m_heldNotes[2] | m_heldNotes[3]) != 0;
+    m_gate.setTargetValue(held ? 1.0f : 0.0f);
+}
+
 std::pair<float, float> OctaveEffect::process(std::pair<float, float> stereoSample) 
 {
     // Early return if invalid parameters
@@ -37,15 +76,99 @@ std::pair<float, float> OctaveEffect::process(std::pair<float, float> stereoSamp
     }
 
     // Blend the original and octave samples
-    float leftChannel = (1.0f - m_blend) * stereoSample.first + m_blend * octaveSample;
-    float rightChannel = (1.0f - m_blend) * stereoSample.second + m_blend * octaveSample;
+    m_blend.isSmoothing();
+    m_gate.isSmoothing();
+    const float blend = m_blend.getNextValue();
+    const float wet = blend * m_gate.getNextValue();
+    float leftChannel = (1.0f - blend) * stereoSample.first + wet * octaveSample;
+    float rightChannel = (1.0f - blend) * stereoSample.second + wet * octaveSample;
 
     return {leftChannel, rightChannel};
 }
 
+void OctaveEffect::processBlock(float* left, float* right, unsigned int numFrames) 
+{
+    // Early return if invalid parameters (signal passes through unchanged)
+    if (m_frequency <= 0.0f || m_sampleRate <= 0.0f) 
+    {
+        return;
+    }
+
+    float octaveFrequency = m_frequency * (m_higher ? 2.0f : 0.5f);
+    float phaseIncrement = octaveFrequency / m_sampleRate;
+    if (phaseIncrement >= 1.0f) 
+    {
+        phaseIncrement = std::fmod(phaseIncrement, 1.0f);
+    }
+
+    float phase = m_phase;
+
+    // Ramp the blend and gate per frame only while one of them is moving
+    const bool blendMoving = m_blend.isSmoothing();
+    const bool gateMoving = m_gate.isSmoothing();
+    if ((blendMoving || gateMoving) && m_blend.getMaxBlockFrames() >= numFrames)
+    {
+        const float* blend = m_blend.getBlock(numFrames);
+        const float* gate = m_gate.getBlock(numFrames);
+        for (unsigned int i = 0; i < numFrames; ++i) 
+        {
+            const float wet = blend[i] * gate[i];
+            float octaveSample = (phase < 0.5f) ? wet : -wet;
+            left[i] = (1.0f - blend[i]) * left[i] + octaveSample;
+            right[i] = (1.0f - blend[i]) * right[i] + octaveSample;
+
+            phase += phaseIncrement;
+            if (phase >= 1.0f) 
+            {
+                phase -= 1.0f;
+            }
+        }
+        m_phase = phase;
+        return;
+    }
+
+    const float dry = 1.0f - m_blend.getCurrentValue();
+    const float wet = m_blend.getCurrentValue() * m_gate.getCurrentValue();
+
+    for (unsigned int i = 0; i < numFrames; ++i) 
+    {
+        float octaveSample = (phase < 0.5f) ? wet : -wet;
+        left[i] = dry * left[i] + octaveSample;
+        right[i] = dry * right[i] + octaveSample;
+
+        phase += phaseIncrement;
+        if (phase >= 1.0f) 
+        {
+            phase -= 1.0f;
+        }
+    }
+
+    // Blocks larger than prepared step the ramps at block rate
+    m_blend.skip(numFrames);
+    m_gate.skip(numFrames);
+    m_phase = phase;
+}
+
+double OctaveEffect::getTailTime() const
+{
+    return static_cast<double>(kRampTime);
+}
+
+bool OctaveEffect::isSilent() const
+{
+    if (m_frequency <= 0.0f) {
+        return true;
+    }
+    return (m_gate.getCurrentValue() == 0.0f && m_gate.getTargetValue() == 0.0f) ||
+           (m_blend.getCurrentValue() == 0.0f && m_blend.getTargetValue() == 0.0f);
+}
+
 void OctaveEffect::reset() 
 {
     m_phase = 0.0f;
+    std::fill(m_heldNotes, m_heldNotes + 4, 0u);
+    m_blend.reset();
+    m_gate.reset();
 }
 
 void OctaveEffect::setHigher(bool higher) 
@@ -55,7 +178,7 @@ void OctaveEffect::setHigher(bool higher)
 
 void OctaveEffect::setBlend(float blend) 
 {
-    m_blend = std::min(std::max(blend, 0.0f), 1.0f);
+    m_blend.setTargetValue(std::min(std::max(blend, 0.0f), 1.0f));
 }
 
 void OctaveEffect::setFrequency(float frequency) 
@@ -66,6 +189,15 @@ void OctaveEffect::setFrequency(float frequency)
     }
 }
 
+void OctaveEffect::setParameter(unsigned int parameterId, float value) 
+{
+    switch (parameterId) {
+        case Higher: setHigher(value != 0.0f); break;
+        case Blend:  setBlend(value);          break;
+        default: break;
+    }
+}
+
 void OctaveEffect::setSampleRate(float sampleRate) 
 {
     // Validate sample rate
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "IEffect.h"
+#include "DSP/SmoothedParameter.h"
+#include <cstdint>
 
 /**
  * @file OctaveEffect.h
@@ -17,11 +19,22 @@
  * and synthesizers.
  * 
  * The effect works by tracking the input signal's frequency and generating
- * a synthetic waveform at the desired octave interval.
+ * a synthetic waveform at the desired octave interval. Blend changes ramp
+ * over a few milliseconds instead of stepping. Once note events are seen,
+ * the synthetic wave fades out when the last key is released, so echoes
+ * and reverb tails after the octave ring out without it.
  */
 class OctaveEffect : public IEffect 
 {
 public:
+    /**
+     * @brief Parameter ids accepted by setParameter()
+     */
+    enum Parameter : unsigned int { 
+        Higher,     ///< Non-zero selects the higher octave, zero the lower
+        Blend       ///< Blend factor [0.0-1.0]
+    };
+
     /**
      * @brief Constructs an OctaveEffect with specified parameters
      * 
@@ -31,6 +44,21 @@ public:
      */
     OctaveEffect(bool higher = true, float blend = 0.5f);
 
+    /**
+     * @brief Store the sample rate used for phase calculation
+     * 
+     * @param sampleRate Sample rate in Hz
+     * @param maxBlockSize Largest block, sizes the blend ramp
+     */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+
+    /**
+     * @brief Follow the most recently started note and the held keys
+     * 
+     * @param event Note event; NoteEvent::Type::On also sets the frequency
+     */
+    void onNoteEvent(const NoteEvent& event) override;
+
     /**
      * @brief Process a stereo sample with octave effect
      * 
@@ -38,11 +66,24 @@ public:
      * @return Processed sample with octave effect applied
      */
     std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+
+    /**
+     * @brief Process a block of planar stereo samples in place
+     * 
+     * @param left Left channel buffer
+     * @param right Right channel buffer
+     * @param numFrames Number of frames to process
+     */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
     
     /**
      * @brief Reset the internal phase and state
      */
     void reset() override;
+    /** Fade-out time of the octave after the last key is released */
+    double getTailTime() const override;
+    /** True while the octave is faded out, so only the dry signal passes */
+    bool isSilent() const override;
 
     /**
      * @brief Set whether to generate higher or lower octave
@@ -68,9 +109,18 @@ public:
      */
     void setSampleRate(float sampleRate);
 
+    /**
+     * @brief Set a parameter by id
+     * @param parameterId One of OctaveEffect::Parameter
+     * @param value New parameter value
+     */
+    void setParameter(unsigned int parameterId, float value) override;
+
 private:
     bool m_higher;          ///< Whether the effect generates higher or lower octave
-    float m_blend;          ///< Blending factor between original and octave sample [0.0-1.0]
+    SmoothedParameter<float> m_blend; ///< Blending factor between original and octave sample [0.0-1.0]
+    SmoothedParameter<float> m_gate;  ///< Octave level, 1 while a key is held (or before any note event)
+    uint32_t m_heldNotes[4];          ///< One bit per held MIDI note
     float m_phase;          ///< Phase accumulator for generating the octave wave [0.0-1.0)
     float m_frequency;      ///< Fundamental frequency in Hz
     float m_sampleRate;     ///< Sample rate in Hz
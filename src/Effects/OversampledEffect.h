@@ -0,0 +1,109 @@
+#pragma once
+#include "IEffect.h"
+#include "DSP/Oversampler.h"
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Runs any effect at 2x, 4x or 8x the sample rate
+ *
+ * Nonlinear effects create harmonics above Nyquist that fold back as
+ * inharmonic aliases. Wrapping them in OversampledEffect gives those
+ * harmonics room: the input is interpolated, the inner effect runs at the
+ * higher rate, and the result is lowpassed and decimated back, discarding
+ * everything above the audio band.
+ *
+ * The wrapped effect is owned by value and constructed in place, so the
+ * inner processBlock() call is not virtual. Parameters, note events and
+ * resets are forwarded; getLatency() adds the resampling delay to the inner
+ * effect's own latency.
+ *
+ * @tparam Effect Concrete IEffect implementation to wrap
+ */
+template <typename Effect>
+class OversampledEffect : public IEffect
+{
+public:
+    /**
+     * @brief Construct the wrapper and the inner effect
+     * @param factor Oversampling factor: 1, 2, 4 or 8
+     * @param args   Arguments forwarded to the Effect constructor
+     * @throws std::invalid_argument for an unsupported factor
+     */
+    template <typename... Args>
+    explicit OversampledEffect(unsigned int factor, Args&&... args)
+        : m_oversampler(factor), m_effect(std::forward<Args>(args)...)
+    {
+    }
+
+    /** Size the resampling buffers and prepare the inner effect at the high rate */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override
+    {
+        m_oversampler.prepare(maxBlockSize);
+        m_effect.prepare(sampleRate * m_oversampler.getFactor(), maxBlockSize * m_oversampler.getFactor());
+    }
+
+    /** Process a stereo sample (routes through processBlock) */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override
+    {
+        processBlock(&stereoSample.first, &stereoSample.second, 1);
+        return stereoSample;
+    }
+
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override
+    {
+        const unsigned int factor = m_oversampler.getFactor();
+        const unsigned int maxFrames = m_oversampler.getMaxBlockFrames();
+        if (maxFrames == 0) {
+            return; // Not prepared: pass through
+        }
+
+        while (numFrames > 0)
+        {
+            unsigned int frames = std::min(numFrames, maxFrames);
+            m_oversampler.upsample(left, right, frames);
+            m_effect.processBlock(m_oversampler.getLeft(), m_oversampler.getRight(), frames * factor);
+            m_oversampler.downsample(left, right, frames);
+
+            left += frames;
+            right += frames;
+            numFrames -= frames;
+        }
+    }
+
+    /** Reset the resampling filters and the inner effect */
+    void reset() override
+    {
+        m_oversampler.reset();
+        m_effect.reset();
+    }
+
+    /** Forward note events to the inner effect */
+    void onNoteEvent(const NoteEvent& event) override { m_effect.onNoteEvent(event); }
+
+    /** Forward parameters to the inner effect */
+    void setParameter(unsigned int parameterId, float value) override { m_effect.setParameter(parameterId, value); }
+
+    /** Resampling delay plus the inner effect's latency, in base-rate frames */
+    unsigned int getLatency() const override
+    {
+        const unsigned int factor = m_oversampler.getFactor();
+        return m_oversampler.getLatency() + (m_effect.getLatency() + factor - 1) / factor;
+    }
+
+    /** Tail of the inner effect (the resampling delay is part of getLatency()) */
+    double getTailTime() const override { return m_effect.getTailTime(); }
+
+    /** Silence of the inner effect */
+    bool isSilent() const override { return m_effect.isSilent(); }
+
+    /// The wrapped effect, for direct configuration on the control thread
+    Effect& getEffect() { return m_effect; }
+    /// Oversampling factor
+    unsigned int getFactor() const { return m_oversampler.getFactor(); }
+
+private:
+    Oversampler m_oversampler;  ///< Up/down sampling stages and buffers
+    Effect m_effect;            ///< Effect running at the high rate
+};
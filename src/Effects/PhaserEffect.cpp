@@ -0,0 +1,129 @@
+#include "PhaserEffect.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    constexpr float kMinFrequency = 200.0f;   ///< Bottom of the sweep in Hz
+    constexpr float kSweepRange = 20.0f;      ///< Top of the sweep relative to the bottom at full depth
+}
+
+constexpr unsigned int PhaserEffect::kStages;
+constexpr unsigned int PhaserEffect::kControlFrames;
+
+PhaserEffect::PhaserEffect(float rate, float depth, float feedback, float mix, float sampleRate,
+                           std::shared_ptr<const BlockLfo> sharedLfo)
+    : ModulatedEffect(rate, std::move(sharedLfo)),
+      m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f), m_depth(0.7f), m_feedback(0.5f), m_mix(0.5f)
+{
+    setDepth(depth);
+    setFeedback(feedback);
+    setMix(mix);
+    reset();
+}
+
+void PhaserEffect::prepare(float sampleRate, unsigned int maxBlockSize)
+{
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+    }
+    prepareLfo(m_sampleRate, maxBlockSize);
+    reset();
+}
+
+float PhaserEffect::computeCoefficient(float lfo) const
+{
+    const float position = m_depth * (0.5f + 0.5f * lfo);
+    const float frequency = std::min(kMinFrequency * std::pow(kSweepRange, position), 0.45f * m_sampleRate);
+    const float t = std::tan(std::acos(-1.0f) * frequency / m_sampleRate);
+    return (t - 1.0f) / (t + 1.0f);
+}
+
+void PhaserEffect::processModulated(float* left, float* right, unsigned int numFrames,
+                                    const float* sine, const float* cosine)
+{
+    const float feedback = m_feedback;
+    const float dry = 1.0f - m_mix;
+    const float wet = m_mix;
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        if (m_count == 0) {
+            // Ramp over the next kControlFrames toward the current LFO value;
+            // the grid carries over between calls, like the compressor's
+            const float frames = static_cast<float>(kControlFrames);
+            m_stepLeft = (computeCoefficient(sine[i]) - m_coefficientLeft) / frames;
+            m_stepRight = (computeCoefficient(cosine[i]) - m_coefficientRight) / frames;
+            m_count = kControlFrames;
+        }
+        m_coefficientLeft += m_stepLeft;
+        m_coefficientRight += m_stepRight;
+        --m_count;
+
+        const float a = m_coefficientLeft;
+        const float b = m_coefficientRight;
+        float x = left[i] + feedback * m_lastLeft;
+        float y = right[i] + feedback * m_lastRight;
+        for (unsigned int stage = 0; stage < kStages; ++stage) {
+            // Transposed direct form: y = a*x + s, s = x - a*y
+            const float outLeft = a * x + m_stateLeft[stage];
+            m_stateLeft[stage] = x - a * outLeft;
+            x = outLeft;
+            const float outRight = b * y + m_stateRight[stage];
+            m_stateRight[stage] = y - b * outRight;
+            y = outRight;
+        }
+        m_lastLeft = x;
+        m_lastRight = y;
+
+        left[i] = dry * left[i] + wet * x;
+        right[i] = dry * right[i] + wet * y;
+    }
+}
+
+void PhaserEffect::reset()
+{
+    std::fill(m_stateLeft, m_stateLeft + kStages, 0.0f);
+    std::fill(m_stateRight, m_stateRight + kStages, 0.0f);
+    m_lastLeft = 0.0f;
+    m_lastRight = 0.0f;
+    m_coefficientLeft = m_coefficientRight = computeCoefficient(0.0f);
+    m_stepLeft = m_stepRight = 0.0f;
+    m_count = 0;
+    resetLfo();
+}
+
+double PhaserEffect::getTailTime() const
+{
+    // Each first-order stage decays with a time constant of 1 / (2 pi f);
+    // feedback stretches the chain's decay by 1 / (1 - |feedback|)
+    const double pi = std::acos(-1.0);
+    const double stages = -std::log(static_cast<double>(kSilenceThreshold)) * kStages / (2.0 * pi * kMinFrequency);
+    return stages / (1.0 - std::fabs(m_feedback));
+}
+
+void PhaserEffect::setDepth(float depth)
+{
+    m_depth = std::min(std::max(depth, 0.0f), 1.0f);
+}
+
+void PhaserEffect::setFeedback(float feedback)
+{
+    m_feedback = std::min(std::max(feedback, -0.95f), 0.95f);
+}
+
+void PhaserEffect::setMix(float mix)
+{
+    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+}
+
+void PhaserEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Rate:     setRate(value);     break;
+        case Depth:    setDepth(value);    break;
+        case Feedback: setFeedback(value); break;
+        case Mix:      setMix(value);      break;
+        default: break;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "ModulatedEffect.h"
+
+/**
+ * @brief Stereo phaser
+ *
+ * A chain of kStages first-order allpass filters per channel shifts the
+ * phase of the signal; mixed with the dry signal this gives kStages / 2
+ * notches, which the LFO sweeps between 200 Hz and 4 kHz on a logarithmic
+ * scale. Feedback from the last stage sharpens the notches. The right
+ * channel follows the cosine of the LFO.
+ *
+ * The allpass coefficient needs a tan() of the sweep frequency, so it is
+ * computed at control rate (every kControlFrames frames) and ramped
+ * linearly in between. The ramp trails the LFO by one control step, which
+ * is inaudible at LFO rates.
+ */
+class PhaserEffect : public ModulatedEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Rate, Depth, Feedback, Mix };
+
+    static constexpr unsigned int kStages = 6;          ///< Allpass stages per channel
+    static constexpr unsigned int kControlFrames = 16;  ///< Frames per coefficient update
+
+    /**
+     * @brief Construct a PhaserEffect
+     * @param rate       LFO rate in Hz [0.01 - 20] (ignored with a shared LFO)
+     * @param depth      Sweep depth [0.0 - 1.0], up to the full 200 Hz - 4 kHz range
+     * @param feedback   Last stage fed back into the first [-0.95 - 0.95]
+     * @param mix        Blend between dry (0.0) and wet (1.0) signal
+     * @param sampleRate Sampling rate of the audio system
+     * @param sharedLfo  LFO generated by the chain, or nullptr for the effect's own
+     */
+    PhaserEffect(float rate = 0.4f, float depth = 0.7f, float feedback = 0.5f, float mix = 0.5f,
+                 float sampleRate = 44100.0f, std::shared_ptr<const BlockLfo> sharedLfo = nullptr);
+
+    /** Set the sample rate and size the LFO */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Clear the allpass states */
+    void reset() override;
+    /** Decay time of the allpass chain at the bottom of the sweep */
+    double getTailTime() const override;
+
+    /// Set the sweep depth [0.0 - 1.0]
+    void setDepth(float depth);
+    /// Set the feedback [-0.95 - 0.95]
+    void setFeedback(float feedback);
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+    /// Set a parameter by id (see PhaserEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+protected:
+    void processModulated(float* left, float* right, unsigned int numFrames,
+                          const float* sine, const float* cosine) override;
+
+private:
+    float m_sampleRate;             ///< Current sampling rate
+    float m_depth;                  ///< Sweep depth
+    float m_feedback;               ///< Feedback amount
+    float m_mix;                    ///< Wet/dry mix
+
+    float m_stateLeft[kStages];     ///< Allpass states, left channel
+    float m_stateRight[kStages];    ///< Allpass states, right channel
+    float m_lastLeft;               ///< Last stage output, for feedback
+    float m_lastRight;
+
+    float m_coefficientLeft;        ///< Allpass coefficient of the current frame
+    float m_coefficientRight;
+    float m_stepLeft;               ///< Per-frame coefficient ramp
+    float m_stepRight;
+    unsigned int m_count;           ///< Frames left until the next coefficient update
+
+    /** Allpass coefficient for an LFO value */
+    float computeCoefficient(float lfo) const;
+};
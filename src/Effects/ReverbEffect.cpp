@@ -0,0 +1,371 @@
+#include "ReverbEffect.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define REVERB_HAS_SSE 1
+#include <emmintrin.h>
+// Let the SSE kernel be built even when the baseline target lacks SSE2
+#if defined(__GNUC__) && !defined(__SSE2__)
+#define REVERB_SSE_TARGET __attribute__((target("sse2")))
+#else
+#define REVERB_SSE_TARGET
+#endif
+#else
+#define REVERB_HAS_SSE 0
+#endif
+
+constexpr unsigned int ReverbEffect::kLines;
+
+namespace {
+    constexpr float kPi = 3.14159265358979f;
+    constexpr float kGlideTime = 0.1f;       ///< Size change glide time constant in seconds
+    constexpr float kMaxScale = 2.0f;        ///< Line length scale at size 1.0
+    constexpr float kMinScale = 0.3f;        ///< Line length scale at size 0.0
+    constexpr float kModDepth = 0.00025f;    ///< Read position modulation depth in seconds
+    constexpr float kMatrixScale = 0.35355339f; ///< 1 / sqrt(kLines), keeps the Hadamard matrix orthonormal
+    constexpr float kOutputGain = 0.35f;     ///< Wet level so a mid-size room sits near the dry level
+
+    /// Line lengths in milliseconds at scale 1.0, chosen to share no common periods
+    constexpr float kBaseLengths[ReverbEffect::kLines] = {31.3f, 37.9f, 41.9f, 47.3f, 53.1f, 59.9f, 67.7f, 73.3f};
+    /// LFO rates in Hz, one per line
+    constexpr float kLfoRates[ReverbEffect::kLines] = {0.31f, 0.43f, 0.53f, 0.61f, 0.67f, 0.73f, 0.83f, 0.89f};
+    /// Sign of the input fed into each line; even lines take the left input, odd lines the right
+    constexpr float kInputSigns[ReverbEffect::kLines] = {1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f};
+
+    /**
+     * @brief Portable kernel: damp, scale and mix the line outputs
+     *
+     * @param taps Line outputs on entry, values to write back on exit
+     */
+    void feedbackScalar(ReverbEffect::Network& n, float* taps, float& outLeft, float& outRight) {
+        float v[ReverbEffect::kLines];
+        for (unsigned int i = 0; i < ReverbEffect::kLines; ++i) {
+            n.damping[i] = taps[i] + n.dampCoefficient * (n.damping[i] - taps[i]);
+            v[i] = n.damping[i] * n.gain[i];
+        }
+
+        outLeft = v[0] + v[2] + v[4] + v[6];
+        outRight = v[1] + v[3] + v[5] + v[7];
+
+        // Fast Walsh-Hadamard transform, three butterfly stages
+        for (unsigned int half = 1; half < ReverbEffect::kLines; half <<= 1) {
+            for (unsigned int start = 0; start < ReverbEffect::kLines; start += 2 * half) {
+                for (unsigned int k = start; k < start + half; ++k) {
+                    float a = v[k];
+                    float b = v[k + half];
+                    v[k] = a + b;
+                    v[k + half] = a - b;
+                }
+            }
+        }
+        for (unsigned int i = 0; i < ReverbEffect::kLines; ++i) {
+            taps[i] = v[i] * kMatrixScale;
+        }
+    }
+
+#if REVERB_HAS_SSE
+    /**
+     * @brief 4-point Hadamard transform within one register
+     */
+    REVERB_SSE_TARGET
+    inline __m128 hadamard4(__m128 x) {
+        const __m128 signs1 = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+        const __m128 signs2 = _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f);
+        // (x0 + x1, x0 - x1, x2 + x3, x2 - x3)
+        __m128 even = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 odd = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 1, 1));
+        x = _mm_add_ps(even, _mm_mul_ps(odd, signs1));
+        // (s0 + s2, s1 + s3, s0 - s2, s1 - s3)
+        __m128 low = _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 1, 0));
+        __m128 high = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 2, 3, 2));
+        return _mm_add_ps(low, _mm_mul_ps(high, signs2));
+    }
+
+    /**
+     * @brief SSE kernel: the eight lines live in two registers
+     */
+    REVERB_SSE_TARGET
+    void feedbackSse(ReverbEffect::Network& n, float* taps, float& outLeft, float& outRight) {
+        const __m128 coefficient = _mm_set1_ps(n.dampCoefficient);
+        const __m128 scale = _mm_set1_ps(kMatrixScale);
+
+        __m128 a = _mm_loadu_ps(taps);
+        __m128 b = _mm_loadu_ps(taps + 4);
+        __m128 dampA = _mm_loadu_ps(n.damping);
+        __m128 dampB = _mm_loadu_ps(n.damping + 4);
+
+        dampA = _mm_add_ps(a, _mm_mul_ps(coefficient, _mm_sub_ps(dampA, a)));
+        dampB = _mm_add_ps(b, _mm_mul_ps(coefficient, _mm_sub_ps(dampB, b)));
+        _mm_storeu_ps(n.damping, dampA);
+        _mm_storeu_ps(n.damping + 4, dampB);
+
+        a = _mm_mul_ps(dampA, _mm_loadu_ps(n.gain));
+        b = _mm_mul_ps(dampB, _mm_loadu_ps(n.gain + 4));
+
+        // Even lines to the left output, odd lines to the right
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(a, b));
+        outLeft = lanes[0] + lanes[2];
+        outRight = lanes[1] + lanes[3];
+
+        // 8-point Hadamard: one butterfly across the registers, then 4 points within each
+        __m128 sum = _mm_add_ps(a, b);
+        __m128 difference = _mm_sub_ps(a, b);
+        _mm_storeu_ps(taps, _mm_mul_ps(hadamard4(sum), scale));
+        _mm_storeu_ps(taps + 4, _mm_mul_ps(hadamard4(difference), scale));
+    }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// ReverbEffect implementation
+// -----------------------------------------------------------------------------
+
+ReverbEffect::ReverbEffect(float size, float decay, float damping, float mix, float sampleRate)
+    : m_lineSize(0), m_index(0), m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f),
+      m_size(0.5f), m_decay(2.0f), m_damping(0.5f), m_mix(0.25f), m_useSimd(isSimdAvailable()),
+      m_modDepth(0.0f), m_glide(1.0f)
+{
+    m_network.dampCoefficient = 0.0f;
+    setSize(size);
+    setDecay(decay);
+    setDamping(damping);
+    setMix(mix);
+    allocateBuffers();
+}
+
+void ReverbEffect::prepare(float sampleRate, unsigned int /*maxBlockSize*/)
+{
+    // Only reallocate if the rate differs from the one given at construction
+    if (sampleRate > 0.0f && sampleRate != m_sampleRate) {
+        setSampleRate(sampleRate);
+    }
+}
+
+std::pair<float, float> ReverbEffect::process(std::pair<float, float> stereoSample)
+{
+    // Single-frame block keeps the per-sample API on the same code path
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void ReverbEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    float* buffer = m_buffer.data();
+    const unsigned int lineSize = m_lineSize;
+    const unsigned int mask = lineSize - 1;
+    const float dry = 1.0f - m_mix;
+    const float wet = m_mix * kOutputGain;
+    const float glide = m_glide;
+    const float depth = m_modDepth;
+    unsigned int index = m_index;
+
+    // Work on local copies so the compiler can keep them in registers
+    // across the writes into the delay lines
+    float length[kLines];
+    float lfoCos[kLines];
+    float lfoSin[kLines];
+    std::copy(m_length, m_length + kLines, length);
+    std::copy(m_lfoCos, m_lfoCos + kLines, lfoCos);
+    std::copy(m_lfoSin, m_lfoSin + kLines, lfoSin);
+
+    for (unsigned int frame = 0; frame < numFrames; ++frame)
+    {
+        float taps[kLines];
+        unsigned int whole[kLines];
+        float fraction[kLines];
+
+        for (unsigned int i = 0; i < kLines; ++i)
+        {
+            length[i] += glide * (m_targetLength[i] - length[i]);
+
+            // Rotate the LFO phasor one sample forward
+            float c = lfoCos[i] * m_lfoRotCos[i] - lfoSin[i] * m_lfoRotSin[i];
+            float s = lfoSin[i] * m_lfoRotCos[i] + lfoCos[i] * m_lfoRotSin[i];
+            lfoCos[i] = c;
+            lfoSin[i] = s;
+
+            float delay = length[i] + depth * (1.0f + s);
+            whole[i] = static_cast<unsigned int>(delay);
+            fraction[i] = delay - static_cast<float>(whole[i]);
+        }
+
+        // Linear interpolation between the two samples around each read position
+        for (unsigned int i = 0; i < kLines; ++i)
+        {
+            const float* line = buffer + i * lineSize;
+            unsigned int newer = (index - whole[i]) & mask;
+            unsigned int older = (newer - 1) & mask;
+            taps[i] = line[newer] + fraction[i] * (line[older] - line[newer]);
+        }
+
+        float outLeft;
+        float outRight;
+#if REVERB_HAS_SSE
+        if (m_useSimd) {
+            feedbackSse(m_network, taps, outLeft, outRight);
+        } else {
+            feedbackScalar(m_network, taps, outLeft, outRight);
+        }
+#else
+        feedbackScalar(m_network, taps, outLeft, outRight);
+#endif
+
+        const float inLeft = left[frame];
+        const float inRight = right[frame];
+        for (unsigned int i = 0; i < kLines; i += 2) {
+            buffer[i * lineSize + index] = taps[i] + kInputSigns[i] * inLeft;
+            buffer[(i + 1) * lineSize + index] = taps[i + 1] + kInputSigns[i + 1] * inRight;
+        }
+
+        left[frame] = dry * inLeft + wet * outLeft;
+        right[frame] = dry * inRight + wet * outRight;
+
+        index = (index + 1) & mask;
+    }
+
+    m_index = index;
+    std::copy(length, length + kLines, m_length);
+
+    // Keep the LFO phasors on the unit circle despite rounding
+    for (unsigned int i = 0; i < kLines; ++i) {
+        float norm = 1.0f / std::sqrt(lfoCos[i] * lfoCos[i] + lfoSin[i] * lfoSin[i]);
+        m_lfoCos[i] = lfoCos[i] * norm;
+        m_lfoSin[i] = lfoSin[i] * norm;
+    }
+}
+
+void ReverbEffect::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0f);
+    std::fill(m_network.damping, m_network.damping + kLines, 0.0f);
+    m_index = 0;
+    std::copy(m_targetLength, m_targetLength + kLines, m_length);
+}
+
+void ReverbEffect::setSampleRate(float sampleRate)
+{
+    if (sampleRate > 0.0f) {
+        m_sampleRate = sampleRate;
+        allocateBuffers();
+    }
+}
+
+void ReverbEffect::setSize(float size)
+{
+    m_size = std::min(std::max(size, 0.0f), 1.0f);
+    if (m_lineSize > 0) {
+        updateLengths();
+    }
+}
+
+void ReverbEffect::setDecay(float seconds)
+{
+    m_decay = std::min(std::max(seconds, 0.1f), 30.0f);
+    if (m_lineSize > 0) {
+        updateGains();
+    }
+}
+
+void ReverbEffect::setDamping(float damping)
+{
+    m_damping = std::min(std::max(damping, 0.0f), 1.0f);
+    // Lowpass pole of the feedback path; stop short of 1 so the tail never freezes
+    m_network.dampCoefficient = 0.9f * m_damping;
+}
+
+void ReverbEffect::setMix(float mix)
+{
+    // Clamp mix to valid range
+    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+}
+
+void ReverbEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Size:    setSize(value);    break;
+        case Decay:   setDecay(value);   break;
+        case Damping: setDamping(value); break;
+        case Mix:     setMix(value);     break;
+        default: break;
+    }
+}
+
+double ReverbEffect::getTailTime() const
+{
+    // The network decays 60 dB per m_decay seconds, so 90 dB takes 1.5 times
+    // that, after the input has made its way through the longest line
+    float longest = 0.0f;
+    for (unsigned int i = 0; i < kLines; ++i) {
+        longest = std::max(longest, std::max(m_length[i], m_targetLength[i]));
+    }
+    const double decayDb = -20.0 * std::log10(static_cast<double>(kSilenceThreshold));
+    return m_decay * decayDb / 60.0 + (longest + 2.0f * m_modDepth) / m_sampleRate;
+}
+
+void ReverbEffect::setUseSimd(bool useSimd)
+{
+    m_useSimd = useSimd && isSimdAvailable();
+}
+
+bool ReverbEffect::isSimdAvailable()
+{
+#if REVERB_HAS_SSE && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#elif REVERB_HAS_SSE
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Allocate the lines for the largest size; only called on the control thread
+void ReverbEffect::allocateBuffers()
+{
+    m_modDepth = kModDepth * m_sampleRate;
+
+    // Longest line at the largest size plus the modulation swing and the
+    // interpolation neighbour, rounded up to a power of two for masking
+    float longest = kBaseLengths[kLines - 1] * 0.001f * kMaxScale * m_sampleRate + 2.0f * m_modDepth + 2.0f;
+    m_lineSize = 1;
+    while (m_lineSize < static_cast<unsigned int>(longest)) {
+        m_lineSize <<= 1;
+    }
+    m_buffer.assign(static_cast<size_t>(kLines) * m_lineSize, 0.0f);
+    m_index = 0;
+
+    for (unsigned int i = 0; i < kLines; ++i) {
+        float phase = kPi * static_cast<float>(i) / kLines;
+        float step = 2.0f * kPi * kLfoRates[i] / m_sampleRate;
+        m_lfoCos[i] = std::cos(phase);
+        m_lfoSin[i] = std::sin(phase);
+        m_lfoRotCos[i] = std::cos(step);
+        m_lfoRotSin[i] = std::sin(step);
+        m_network.damping[i] = 0.0f;
+    }
+
+    m_glide = 1.0f - std::exp(-1.0f / (kGlideTime * m_sampleRate));
+    updateLengths();
+    std::copy(m_targetLength, m_targetLength + kLines, m_length);
+}
+
+void ReverbEffect::updateLengths()
+{
+    const float scale = kMinScale + (kMaxScale - kMinScale) * m_size;
+    for (unsigned int i = 0; i < kLines; ++i) {
+        m_targetLength[i] = kBaseLengths[i] * 0.001f * scale * m_sampleRate;
+    }
+    updateGains();
+}
+
+void ReverbEffect::updateGains()
+{
+    // A signal circulates through a line of L samples sr / L times per second,
+    // so a gain of 10^(-3 L / (RT60 * sr)) per pass reaches -60 dB after RT60
+    // seconds whatever the line length
+    for (unsigned int i = 0; i < kLines; ++i) {
+        m_network.gain[i] = std::pow(10.0f, -3.0f * m_targetLength[i] / (m_decay * m_sampleRate));
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "IEffect.h"
+#include <vector>
+
+/**
+ * @brief Algorithmic stereo reverb built on a feedback delay network
+ *
+ * Eight delay lines of mutually prime lengths feed back into each other
+ * through an 8x8 Hadamard matrix, which is lossless and mixes every line
+ * into every other one, so the echo density builds up quickly. Each line
+ * has its own gain, derived from its length so that all lines decay at the
+ * same rate, and a one-pole lowpass that makes the highs die out sooner.
+ * The read position of every line is slowly modulated by its own LFO,
+ * which smears the fixed modal frequencies that otherwise make small
+ * networks sound metallic.
+ *
+ * The cost per sample is constant: eight interpolated reads and writes plus
+ * the matrix, independent of the decay time. The damping, gain and matrix
+ * stages run in SSE registers when the CPU supports it, with a scalar
+ * kernel as fallback. Buffers are sized in prepare() for the largest room
+ * size; changing the size glides the read positions instead of reallocating.
+ */
+class ReverbEffect : public IEffect
+{
+public:
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Size, Decay, Damping, Mix };
+
+    static constexpr unsigned int kLines = 8;   ///< Delay lines in the network
+
+    /**
+     * @brief Construct a ReverbEffect
+     * @param size       Room size [0.0 - 1.0], scales the line lengths
+     * @param decay      Time for the tail to fall by 60 dB, in seconds [0.1 - 30]
+     * @param damping    High-frequency damping [0.0 - 1.0]
+     * @param mix        Blend between dry (0.0) and wet (1.0) signal
+     * @param sampleRate Sampling rate of the audio system
+     */
+    ReverbEffect(float size = 0.5f, float decay = 2.0f, float damping = 0.5f, float mix = 0.25f,
+                 float sampleRate = 44100.0f);
+
+    /** Size the delay lines for the sample rate */
+    void prepare(float sampleRate, unsigned int maxBlockSize) override;
+    /** Process a stereo sample (routes through processBlock) */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Process a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+    /** Clear the reverb tail */
+    void reset() override;
+
+    /// Change the sampling rate and reallocate the lines (allocates, control thread only)
+    void setSampleRate(float sampleRate);
+    /// Set the room size [0.0 - 1.0]
+    void setSize(float size);
+    /// Set the decay time in seconds [0.1 - 30]
+    void setDecay(float seconds);
+    /// Set the high-frequency damping [0.0 - 1.0]
+    void setDamping(float damping);
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+    /// Set a parameter by id (see ReverbEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+    /** Decay time to the silence threshold plus one pass through the longest line */
+    double getTailTime() const override;
+
+    /// Use the SSE kernel if the CPU supports it (on by default)
+    void setUseSimd(bool useSimd);
+    /// True if the SSE kernel is in use
+    bool isUsingSimd() const { return m_useSimd; }
+    /// True if this build and CPU can run the SSE kernel
+    static bool isSimdAvailable();
+
+    /**
+     * @brief Per-line state touched by the feedback kernels
+     */
+    struct Network {
+        float damping[kLines];      ///< One-pole lowpass state of each line
+        float gain[kLines];         ///< Per-line feedback gain for the decay time
+        float dampCoefficient;      ///< One-pole coefficient shared by all lines
+    };
+
+private:
+    std::vector<float> m_buffer;        ///< kLines delay lines of m_lineSize samples, back to back
+    unsigned int m_lineSize;            ///< Samples per line, a power of two
+    unsigned int m_index;               ///< Shared write index
+    float m_sampleRate;                 ///< Current sampling rate
+    float m_size;                       ///< Room size
+    float m_decay;                      ///< RT60 in seconds
+    float m_damping;                    ///< High-frequency damping
+    float m_mix;                        ///< Wet/dry mix
+    bool m_useSimd;                     ///< Use the SSE kernel
+
+    float m_length[kLines];             ///< Current (gliding) line lengths in samples
+    float m_targetLength[kLines];       ///< Line lengths for the current size
+    float m_lfoCos[kLines];             ///< LFO phasors, rotated every sample
+    float m_lfoSin[kLines];
+    float m_lfoRotCos[kLines];          ///< Per-sample LFO rotation
+    float m_lfoRotSin[kLines];
+    float m_modDepth;                   ///< Read position modulation depth in samples
+    float m_glide;                      ///< Per-sample length glide coefficient
+    Network m_network;                  ///< Damping state and feedback gains
+
+    /** Allocate the lines for the largest size at the current sample rate */
+    void allocateBuffers();
+    /** Recompute target lengths and the per-line gains */
+    void updateLengths();
+    /** Recompute the per-line gains from the target lengths and decay */
+    void updateGains();
+};
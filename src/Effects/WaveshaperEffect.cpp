@@ -0,0 +1,117 @@
+#include "WaveshaperEffect.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /**
+     * @brief tanh approximation: Pade (3,2) below |x| = 3, where it reaches 1 exactly
+     */
+    inline float shapeTanh(float x) {
+        x = std::min(std::max(x, -3.0f), 3.0f);
+        float x2 = x * x;
+        return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+
+    inline float shapeHardClip(float x) {
+        return std::min(std::max(x, -1.0f), 1.0f);
+    }
+
+    /**
+     * @brief Reflect x into [-1, 1] (a triangle wave of period 4 through the origin)
+     */
+    inline float shapeFoldback(float x) {
+        float t = 0.25f * (x + 1.0f);
+        t -= std::floor(t);
+        return 1.0f - 4.0f * std::fabs(t - 0.5f);
+    }
+
+    /**
+     * @brief Shape both channels with one curve; the curve is inlined into the loop
+     */
+    template <float (*Curve)(float)>
+    void shapeBlock(float* left, float* right, unsigned int numFrames, float drive, float dry, float wet) {
+        for (unsigned int i = 0; i < numFrames; ++i) {
+            left[i] = dry * left[i] + wet * Curve(drive * left[i]);
+            right[i] = dry * right[i] + wet * Curve(drive * right[i]);
+        }
+    }
+
+    float decibelsToGain(float decibels) {
+        return std::pow(10.0f, decibels / 20.0f);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// WaveshaperEffect implementation
+// -----------------------------------------------------------------------------
+
+WaveshaperEffect::WaveshaperEffect(Shape shape, float driveDb, float mix, float levelDb)
+    : m_shape(shape), m_drive(1.0f), m_mix(1.0f), m_level(1.0f)
+{
+    setDrive(driveDb);
+    setMix(mix);
+    setLevel(levelDb);
+}
+
+std::pair<float, float> WaveshaperEffect::process(std::pair<float, float> stereoSample)
+{
+    processBlock(&stereoSample.first, &stereoSample.second, 1);
+    return stereoSample;
+}
+
+void WaveshaperEffect::processBlock(float* left, float* right, unsigned int numFrames)
+{
+    const float dry = 1.0f - m_mix;
+    const float wet = m_mix * m_level;
+
+    switch (m_shape) {
+        case Shape::Tanh:
+            shapeBlock<shapeTanh>(left, right, numFrames, m_drive, dry, wet);
+            break;
+        case Shape::HardClip:
+            shapeBlock<shapeHardClip>(left, right, numFrames, m_drive, dry, wet);
+            break;
+        case Shape::Foldback:
+            shapeBlock<shapeFoldback>(left, right, numFrames, m_drive, dry, wet);
+            break;
+    }
+}
+
+void WaveshaperEffect::setShape(Shape shape)
+{
+    m_shape = shape;
+}
+
+void WaveshaperEffect::setDrive(float driveDb)
+{
+    m_drive = decibelsToGain(std::min(std::max(driveDb, 0.0f), 48.0f));
+}
+
+void WaveshaperEffect::setMix(float mix)
+{
+    // Clamp mix to valid range
+    m_mix = std::min(std::max(mix, 0.0f), 1.0f);
+}
+
+void WaveshaperEffect::setLevel(float levelDb)
+{
+    m_level = decibelsToGain(std::min(std::max(levelDb, -24.0f), 12.0f));
+}
+
+void WaveshaperEffect::setParameter(unsigned int parameterId, float value)
+{
+    switch (parameterId) {
+        case Drive: setDrive(value); break;
+        case CurveShape:
+        {
+            int shape = static_cast<int>(value + 0.5f);
+            if (shape >= 0 && shape <= static_cast<int>(Shape::Foldback)) {
+                setShape(static_cast<Shape>(shape));
+            }
+            break;
+        }
+        case Mix:   setMix(value);   break;
+        case Level: setLevel(value); break;
+        default: break;
+    }
+}
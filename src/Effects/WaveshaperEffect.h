@@ -0,0 +1,57 @@
+#pragma once
+#include "IEffect.h"
+
+/**
+ * @brief Static waveshaping distortion
+ *
+ * The input is amplified by the drive gain and bent by a memoryless transfer
+ * curve, then scaled by the output level and blended with the dry signal.
+ * Curves:
+ *  - Tanh: smooth saturation (rational approximation of tanh, exact at the clip point)
+ *  - HardClip: flat clipping at +/-1
+ *  - Foldback: signal beyond +/-1 is reflected back into range, adding
+ *    dense upper harmonics
+ *
+ * Every curve generates harmonics far above the input, so this effect is
+ * meant to run inside OversampledEffect; on its own it aliases heavily.
+ */
+class WaveshaperEffect : public IEffect
+{
+public:
+    /// Transfer curve
+    enum class Shape : unsigned int { Tanh, HardClip, Foldback };
+
+    /// Parameter ids accepted by setParameter()
+    enum Parameter : unsigned int { Drive, CurveShape, Mix, Level };
+
+    /**
+     * @brief Construct a WaveshaperEffect
+     * @param shape   Transfer curve
+     * @param driveDb Input gain in dB [0 - 48]
+     * @param mix     Blend between dry (0.0) and shaped (1.0) signal
+     * @param levelDb Output level of the shaped signal in dB [-24 - 12]
+     */
+    WaveshaperEffect(Shape shape = Shape::Tanh, float driveDb = 12.0f, float mix = 1.0f, float levelDb = -6.0f);
+
+    /** Shape a stereo sample */
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Shape a block of planar stereo samples in place */
+    void processBlock(float* left, float* right, unsigned int numFrames) override;
+
+    /// Set the transfer curve
+    void setShape(Shape shape);
+    /// Set the input gain in dB [0 - 48]
+    void setDrive(float driveDb);
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+    /// Set the output level of the shaped signal in dB [-24 - 12]
+    void setLevel(float levelDb);
+    /// Set a parameter by id (see WaveshaperEffect::Parameter)
+    void setParameter(unsigned int parameterId, float value) override;
+
+private:
+    Shape m_shape;      ///< Transfer curve
+    float m_drive;      ///< Linear input gain
+    float m_mix;        ///< Wet/dry mix
+    float m_level;      ///< Linear output gain
+};
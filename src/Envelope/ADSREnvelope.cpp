@@ -8,7 +8,9 @@ ADSREnvelope::ADSREnvelope(float attackTime, float decayTime, float sustainLevel
       sustainLevel(std::min(std::max(sustainLevel, 0.0f), 1.0f)), // Clamp to valid range
       releaseTime(std::max(0.001f, releaseTime)),      // Minimum 1ms release
       currentLevel(0.0f),
-      currentSample(0.0f)
+      currentSample(0.0f),
+      releaseLevel(0.0f),
+      attackLevel(0.0f)
 {
 }
 
@@ -26,12 +28,14 @@ float ADSREnvelope::process(bool noteOn, float sampleRate)
         // Note on: start attack phase
         currentStage = Stage::Attack;
         currentSample = 0.0f;
+        attackLevel = 0.0f;
     } else if (!noteOn && (currentStage == Stage::Attack || 
                           currentStage == Stage::Decay || 
                           currentStage == Stage::Sustain)) {
-        // Note off: start release phase
+        // Note off: start release phase from wherever the level currently is
         currentStage = Stage::Release;
         currentSample = 0.0f;
+        releaseLevel = currentLevel;
     }
     
     // Process current stage
@@ -39,8 +43,8 @@ float ADSREnvelope::process(bool noteOn, float sampleRate)
         case Stage::Attack: {
             float attackSamples = attackTime * samplesPerSecond;
             if (currentSample < attackSamples) {
-                // Linear rise to 1.0
-                currentLevel = currentSample / attackSamples;
+                // Linear rise to 1.0 from the level the attack started at
+                currentLevel = attackLevel + (1.0f - attackLevel) * (currentSample / attackSamples);
                 currentSample += 1.0f;
             } else {
                 // Attack complete, move to decay
@@ -76,9 +80,8 @@ float ADSREnvelope::process(bool noteOn, float sampleRate)
             float releaseSamples = releaseTime * samplesPerSecond;
             if (currentSample < releaseSamples) {
                 // Linear fall to 0.0 from whatever level we were at
-                float startLevel = sustainLevel; // Simplified - could store actual level
                 float progress = currentSample / releaseSamples;
-                currentLevel = startLevel * (1.0f - progress);
+                currentLevel = releaseLevel * (1.0f - progress);
                 currentSample += 1.0f;
             } else {
                 // Release complete, go idle
@@ -98,9 +101,25 @@ float ADSREnvelope::process(bool noteOn, float sampleRate)
     return currentLevel;
 }
 
+void ADSREnvelope::processBlock(bool noteOn, float sampleRate, float* output, unsigned int numFrames)
+{
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        output[i] = process(noteOn, sampleRate);
+    }
+}
+
+void ADSREnvelope::trigger()
+{
+    currentStage = Stage::Attack;
+    currentSample = 0.0f;
+    attackLevel = currentLevel;
+}
+
 void ADSREnvelope::reset()
 {
     currentStage = Stage::Idle;
     currentLevel = 0.0f;
     currentSample = 0.0f;
+    releaseLevel = 0.0f;
+    attackLevel = 0.0f;
 }
\ No newline at end of file
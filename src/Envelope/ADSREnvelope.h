@@ -39,11 +39,41 @@ public:
      */
     float process(bool noteOn, float sampleRate);
     
+    /**
+     * @brief Process a block of samples through the envelope
+     * 
+     * @param noteOn Whether a note is held for the whole block
+     * @param sampleRate Sample rate for time calculations
+     * @param output Destination buffer receiving numFrames envelope levels
+     * @param numFrames Number of samples to generate
+     */
+    void processBlock(bool noteOn, float sampleRate, float* output, unsigned int numFrames);
+    
+    /**
+     * @brief Start the attack phase from the current level
+     *
+     * A retriggered or stolen voice rises from wherever it was instead of
+     * jumping to zero, which would click.
+     */
+    void trigger();
+    
     /**
      * @brief Reset the envelope to initial state
      */
     void reset();
     
+    /**
+     * @brief Check whether the envelope has finished (no output)
+     * @return true when the envelope is in the idle stage
+     */
+    bool isIdle() const { return currentStage == Stage::Idle; }
+    
+    /**
+     * @brief Get the most recently produced envelope level
+     * @return Current envelope amplitude [0.0-1.0]
+     */
+    float getLevel() const { return currentLevel; }
+    
 private:
     /**
      * @enum Stage
@@ -65,4 +95,6 @@ private:
     float releaseTime;          ///< Release time in seconds
     float currentLevel;         ///< Current envelope output level
     float currentSample;        ///< Current sample count for timing
+    float releaseLevel;         ///< Level at which the release phase started
+    float attackLevel;          ///< Level at which the attack phase started
 };
\ No newline at end of file
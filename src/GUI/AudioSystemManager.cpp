@@ -25,12 +25,15 @@ void AudioSystemManager::initializeAudioSystem(const AudioConfig& config) {
     // Initialize adapter for unified interface
     adapter = std::make_unique<AudioSystemAdapter>(audioSystem.get());
     
-    // Initialize audio device
+    // Initialize audio device; rendering ahead adds latency, so live MIDI
+    // playing keeps the direct path
     audioDevice = std::make_unique<AudioDevice>(
         audioSystem.get(), 
         config.sampleRate, 
-        config.bufferFrames
+        config.bufferFrames,
+        config.inputMode == "sequencer" ? config.renderAhead : 0
     );
+    audioDevice->setRealtime(config);
     
     currentConfig = config;
 }
@@ -49,6 +52,7 @@ bool AudioSystemManager::start() {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         
         std::cout << "✅ Audio system started successfully!" << std::endl;
+        std::cout << "⏱️ Real-time setup: " << audioDevice->getRealtimeStatus().describe() << std::endl;
         notifyStateChange();
         return true;
     } catch (const std::exception& e) {
@@ -123,11 +127,31 @@ void AudioSystemManager::triggerNote(float frequency) {
 
 void AudioSystemManager::triggerNoteOff() {
     if (audioSystem) {
-        audioSystem->triggerNoteOff();
+        // A lost release would leave the note hanging; while the stream runs
+        // the queue drains every buffer, so wait a little for room
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        while (!audioSystem->triggerNoteOff() && audioDeviceStarted &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
         std::cout << "⏹️ Note stopped" << std::endl;
     }
 }
 
+DspLoadStats AudioSystemManager::getDspLoadStats() const {
+    return audioDevice ? audioDevice->getLoadStats() : DspLoadStats();
+}
+
+RealtimeStatus AudioSystemManager::getRealtimeStatus() const {
+    return audioDevice ? audioDevice->getRealtimeStatus() : RealtimeStatus();
+}
+
+void AudioSystemManager::resetDspLoadStats() {
+    if (audioDevice) {
+        audioDevice->resetLoadStats();
+    }
+}
+
 void AudioSystemManager::notifyStateChange() {
     if (stateChangeCallback) {
         stateChangeCallback(audioDeviceStarted);
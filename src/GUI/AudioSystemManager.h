@@ -84,6 +84,23 @@ public:
      */
     std::shared_ptr<AudioSystem> getAudioSystem() const { return audioSystem; }
 
+    /**
+     * @brief Get the audio callback load and xrun counters
+     * @return Statistics since the stream was opened or last reset (all zero without a device)
+     */
+    DspLoadStats getDspLoadStats() const;
+
+    /**
+     * @brief Clear the callback load statistics
+     */
+    void resetDspLoadStats();
+
+    /**
+     * @brief Get the real-time settings requested and obtained by the audio thread
+     * @return Status of the current device (nothing requested without a device)
+     */
+    RealtimeStatus getRealtimeStatus() const;
+
 private:
     std::shared_ptr<AudioSystem> audioSystem;
     std::unique_ptr<AudioSystemAdapter> adapter;
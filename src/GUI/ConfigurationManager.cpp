@@ -75,6 +75,12 @@ bool ConfigurationManager::hasEffect(const std::string& effect) const {
 }
 
 void ConfigurationManager::toggleEffect(const std::string& effect, bool enabled) {
+    // The checkboxes edit the serial list, which a configured graph would override
+    if (!currentConfig.effectGraph.empty()) {
+        currentConfig.effectGraph.clear();
+        std::cout << "🎚️ Effect graph replaced by the effect list" << std::endl;
+    }
+
     if (enabled) {
         if (!hasEffect(effect)) {
             currentConfig.effects.push_back(effect);
@@ -114,7 +120,9 @@ bool ConfigurationManager::validateConfig(const AudioConfig& config) {
     
     // Validate waveform
     static const std::vector<std::string> validWaveforms = {
-        "sine", "square", "sawtooth", "saw", "triangle", "tri"
+        "sine", "square", "sawtooth", "saw", "triangle", "tri",
+        "sine_wt", "square_wt", "sawtooth_wt", "saw_wt", "triangle_wt", "tri_wt",
+        "square_blep", "sawtooth_blep", "saw_blep", "triangle_blep", "tri_blep"
     };
     
     if (std::find(validWaveforms.begin(), validWaveforms.end(), config.waveform) 
@@ -132,11 +140,18 @@ bool ConfigurationManager::validateConfig(const AudioConfig& config) {
 
 void ConfigurationManager::initializeOptions() {
     // Initialize waveform options
-    waveformOptions = {"Sine", "Square", "Sawtooth", "Triangle"};
-    waveformValues = {"sine", "square", "sawtooth", "triangle"};
+    waveformOptions = {"Sine", "Square", "Sawtooth", "Triangle",
+                       "Sine (Wavetable)", "Square (Wavetable)", "Sawtooth (Wavetable)", "Triangle (Wavetable)",
+                       "Square (PolyBLEP)", "Sawtooth (PolyBLEP)", "Triangle (PolyBLAMP)"};
+    waveformValues = {"sine", "square", "sawtooth", "triangle",
+                      "sine_wt", "square_wt", "sawtooth_wt", "triangle_wt",
+                      "square_blep", "sawtooth_blep", "triangle_blep"};
     
     // Initialize available effects
-    availableEffects = {"delay", "echo", "lowpass", "lpf", "filter", "octave"};
+    availableEffects = {"delay", "echo", "lowpass", "lpf", "filter", "highpass", "hpf",
+                        "bandpass", "bpf", "notch", "lowshelf", "highshelf", "octave",
+                        "reverb", "convolution", "overdrive", "hardclip", "foldback",
+                        "chorus", "flanger", "phaser"};
 }
 
 void ConfigurationManager::initializeDefaultEffectParameters() {
@@ -147,6 +162,11 @@ void ConfigurationManager::initializeDefaultEffectParameters() {
     effectParameters.setParameters("lpf", std::make_unique<LowPassParameters>());
     effectParameters.setParameters("filter", std::make_unique<LowPassParameters>());
     effectParameters.setParameters("octave", std::make_unique<OctaveParameters>());
+    effectParameters.setParameters("reverb", std::make_unique<ReverbParameters>());
+    effectParameters.setParameters("overdrive", std::make_unique<WaveshaperParameters>());
+    effectParameters.setParameters("chorus", std::make_unique<ModulationParameters>("chorus"));
+    effectParameters.setParameters("flanger", std::make_unique<ModulationParameters>("flanger"));
+    effectParameters.setParameters("phaser", std::make_unique<ModulationParameters>("phaser"));
     
     std::cout << "🎛️ Initialized default effect parameters" << std::endl;
 }
@@ -1,12 +1,81 @@
 #include "EffectParameterWindow.h"
 #include "../../guiBase_cpp/external/imgui/imgui.h"
+#include <algorithm>
 #include <cmath>
+#include <utility>
+
+namespace {
+    // FilterEffect::Mode a filter slot was created with, -1 if the name is not a filter
+    int filterModeOf(const std::string& effectName) {
+        static const std::pair<const char*, int> modes[] = {
+            {"lowpass", 0}, {"lpf", 0}, {"filter", 0}, {"highpass", 1}, {"hpf", 1},
+            {"bandpass", 2}, {"bpf", 2}, {"notch", 3}, {"lowshelf", 4}, {"highshelf", 5}
+        };
+        for (const auto& mode : modes) {
+            if (effectName == mode.first) {
+                return mode.second;
+            }
+        }
+        return -1;
+    }
+
+    // WaveshaperEffect::Shape a distortion slot was created with, -1 if the name is not one
+    int distortionShapeOf(const std::string& effectName) {
+        if (effectName == "overdrive" || effectName == "distortion" || effectName == "drive") {
+            return 0;
+        }
+        if (effectName == "hardclip") {
+            return 1;
+        }
+        if (effectName == "foldback") {
+            return 2;
+        }
+        return -1;
+    }
+}
 
 EffectParameterWindow::EffectParameterWindow() {
     // Initialize with default parameters
     delayParams_.reset();
     lowPassParams_.reset();
     octaveParams_.reset();
+    reverbParams_.reset();
+    distortionParams_.reset();
+    modulationParams_[0] = ModulationParameters("chorus");
+    modulationParams_[1] = ModulationParameters("flanger");
+    modulationParams_[2] = ModulationParameters("phaser");
+}
+
+void EffectParameterWindow::showLowPassWindow(bool show, const std::string& effectName) {
+    showLowPassWindow_ = show;
+    if (effectName != lowPassEffect_) {
+        // Start from the mode of the slot, so editing it does not switch the filter type
+        const int mode = filterModeOf(effectName);
+        if (mode >= 0) {
+            lowPassParams_.mode = mode;
+        }
+        lowPassEffect_ = effectName;
+    }
+}
+
+void EffectParameterWindow::showDistortionWindow(bool show, const std::string& effectName) {
+    showDistortionWindow_ = show;
+    if (effectName != distortionEffect_) {
+        // Start from the curve of the slot, so editing it does not switch the shape
+        const int shape = distortionShapeOf(effectName);
+        if (shape >= 0) {
+            distortionParams_.shape = shape;
+        }
+        distortionEffect_ = effectName;
+    }
+}
+
+void EffectParameterWindow::setModulationParameters(const ModulationParameters& params) {
+    for (auto& current : modulationParams_) {
+        if (current.effect == params.effect) {
+            current = params;
+        }
+    }
 }
 
 void EffectParameterWindow::render() {
@@ -21,17 +90,51 @@ void EffectParameterWindow::render() {
     if (showOctaveWindow_) {
         renderOctaveWindow();
     }
+    
+    if (showReverbWindow_) {
+        renderReverbWindow();
+    }
+    
+    if (showDistortionWindow_) {
+        renderDistortionWindow();
+    }
+    
+    if (showModulationWindow_) {
+        renderModulationWindow();
+    }
 }
 
 void EffectParameterWindow::renderDelayWindow() {
     if (ImGui::Begin("Delay Effect Parameters", &showDelayWindow_)) {
         bool changed = false;
         
-        // Delay Time slider (0.1 - 2.0 seconds)
-        if (ImGui::SliderFloat("Delay Time (s)", &delayParams_.delayTime, 0.1f, 2.0f, "%.2f")) {
+        // Sync division, in beats; "Free" uses the delay time slider
+        const char* syncOptions[] = { "Free", "1/4", "1/8", "1/8 Dotted", "1/8 Triplet", "1/16", "1/2" };
+        const float syncBeats[] = { 0.0f, 1.0f, 0.5f, 0.75f, 1.0f / 3.0f, 0.25f, 2.0f };
+        int currentSyncIndex = 0;
+        for (int i = 0; i < 7; ++i) {
+            if (std::abs(delayParams_.syncDivision - syncBeats[i]) < 0.001f) {
+                currentSyncIndex = i;
+            }
+        }
+        if (ImGui::Combo("Tempo Sync", &currentSyncIndex, syncOptions, 7)) {
+            delayParams_.syncDivision = syncBeats[currentSyncIndex];
             changed = true;
         }
-        ImGui::Text("Controls the time between echoes");
+        
+        if (delayParams_.syncDivision > 0.0f) {
+            // Tempo slider (20 - 400 BPM)
+            if (ImGui::SliderFloat("Tempo (BPM)", &delayParams_.tempo, 20.0f, 400.0f, "%.0f")) {
+                changed = true;
+            }
+            ImGui::Text("Delay: %.3f s", delayParams_.syncDivision * 60.0f / delayParams_.tempo);
+        } else {
+            // Delay Time slider (0.01 - 5.0 seconds)
+            if (ImGui::SliderFloat("Delay Time (s)", &delayParams_.delayTime, 0.01f, 5.0f, "%.2f")) {
+                changed = true;
+            }
+            ImGui::Text("Controls the time between echoes; changes glide like a tape delay");
+        }
         
         ImGui::Separator();
         
@@ -51,6 +154,13 @@ void EffectParameterWindow::renderDelayWindow() {
         
         ImGui::Separator();
         
+        if (ImGui::Checkbox("Ping-Pong", &delayParams_.pingPong)) {
+            changed = true;
+        }
+        ImGui::Text("Repeats alternate between the left and right channels");
+        
+        ImGui::Separator();
+        
         // Reset button
         if (ImGui::Button("Reset to Defaults")) {
             delayParams_.reset();
@@ -66,9 +176,19 @@ void EffectParameterWindow::renderDelayWindow() {
 }
 
 void EffectParameterWindow::renderLowPassWindow() {
-    if (ImGui::Begin("Low Pass Filter Parameters", &showLowPassWindow_)) {
+    if (ImGui::Begin("Filter Parameters", &showLowPassWindow_)) {
         bool changed = false;
         
+        ImGui::Text("Effect: %s", lowPassEffect_.c_str());
+        
+        // Filter mode, in FilterEffect::Mode order
+        const char* modeOptions[] = { "Low Pass", "High Pass", "Band Pass", "Notch", "Low Shelf", "High Shelf" };
+        if (ImGui::Combo("Mode", &lowPassParams_.mode, modeOptions, 6)) {
+            changed = true;
+        }
+        
+        ImGui::Separator();
+        
         // Cutoff Frequency slider (20 - 20000 Hz, logarithmic scale)
         float logCutoff = std::log10(lowPassParams_.cutoffFreq);
         if (ImGui::SliderFloat("Cutoff Frequency (Hz)", &logCutoff, std::log10(20.0f), std::log10(20000.0f),
@@ -92,17 +212,27 @@ void EffectParameterWindow::renderLowPassWindow() {
         }
         ImGui::Text("Filter resonance - higher values create emphasis at cutoff");
         
+        // Shelf gain only applies to the shelf modes
+        if (lowPassParams_.mode >= 4) {
+            ImGui::Separator();
+            if (ImGui::SliderFloat("Shelf Gain (dB)", &lowPassParams_.gainDb, -24.0f, 24.0f, "%.1f")) {
+                changed = true;
+            }
+            ImGui::Text("Boost or cut below (low shelf) or above (high shelf) the cutoff");
+        }
+        
         ImGui::Separator();
         
         // Reset button
         if (ImGui::Button("Reset to Defaults")) {
             lowPassParams_.reset();
+            lowPassParams_.mode = std::max(filterModeOf(lowPassEffect_), 0);
             changed = true;
         }
         
         // Apply changes if any parameter changed
         if (changed && onParameterChange_) {
-            onParameterChange_("lowpass", std::make_unique<LowPassParameters>(lowPassParams_));
+            onParameterChange_(lowPassEffect_, std::make_unique<LowPassParameters>(lowPassParams_));
         }
     }
     ImGui::End();
@@ -152,4 +282,166 @@ void EffectParameterWindow::renderOctaveWindow() {
         }
     }
     ImGui::End();
-}
\ No newline at end of file
+}
+
+void EffectParameterWindow::renderReverbWindow() {
+    if (ImGui::Begin("Reverb Parameters", &showReverbWindow_)) {
+        bool changed = false;
+        
+        // Size slider (0.0 - 1.0)
+        if (ImGui::SliderFloat("Size", &reverbParams_.size, 0.0f, 1.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("Room size; changes glide instead of clicking");
+        
+        ImGui::Separator();
+        
+        // Decay slider (0.1 - 30 seconds)
+        if (ImGui::SliderFloat("Decay (s)", &reverbParams_.decay, 0.1f, 30.0f, "%.1f")) {
+            changed = true;
+        }
+        ImGui::Text("Time for the tail to fade by 60 dB");
+        
+        ImGui::Separator();
+        
+        // Damping slider (0.0 - 1.0)
+        if (ImGui::SliderFloat("Damping", &reverbParams_.damping, 0.0f, 1.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("How much faster high frequencies die out");
+        
+        ImGui::Separator();
+        
+        // Mix slider (0.0 - 1.0)
+        if (ImGui::SliderFloat("Mix", &reverbParams_.mix, 0.0f, 1.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("Balance between dry (0.0) and wet (1.0) signal");
+        
+        ImGui::Separator();
+        
+        // Reset button
+        if (ImGui::Button("Reset to Defaults")) {
+            reverbParams_.reset();
+            changed = true;
+        }
+        
+        // Apply changes if any parameter changed
+        if (changed && onParameterChange_) {
+            onParameterChange_("reverb", std::make_unique<ReverbParameters>(reverbParams_));
+        }
+    }
+    ImGui::End();
+}
+
+void EffectParameterWindow::renderDistortionWindow() {
+    if (ImGui::Begin("Distortion Parameters", &showDistortionWindow_)) {
+        bool changed = false;
+        
+        ImGui::Text("Effect: %s", distortionEffect_.c_str());
+        
+        // Transfer curve
+        const char* shapeOptions[] = { "Tanh (Overdrive)", "Hard Clip", "Foldback" };
+        if (ImGui::Combo("Curve", &distortionParams_.shape, shapeOptions, 3)) {
+            changed = true;
+        }
+        ImGui::Text("Runs oversampled, so the harmonics do not fold back");
+        
+        ImGui::Separator();
+        
+        // Drive slider (0 - 48 dB)
+        if (ImGui::SliderFloat("Drive (dB)", &distortionParams_.driveDb, 0.0f, 48.0f, "%.1f")) {
+            changed = true;
+        }
+        ImGui::Text("Input gain into the curve");
+        
+        ImGui::Separator();
+        
+        // Level slider (-24 - 12 dB)
+        if (ImGui::SliderFloat("Level (dB)", &distortionParams_.levelDb, -24.0f, 12.0f, "%.1f")) {
+            changed = true;
+        }
+        ImGui::Text("Output level of the distorted signal");
+        
+        ImGui::Separator();
+        
+        // Mix slider (0.0 - 1.0)
+        if (ImGui::SliderFloat("Mix", &distortionParams_.mix, 0.0f, 1.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("Balance between dry (0.0) and distorted (1.0) signal");
+        
+        ImGui::Separator();
+        
+        // Reset button
+        if (ImGui::Button("Reset to Defaults")) {
+            distortionParams_.reset();
+            distortionParams_.shape = std::max(distortionShapeOf(distortionEffect_), 0);
+            changed = true;
+        }
+        
+        // Apply changes if any parameter changed
+        if (changed && onParameterChange_) {
+            onParameterChange_(distortionEffect_, std::make_unique<WaveshaperParameters>(distortionParams_));
+        }
+    }
+    ImGui::End();
+}
+
+void EffectParameterWindow::renderModulationWindow() {
+    if (ImGui::Begin("Modulation Parameters", &showModulationWindow_)) {
+        bool changed = false;
+        
+        // Which of the three effects the sliders edit
+        const char* effectOptions[] = { "Chorus", "Flanger", "Phaser" };
+        ImGui::Combo("Effect", &modulationEffect_, effectOptions, 3);
+        ModulationParameters& params = modulationParams_[modulationEffect_];
+        
+        ImGui::Separator();
+        
+        // Rate slider (0.01 - 20 Hz)
+        if (ImGui::SliderFloat("Rate (Hz)", &params.rate, 0.01f, 20.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("LFO speed (ignored when the chain shares one LFO)");
+        
+        ImGui::Separator();
+        
+        // Depth slider (0.0 - 1.0)
+        if (ImGui::SliderFloat("Depth", &params.depth, 0.0f, 1.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("How far the LFO sweeps the delay or the notches");
+        
+        // Feedback slider (-0.95 - 0.95), not used by the chorus
+        if (params.effect != "chorus") {
+            ImGui::Separator();
+            if (ImGui::SliderFloat("Feedback", &params.feedback, -0.95f, 0.95f, "%.2f")) {
+                changed = true;
+            }
+            ImGui::Text("Sharper, more resonant sweep; negative values sound hollow");
+        }
+        
+        ImGui::Separator();
+        
+        // Mix slider (0.0 - 1.0)
+        if (ImGui::SliderFloat("Mix", &params.mix, 0.0f, 1.0f, "%.2f")) {
+            changed = true;
+        }
+        ImGui::Text("Balance between dry (0.0) and modulated (1.0) signal");
+        
+        ImGui::Separator();
+        
+        // Reset button
+        if (ImGui::Button("Reset to Defaults")) {
+            params.reset();
+            changed = true;
+        }
+        
+        // Apply changes if any parameter changed
+        if (changed && onParameterChange_) {
+            onParameterChange_(params.effect, std::make_unique<ModulationParameters>(params));
+        }
+    }
+    ImGui::End();
+}
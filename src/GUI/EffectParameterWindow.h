@@ -20,13 +20,19 @@ public:
     
     // Show/hide parameter windows
     void showDelayWindow(bool show) { showDelayWindow_ = show; }
-    void showLowPassWindow(bool show) { showLowPassWindow_ = show; }
+    void showLowPassWindow(bool show, const std::string& effectName = "lowpass");
     void showOctaveWindow(bool show) { showOctaveWindow_ = show; }
+    void showReverbWindow(bool show) { showReverbWindow_ = show; }
+    void showDistortionWindow(bool show, const std::string& effectName = "overdrive");
+    void showModulationWindow(bool show) { showModulationWindow_ = show; }
     
     // Set current parameters (for initialization)
     void setDelayParameters(const DelayParameters& params) { delayParams_ = params; }
     void setLowPassParameters(const LowPassParameters& params) { lowPassParams_ = params; }
     void setOctaveParameters(const OctaveParameters& params) { octaveParams_ = params; }
+    void setReverbParameters(const ReverbParameters& params) { reverbParams_ = params; }
+    void setDistortionParameters(const WaveshaperParameters& params) { distortionParams_ = params; }
+    void setModulationParameters(const ModulationParameters& params);
     
     // Render the parameter windows
     void render();
@@ -35,16 +41,28 @@ private:
     void renderDelayWindow();
     void renderLowPassWindow();
     void renderOctaveWindow();
+    void renderReverbWindow();
+    void renderDistortionWindow();
+    void renderModulationWindow();
     
     // Window visibility flags
     bool showDelayWindow_ = false;
     bool showLowPassWindow_ = false;
     bool showOctaveWindow_ = false;
+    bool showReverbWindow_ = false;
+    bool showDistortionWindow_ = false;
+    bool showModulationWindow_ = false;
     
     // Parameter instances
     DelayParameters delayParams_;
     LowPassParameters lowPassParams_;
+    std::string lowPassEffect_ = "lowpass";     // Filter slot the filter window edits
     OctaveParameters octaveParams_;
+    ReverbParameters reverbParams_;
+    WaveshaperParameters distortionParams_;
+    std::string distortionEffect_ = "overdrive";    // Waveshaper slot the distortion window edits
+    ModulationParameters modulationParams_[3];   // Chorus, flanger, phaser
+    int modulationEffect_ = 0;                   // Index into modulationParams_ shown in the window
     
     // Callback for parameter changes
     ParameterChangeCallback onParameterChange_;
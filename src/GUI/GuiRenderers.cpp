@@ -1,5 +1,6 @@
 #include "GuiRenderers.h"
 #include <iostream>
+#include <cstdio>
 
 // WaveformControlRenderer implementation
 WaveformControlRenderer::WaveformControlRenderer(ConfigurationManager& configManager)
@@ -136,6 +137,17 @@ EffectsControlRenderer::EffectsControlRenderer(ConfigurationManager& configManag
     if (auto octaveParams = configManager.getEffectParameters<OctaveParameters>("octave")) {
         parameterWindow.setOctaveParameters(*octaveParams);
     }
+    if (auto reverbParams = configManager.getEffectParameters<ReverbParameters>("reverb")) {
+        parameterWindow.setReverbParameters(*reverbParams);
+    }
+    if (auto distortionParams = configManager.getEffectParameters<WaveshaperParameters>("overdrive")) {
+        parameterWindow.setDistortionParameters(*distortionParams);
+    }
+    for (const char* name : {"chorus", "flanger", "phaser"}) {
+        if (auto modulationParams = configManager.getEffectParameters<ModulationParameters>(name)) {
+            parameterWindow.setModulationParameters(*modulationParams);
+        }
+    }
     
     // Set up parameter change callback
     parameterWindow.setParameterChangeCallback([this, &configManager](const std::string& effectName, std::unique_ptr<IEffectParameters> params) {
@@ -155,9 +167,11 @@ void EffectsControlRenderer::render(GuiBase::GuiWindow& window) {
     
     // Group related effects for organized display
     std::vector<std::pair<std::string, std::vector<std::string>>> effectGroups = {
-        {"Filters", {"lowpass", "lpf", "filter"}},
-        {"Time Effects", {"delay", "echo"}},
-        {"Harmonic", {"octave"}}
+        {"Filters", {"lowpass", "lpf", "filter", "highpass", "bandpass", "notch", "lowshelf", "highshelf"}},
+        {"Time Effects", {"delay", "echo", "reverb", "convolution"}},
+        {"Harmonic", {"octave"}},
+        {"Distortion", {"overdrive", "hardclip", "foldback"}},
+        {"Modulation", {"chorus", "flanger", "phaser"}}
     };
     
     for (const auto& group : effectGroups) {
@@ -176,10 +190,18 @@ void EffectsControlRenderer::render(GuiBase::GuiWindow& window) {
                     // Show parameter window for this effect
                     if (effect == "delay" || effect == "echo") {
                         parameterWindow.showDelayWindow(true);
-                    } else if (effect == "lowpass" || effect == "lpf" || effect == "filter") {
-                        parameterWindow.showLowPassWindow(true);
+                    } else if (effect == "lowpass" || effect == "lpf" || effect == "filter" ||
+                               effect == "highpass" || effect == "bandpass" || effect == "notch" ||
+                               effect == "lowshelf" || effect == "highshelf") {
+                        parameterWindow.showLowPassWindow(true, effect);
                     } else if (effect == "octave") {
                         parameterWindow.showOctaveWindow(true);
+                    } else if (effect == "reverb") {
+                        parameterWindow.showReverbWindow(true);
+                    } else if (effect == "overdrive" || effect == "hardclip" || effect == "foldback") {
+                        parameterWindow.showDistortionWindow(true, effect);
+                    } else if (effect == "chorus" || effect == "flanger" || effect == "phaser") {
+                        parameterWindow.showModulationWindow(true);
                     }
                 }
             }
@@ -214,7 +236,9 @@ void StatusDisplayRenderer::render(GuiBase::GuiWindow& window) {
     window.text("Volume: " + std::to_string(static_cast<int>(soundController.getVolume() * 100)) + "%");
     
     // Effects status
-    if (!config.effects.empty()) {
+    if (!config.effectGraph.empty()) {
+        window.text("Effects: graph of " + std::to_string(config.effectGraph.size()) + " nodes");
+    } else if (!config.effects.empty()) {
         std::string effectsStr = "Effects: ";
         for (size_t i = 0; i < config.effects.size(); ++i) {
             effectsStr += config.effects[i];
@@ -226,4 +250,26 @@ void StatusDisplayRenderer::render(GuiBase::GuiWindow& window) {
     }
     
     window.text("Input Mode: " + config.inputMode);
+    
+    // Callback load relative to the buffer deadline, and dropouts reported by the driver
+    if (audioSystemManager.isRunning()) {
+        DspLoadStats load = audioSystemManager.getDspLoadStats();
+        auto percent = [](float value) { return std::to_string(static_cast<int>(value * 100.0f + 0.5f)) + "%"; };
+        window.text("DSP Load: p50 " + percent(load.p50Load) + ", p99 " + percent(load.p99Load) +
+                    ", max " + percent(load.maxLoad));
+        window.text("Xruns: " + std::to_string(load.outputUnderflows) + " underflows, " +
+                    std::to_string(load.inputOverflows) + " overflows");
+        window.text("Real-time: " + audioSystemManager.getRealtimeStatus().describe());
+
+        // Master-bus gain reduction
+        if (auto audioSystem = audioSystemManager.getAudioSystem()) {
+            auto decibels = [](float value) {
+                char text[16];
+                std::snprintf(text, sizeof(text), "%.1f dB", -value);
+                return std::string(text);
+            };
+            window.text("Master: compressor " + decibels(audioSystem->getCompressorReduction()) +
+                        ", limiter " + decibels(audioSystem->getLimiterReduction()));
+        }
+    }
 }
\ No newline at end of file
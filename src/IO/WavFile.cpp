@@ -0,0 +1,259 @@
+#include "WavFile.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <iterator>
+
+namespace {
+    constexpr unsigned short kChannels = 2;
+    constexpr unsigned short kFormatPcm = 1;
+    constexpr unsigned short kFormatFloat = 3;
+
+    /**
+     * @brief Append a little-endian integer of the given byte width
+     */
+    void putLE(std::vector<char>& out, std::uint32_t value, unsigned int bytes) {
+        for (unsigned int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void putTag(std::vector<char>& out, const char* tag) {
+        out.insert(out.end(), tag, tag + 4);
+    }
+
+    /**
+     * @brief Clamp a chunk size to what the 32-bit RIFF fields can hold
+     */
+    std::uint32_t chunkSize(unsigned long long bytes) {
+        return static_cast<std::uint32_t>(std::min<unsigned long long>(bytes, 0xFFFFFFFFull));
+    }
+
+    constexpr unsigned short kFormatExtensible = 0xFFFE;
+
+    /**
+     * @brief Read a little-endian integer of the given byte width
+     */
+    std::uint32_t getLE(const unsigned char* data, unsigned int bytes) {
+        std::uint32_t value = 0;
+        for (unsigned int i = 0; i < bytes; ++i) {
+            value |= static_cast<std::uint32_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Decode one sample of the given encoding to float
+     */
+    float decodeSample(const unsigned char* data, unsigned short format, unsigned short bits) {
+        if (format == kFormatFloat) {
+            if (bits == 32) {
+                std::uint32_t raw = getLE(data, 4);
+                float value;
+                std::memcpy(&value, &raw, sizeof(value));
+                return value;
+            }
+            std::uint64_t raw = getLE(data, 4) | (static_cast<std::uint64_t>(getLE(data + 4, 4)) << 32);
+            double value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return static_cast<float>(value);
+        }
+
+        // 8-bit PCM is unsigned, wider PCM is two's complement
+        if (bits == 8) {
+            return (static_cast<float>(data[0]) - 128.0f) / 128.0f;
+        }
+        const unsigned int bytes = bits / 8;
+        std::uint32_t raw = getLE(data, bytes) << (32 - bits);
+        std::int32_t value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return static_cast<float>(value) / 2147483648.0f;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// WavWriter implementation
+// -----------------------------------------------------------------------------
+
+WavWriter::WavWriter(const std::string& filename, unsigned int sampleRate, WavSampleFormat format)
+    : m_filename(filename), m_sampleRate(sampleRate), m_format(format), m_framesWritten(0)
+{
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        throw std::runtime_error("Failed to create WAV file: " + filename);
+    }
+    writeHeader();
+}
+
+WavWriter::~WavWriter()
+{
+    try {
+        close();
+    } catch (...) {
+        // Never throw from a destructor
+    }
+}
+
+void WavWriter::write(const float* left, const float* right, unsigned int numFrames)
+{
+    if (!m_file.is_open() || numFrames == 0) {
+        return;
+    }
+
+    const size_t bytesPerSample = (m_format == WavSampleFormat::Pcm16) ? 2 : 4;
+    m_scratch.resize(static_cast<size_t>(numFrames) * kChannels * bytesPerSample);
+    char* out = m_scratch.data();
+
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        const float frame[kChannels] = { left[i], right[i] };
+        for (unsigned short channel = 0; channel < kChannels; ++channel)
+        {
+            if (m_format == WavSampleFormat::Pcm16) {
+                float clipped = std::min(std::max(frame[channel], -1.0f), 1.0f);
+                std::uint16_t sample = static_cast<std::uint16_t>(static_cast<std::int16_t>(clipped * 32767.0f));
+                *out++ = static_cast<char>(sample & 0xFF);
+                *out++ = static_cast<char>(sample >> 8);
+            } else {
+                std::uint32_t bits;
+                std::memcpy(&bits, &frame[channel], sizeof(bits));
+                for (unsigned int b = 0; b < 4; ++b) {
+                    *out++ = static_cast<char>((bits >> (8 * b)) & 0xFF);
+                }
+            }
+        }
+    }
+
+    m_file.write(m_scratch.data(), static_cast<std::streamsize>(m_scratch.size()));
+    if (!m_file) {
+        throw std::runtime_error("Failed to write WAV file: " + m_filename);
+    }
+    m_framesWritten += numFrames;
+}
+
+void WavWriter::close()
+{
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    // Rewrite the header now that the final length is known
+    m_file.seekp(0);
+    writeHeader();
+    m_file.close();
+}
+
+void WavWriter::writeHeader()
+{
+    const bool isFloat = (m_format == WavSampleFormat::Float32);
+    const unsigned short bitsPerSample = isFloat ? 32 : 16;
+    const unsigned short blockAlign = kChannels * bitsPerSample / 8;
+    const unsigned long long dataBytes = m_framesWritten * blockAlign;
+
+    // Float files carry the extended fmt chunk and a fact chunk
+    const std::uint32_t fmtSize = isFloat ? 18 : 16;
+    const std::uint32_t factBytes = isFloat ? 12 : 0;
+    const unsigned long long riffBytes = 4 + (8 + fmtSize) + factBytes + 8 + dataBytes;
+
+    std::vector<char> header;
+    putTag(header, "RIFF");
+    putLE(header, chunkSize(riffBytes), 4);
+    putTag(header, "WAVE");
+
+    putTag(header, "fmt ");
+    putLE(header, fmtSize, 4);
+    putLE(header, isFloat ? kFormatFloat : kFormatPcm, 2);
+    putLE(header, kChannels, 2);
+    putLE(header, m_sampleRate, 4);
+    putLE(header, m_sampleRate * blockAlign, 4);
+    putLE(header, blockAlign, 2);
+    putLE(header, bitsPerSample, 2);
+    if (isFloat) {
+        putLE(header, 0, 2); // cbSize: no extension
+        putTag(header, "fact");
+        putLE(header, 4, 4);
+        putLE(header, chunkSize(m_framesWritten), 4);
+    }
+
+    putTag(header, "data");
+    putLE(header, chunkSize(dataBytes), 4);
+
+    m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!m_file) {
+        throw std::runtime_error("Failed to write WAV header: " + m_filename);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// WAV reading
+// -----------------------------------------------------------------------------
+
+WavData readWavFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open WAV file: " + filename);
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 ||
+        std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+        throw std::runtime_error("Not a RIFF/WAVE file: " + filename);
+    }
+
+    unsigned short format = 0;
+    unsigned short channels = 0;
+    unsigned short bitsPerSample = 0;
+    unsigned int sampleRate = 0;
+    const unsigned char* data = nullptr;
+    size_t dataBytes = 0;
+
+    // Walk the chunk list; chunks are padded to an even size
+    size_t offset = 12;
+    while (offset + 8 <= bytes.size())
+    {
+        const unsigned char* chunk = bytes.data() + offset;
+        size_t size = getLE(chunk + 4, 4);
+        size_t available = std::min(size, bytes.size() - offset - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = static_cast<unsigned short>(getLE(chunk + 8, 2));
+            channels = static_cast<unsigned short>(getLE(chunk + 10, 2));
+            sampleRate = getLE(chunk + 12, 4);
+            bitsPerSample = static_cast<unsigned short>(getLE(chunk + 22, 2));
+            if (format == kFormatExtensible && available >= 26) {
+                // The sub-format GUID starts with the plain format code
+                format = static_cast<unsigned short>(getLE(chunk + 32, 2));
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data = chunk + 8;
+            dataBytes = available;
+        }
+
+        offset += 8 + size + (size & 1);
+    }
+
+    const bool supported = (format == kFormatPcm && (bitsPerSample == 8 || bitsPerSample == 16 ||
+                                                     bitsPerSample == 24 || bitsPerSample == 32)) ||
+                           (format == kFormatFloat && (bitsPerSample == 32 || bitsPerSample == 64));
+    if (!data || channels == 0 || sampleRate == 0 || !supported) {
+        throw std::runtime_error("Unsupported or incomplete WAV file: " + filename);
+    }
+
+    const size_t bytesPerSample = bitsPerSample / 8;
+    const size_t frames = dataBytes / (bytesPerSample * channels);
+
+    WavData result;
+    result.sampleRate = sampleRate;
+    result.channels.assign(channels, std::vector<float>(frames));
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (unsigned short channel = 0; channel < channels; ++channel) {
+            const unsigned char* sample = data + (frame * channels + channel) * bytesPerSample;
+            result.channels[channel][frame] = decodeSample(sample, format, bitsPerSample);
+        }
+    }
+
+    return result;
+}
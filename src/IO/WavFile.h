@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+/**
+ * @file WavFile.h
+ * @brief Minimal RIFF/WAVE file input and output
+ */
+
+/**
+ * @enum WavSampleFormat
+ * @brief Sample encoding written to the data chunk
+ */
+enum class WavSampleFormat {
+    Pcm16,      ///< 16-bit signed integer PCM (clipped to [-1.0, 1.0])
+    Float32     ///< 32-bit IEEE float, written unclipped
+};
+
+/**
+ * @class WavWriter
+ * @brief Streams planar stereo float blocks into a WAV file
+ *
+ * The header is written with placeholder sizes when the file is opened and
+ * patched by close() (or the destructor) once the length is known, so blocks
+ * can be appended as they are rendered without buffering the whole file.
+ */
+class WavWriter
+{
+public:
+    /**
+     * @brief Create the file and write a provisional header
+     * @param filename Path of the WAV file to create (overwritten if it exists)
+     * @param sampleRate Sample rate stored in the header, in Hz
+     * @param format Sample encoding
+     * @throws std::runtime_error if the file cannot be created
+     */
+    WavWriter(const std::string& filename, unsigned int sampleRate,
+              WavSampleFormat format = WavSampleFormat::Float32);
+
+    /**
+     * @brief Finalizes the file if close() was not called
+     */
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /**
+     * @brief Append a block of planar stereo samples
+     * @param left Left channel samples
+     * @param right Right channel samples
+     * @param numFrames Number of frames to write
+     * @throws std::runtime_error on a write error
+     */
+    void write(const float* left, const float* right, unsigned int numFrames);
+
+    /**
+     * @brief Patch the header sizes and close the file
+     */
+    void close();
+
+    /**
+     * @brief Number of stereo frames written so far
+     */
+    unsigned long long getFramesWritten() const { return m_framesWritten; }
+
+private:
+    /** Write (or rewrite) the RIFF header for the current length */
+    void writeHeader();
+
+    std::ofstream m_file;                   ///< Output stream
+    std::string m_filename;                 ///< Path, for error messages
+    unsigned int m_sampleRate;              ///< Sample rate in Hz
+    WavSampleFormat m_format;               ///< Sample encoding
+    unsigned long long m_framesWritten;     ///< Frames appended so far
+    std::vector<char> m_scratch;            ///< Interleaved, encoded bytes of one block
+};
+
+/**
+ * @struct WavData
+ * @brief Decoded contents of a WAV file
+ */
+struct WavData
+{
+    unsigned int sampleRate;                    ///< Sample rate in Hz
+    std::vector<std::vector<float>> channels;   ///< One sample vector per channel, in [-1.0, 1.0] for PCM
+
+    WavData() : sampleRate(0) {}
+};
+
+/**
+ * @brief Read a whole WAV file into float samples
+ *
+ * Supports 8, 16, 24 and 32-bit PCM and 32/64-bit float data, including
+ * WAVE_FORMAT_EXTENSIBLE headers. Unknown chunks are skipped.
+ *
+ * @param filename Path of the WAV file
+ * @return Sample rate and de-interleaved channels
+ * @throws std::runtime_error if the file cannot be read or the format is unsupported
+ */
+WavData readWavFile(const std::string& filename);
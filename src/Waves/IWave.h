@@ -30,6 +30,32 @@ public:
      */
     virtual float generate(float frequency, float sampleRate, float& phase) = 0;
 
+    /**
+     * @brief Generate a block of consecutive samples for the waveform
+     *
+     * The default implementation simply calls generate() once per frame, so
+     * existing waveforms work unchanged. Implementations should override this
+     * with a tight loop that hoists the phase increment and avoids the
+     * per-sample virtual call.
+     *
+     * With voice render workers enabled, different voices call this
+     * concurrently on one shared waveform, so any state that changes while
+     * rendering must live in @p phase, not in the waveform object.
+     *
+     * @param frequency The frequency of the waveform in Hertz
+     * @param sampleRate The sample rate of the audio system in samples per second
+     * @param phase Reference to the current phase, advanced by numFrames samples
+     * @param output Destination buffer receiving numFrames samples
+     * @param numFrames Number of samples to generate
+     */
+    virtual void generateBlock(float frequency, float sampleRate, float& phase,
+                               float* output, unsigned int numFrames)
+    {
+        for (unsigned int i = 0; i < numFrames; ++i) {
+            output[i] = generate(frequency, sampleRate, phase);
+        }
+    }
+
     /**
      * @brief Reset the state of the waveform generator
      * 
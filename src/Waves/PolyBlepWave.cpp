@@ -0,0 +1,164 @@
+#include "PolyBlepWave.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Residual of a unit step at phase 0, spread over one sample either side
+     *
+     * @param t Phase in [0, 1)
+     * @param dt Phase increment per sample
+     * @param invDt 1 / dt, hoisted out of the block loop
+     */
+    inline float polyBlep(float t, float dt, float invDt) {
+        if (t < dt) {
+            float x = t * invDt;
+            return x + x - x * x - 1.0f;
+        }
+        if (t > 1.0f - dt) {
+            float x = (t - 1.0f) * invDt;
+            return x * x + x + x + 1.0f;
+        }
+        return 0.0f;
+    }
+
+    /**
+     * @brief Residual of a unit slope change (per sample) at phase 0, the integral of polyBlep
+     */
+    inline float polyBlamp(float t, float dt, float invDt) {
+        if (t < dt) {
+            float x = t * invDt - 1.0f;
+            return -x * x * x * (1.0f / 3.0f);
+        }
+        if (t > 1.0f - dt) {
+            float x = (t - 1.0f) * invDt + 1.0f;
+            return x * x * x * (1.0f / 3.0f);
+        }
+        return 0.0f;
+    }
+
+    /**
+     * @brief Phase half a cycle ahead, wrapped to [0, 1)
+     */
+    inline float halfCycleAhead(float t) {
+        t += 0.5f;
+        return t >= 1.0f ? t - 1.0f : t;
+    }
+
+    inline float sawtoothSample(float t, float dt, float invDt) {
+        return 2.0f * t - 1.0f - polyBlep(t, dt, invDt);
+    }
+
+    inline float squareSample(float t, float dt, float invDt) {
+        float naive = (t < 0.5f) ? 1.0f : -1.0f;
+        return naive + polyBlep(t, dt, invDt) - polyBlep(halfCycleAhead(t), dt, invDt);
+    }
+
+    inline float triangleSample(float t, float dt, float invDt) {
+        float naive = t < 0.5f ? 4.0f * t - 1.0f : -4.0f * t + 3.0f;
+        // The slope flips by 8 per cycle, i.e. 8 * dt per sample, at both corners
+        float corners = polyBlamp(t, dt, invDt) - polyBlamp(halfCycleAhead(t), dt, invDt);
+        return naive + 4.0f * dt * corners;
+    }
+
+    /**
+     * @brief Shared block loop; @p sample is one of the shape functions above
+     */
+    template <typename SampleFunction>
+    void renderBlock(SampleFunction sample, float increment, float dt, float& phase,
+                     float* output, unsigned int numFrames) {
+        const float invDt = 1.0f / dt;
+        for (unsigned int i = 0; i < numFrames; ++i) {
+            output[i] = sample(phase, dt, invDt);
+            phase += increment;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+            }
+        }
+    }
+
+    /**
+     * @brief Increment the residuals are computed for
+     *
+     * Above half a cycle per sample the note is beyond Nyquist and the
+     * residual windows would overlap, so the correction is capped there.
+     */
+    inline float residualIncrement(float increment) {
+        return std::min(increment, 0.5f);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// PolyBlepWave implementation
+// -----------------------------------------------------------------------------
+
+PolyBlepWave::PolyBlepWave(PolyBlepShape shape) : m_shape(shape) {}
+PolyBlepWave::~PolyBlepWave() {}
+
+float PolyBlepWave::generate(float frequency, float sampleRate, float& phase)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        return 0.0f;
+    }
+
+    float increment = frequency / sampleRate;
+    float dt = residualIncrement(increment);
+    float invDt = 1.0f / dt;
+
+    float sample = 0.0f;
+    switch (m_shape) {
+        case PolyBlepShape::Sawtooth: sample = sawtoothSample(phase, dt, invDt); break;
+        case PolyBlepShape::Square:   sample = squareSample(phase, dt, invDt); break;
+        case PolyBlepShape::Triangle: sample = triangleSample(phase, dt, invDt); break;
+    }
+
+    // Update phase
+    phase += increment;
+
+    // Robust phase wrapping
+    if (phase >= 1.0f) {
+        phase = std::fmod(phase, 1.0f);
+    }
+
+    return sample;
+}
+
+void PolyBlepWave::generateBlock(float frequency, float sampleRate, float& phase,
+                                 float* output, unsigned int numFrames)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        std::fill(output, output + numFrames, 0.0f);
+        return;
+    }
+
+    // Phase increment is constant across the block
+    float increment = frequency / sampleRate;
+    float dt = residualIncrement(increment);
+    if (increment >= 1.0f) {
+        increment = std::fmod(increment, 1.0f);
+    }
+
+    // The shape is dispatched once per block; the residual branches are taken
+    // for only a sample or two per cycle, so they predict well
+    switch (m_shape) {
+        case PolyBlepShape::Sawtooth:
+            renderBlock([](float t, float d, float invD) { return sawtoothSample(t, d, invD); },
+                        increment, dt, phase, output, numFrames);
+            break;
+        case PolyBlepShape::Square:
+            renderBlock([](float t, float d, float invD) { return squareSample(t, d, invD); },
+                        increment, dt, phase, output, numFrames);
+            break;
+        case PolyBlepShape::Triangle:
+            renderBlock([](float t, float d, float invD) { return triangleSample(t, d, invD); },
+                        increment, dt, phase, output, numFrames);
+            break;
+    }
+}
+
+void PolyBlepWave::reset()
+{
+    // no state to reset
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "IWave.h"
+
+/**
+ * @brief Shapes available with PolyBLEP/PolyBLAMP correction
+ */
+enum class PolyBlepShape {
+    Sawtooth,   ///< Rising ramp like SawtoothWave, one step per cycle
+    Square,     ///< High for the first half cycle like SquareWave, two steps per cycle
+    Triangle    ///< Starts at -1 like TriangleWave, two corners per cycle
+};
+
+/**
+ * @brief Anti-aliased square, sawtooth and triangle oscillator
+ *
+ * Computes the same naive shape as SquareWave, SawtoothWave or TriangleWave
+ * and subtracts a two-sample polynomial residual around every
+ * discontinuity: a PolyBLEP (band-limited step) for the jumps of the saw and
+ * square, a PolyBLAMP (band-limited ramp) for the slope changes of the
+ * triangle. This removes most of the aliasing that the naive shapes produce
+ * in the upper octaves at a fraction of the cost of a wavetable rebuild or
+ * oversampling.
+ *
+ * Like the naive waves it is stateless: the residuals depend only on the
+ * caller-owned phase and the phase increment.
+ */
+class PolyBlepWave : public IWave
+{
+public:
+    /**
+     * @brief Construct an oscillator for a shape
+     * @param shape Waveform to play
+     */
+    explicit PolyBlepWave(PolyBlepShape shape);
+
+    /// Virtual destructor
+    ~PolyBlepWave() override;
+
+    /// Generate the next anti-aliased sample
+    float generate(float frequency, float sampleRate, float& phase) override;
+    /// Generate a block of anti-aliased samples in a single loop per shape
+    void generateBlock(float frequency, float sampleRate, float& phase,
+                       float* output, unsigned int numFrames) override;
+    /// Reset internal state (no-op, the oscillator is stateless)
+    void reset() override;
+
+    /// Shape this oscillator plays
+    PolyBlepShape getShape() const { return m_shape; }
+
+private:
+    PolyBlepShape m_shape;  ///< Shape selected at construction
+};
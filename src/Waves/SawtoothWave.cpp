@@ -1,5 +1,6 @@
 #include "SawtoothWave.h"
 #include <cmath>
+#include <algorithm>
 
 // -----------------------------------------------------------------------------
 // SawtoothWave implementation
@@ -29,6 +30,30 @@ float SawtoothWave::generate(float frequency, float sampleRate, float& phase)
     return sample;
 }
 
+void SawtoothWave::generateBlock(float frequency, float sampleRate, float& phase,
+                                 float* output, unsigned int numFrames)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        std::fill(output, output + numFrames, 0.0f);
+        return;
+    }
+    
+    // Phase increment is constant across the block
+    float increment = frequency / sampleRate;
+    if (increment >= 1.0f) {
+        increment = std::fmod(increment, 1.0f);
+    }
+    
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        output[i] = 2.0f * phase - 1.0f;
+        phase += increment;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+        }
+    }
+}
+
 void SawtoothWave::reset()
 {
     // no state to reset
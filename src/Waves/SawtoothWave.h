@@ -18,6 +18,9 @@ public:
 
     /// Generate the next sample of the sawtooth
     float generate(float frequency, float sampleRate, float& phase) override;
+    /// Generate a block of sawtooth samples in a single loop
+    void generateBlock(float frequency, float sampleRate, float& phase,
+                       float* output, unsigned int numFrames) override;
     /// Reset internal state (no-op for sawtooth)
     void reset() override;
 };
@@ -1,5 +1,6 @@
 #include "SineWave.h"
 #include <cmath>
+#include <algorithm>
 
 // Define PI if not already defined
 #ifndef M_PI
@@ -41,6 +42,31 @@ float SineWave::generate(float frequency, float sampleRate, float& phase)
     return sample;
 }
 
+void SineWave::generateBlock(float frequency, float sampleRate, float& phase,
+                             float* output, unsigned int numFrames)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        std::fill(output, output + numFrames, 0.0f);
+        return;
+    }
+    
+    // Hoist the phase increment out of the loop; keep it below one cycle
+    // so a single subtraction is enough to wrap the phase
+    float increment = frequency / sampleRate;
+    if (increment >= 1.0f) {
+        increment = std::fmod(increment, 1.0f);
+    }
+    
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        output[i] = std::sin(2.0f * static_cast<float>(M_PI) * phase);
+        phase += increment;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+        }
+    }
+}
+
 void SineWave::reset()
 {
     // Sine wave generation is stateless, nothing to reset
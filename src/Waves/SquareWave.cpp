@@ -1,5 +1,6 @@
 #include "SquareWave.h"
 #include <cmath>
+#include <algorithm>
 
 SquareWave::SquareWave()
 {
@@ -32,6 +33,31 @@ float SquareWave::generate(float frequency, float sampleRate, float& phase)
     return sample;
 }
 
+void SquareWave::generateBlock(float frequency, float sampleRate, float& phase,
+                               float* output, unsigned int numFrames)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        std::fill(output, output + numFrames, 0.0f);
+        return;
+    }
+    
+    // Hoist the phase increment out of the loop; keep it below one cycle
+    // so a single subtraction is enough to wrap the phase
+    float increment = frequency / sampleRate;
+    if (increment >= 1.0f) {
+        increment = std::fmod(increment, 1.0f);
+    }
+    
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        output[i] = (phase < 0.5f) ? 1.0f : -1.0f;
+        phase += increment;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+        }
+    }
+}
+
 void SquareWave::reset()
 {
     // No state to reset for a simple square wave
@@ -56,6 +56,22 @@ public:
      */
     float generate(float frequency, float sampleRate, float& phase) override;
 
+    /**
+     * @brief Generate a block of square wave samples
+     * 
+     * Computes the phase increment once and fills the output buffer in a
+     * single loop without per-sample virtual dispatch.
+     * 
+     * @param frequency The frequency of the waveform in Hertz (Hz)
+     * @param sampleRate The sample rate of the audio system in samples per second (Hz)
+     * @param phase Reference to the current phase, advanced by numFrames samples
+     * @param output Destination buffer receiving numFrames samples
+     * @param numFrames Number of samples to generate
+     * @see IWave::generateBlock for the interface contract
+     */
+    void generateBlock(float frequency, float sampleRate, float& phase,
+                       float* output, unsigned int numFrames) override;
+
     /**
      * @brief Reset the wave generator state
      * 
@@ -1,5 +1,6 @@
 #include "TriangleWave.h"
 #include <cmath>
+#include <algorithm>
 
 // -----------------------------------------------------------------------------
 // TriangleWave implementation
@@ -31,6 +32,30 @@ float TriangleWave::generate(float frequency, float sampleRate, float& phase)
     return sample;
 }
 
+void TriangleWave::generateBlock(float frequency, float sampleRate, float& phase,
+                                 float* output, unsigned int numFrames)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        std::fill(output, output + numFrames, 0.0f);
+        return;
+    }
+    
+    // Phase increment is constant across the block
+    float increment = frequency / sampleRate;
+    if (increment >= 1.0f) {
+        increment = std::fmod(increment, 1.0f);
+    }
+    
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        output[i] = phase < 0.5f ? 4.0f * phase - 1.0f : -4.0f * phase + 3.0f;
+        phase += increment;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+        }
+    }
+}
+
 void TriangleWave::reset()
 {
     // no state to reset
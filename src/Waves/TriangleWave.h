@@ -17,6 +17,9 @@ public:
 
     /// Generate the next sample of the triangle
     float generate(float frequency, float sampleRate, float& phase) override;
+    /// Generate a block of triangle samples in a single loop
+    void generateBlock(float frequency, float sampleRate, float& phase,
+                       float* output, unsigned int numFrames) override;
     /// Reset internal state (no-op for triangle)
     void reset() override;
 };
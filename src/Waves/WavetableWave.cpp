@@ -0,0 +1,202 @@
+#include "WavetableWave.h"
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+constexpr unsigned int WavetableBank::kTableSize;
+constexpr unsigned int WavetableBank::kMaxHarmonics;
+
+namespace {
+    constexpr unsigned int kIndexMask = WavetableBank::kTableSize - 1;
+
+    /**
+     * @brief Fourier coefficients of harmonic @p n for a shape
+     *
+     * The sample at phase p is the sum over n of
+     * sinCoefficient * sin(2*pi*n*p) + cosCoefficient * cos(2*pi*n*p).
+     */
+    void harmonicCoefficients(WavetableShape shape, unsigned int n,
+                              double& sinCoefficient, double& cosCoefficient) {
+        sinCoefficient = 0.0;
+        cosCoefficient = 0.0;
+        const bool odd = (n % 2) == 1;
+
+        switch (shape) {
+            case WavetableShape::Sine:
+                sinCoefficient = (n == 1) ? 1.0 : 0.0;
+                break;
+            case WavetableShape::Sawtooth:
+                sinCoefficient = -2.0 / (M_PI * n);
+                break;
+            case WavetableShape::Square:
+                sinCoefficient = odd ? 4.0 / (M_PI * n) : 0.0;
+                break;
+            case WavetableShape::Triangle:
+                cosCoefficient = odd ? -8.0 / (M_PI * M_PI * n * n) : 0.0;
+                break;
+        }
+    }
+
+    /**
+     * @brief Linearly interpolated table read, phase in [0, 1)
+     */
+    inline float readTable(const float* table, float phase) {
+        float position = phase * WavetableBank::kTableSize;
+        unsigned int index = static_cast<unsigned int>(position);
+        float fraction = position - static_cast<float>(index);
+        index &= kIndexMask;
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// WavetableBank implementation
+// -----------------------------------------------------------------------------
+
+const WavetableBank& WavetableBank::get(WavetableShape shape)
+{
+    // Function-local statics are initialized once and thread-safely
+    static const WavetableBank banks[] = {
+        WavetableBank(WavetableShape::Sine),
+        WavetableBank(WavetableShape::Sawtooth),
+        WavetableBank(WavetableShape::Square),
+        WavetableBank(WavetableShape::Triangle)
+    };
+    return banks[static_cast<int>(shape)];
+}
+
+WavetableBank::WavetableBank(WavetableShape shape)
+{
+    // A sine has nothing to band-limit, so it gets a single level
+    if (shape == WavetableShape::Sine) {
+        m_levelHarmonics.push_back(1);
+    } else {
+        for (unsigned int harmonics = kMaxHarmonics; harmonics >= 1; harmonics /= 2) {
+            m_levelHarmonics.push_back(harmonics);
+        }
+    }
+
+    const unsigned int stride = kTableSize + 1;
+    m_samples.assign(m_levelHarmonics.size() * stride, 0.0f);
+
+    // sin(2*pi*n*i/N) is exactly sine[(n*i) % N], so the series needs no
+    // trigonometry beyond this one cycle
+    std::vector<double> sine(kTableSize);
+    for (unsigned int i = 0; i < kTableSize; ++i) {
+        sine[i] = std::sin(2.0 * M_PI * i / kTableSize);
+    }
+
+    // Add harmonics in ascending order and snapshot the running sum into each
+    // level once its harmonic count is reached (levels are stored descending)
+    std::vector<double> sum(kTableSize, 0.0);
+    unsigned int level = static_cast<unsigned int>(m_levelHarmonics.size());
+    double peak = 0.0;
+
+    for (unsigned int n = 1; level > 0; ++n) {
+        double sinCoefficient, cosCoefficient;
+        harmonicCoefficients(shape, n, sinCoefficient, cosCoefficient);
+
+        if (sinCoefficient != 0.0 || cosCoefficient != 0.0) {
+            for (unsigned int i = 0; i < kTableSize; ++i) {
+                unsigned int index = (n * i) & kIndexMask;
+                sum[i] += sinCoefficient * sine[index] +
+                          cosCoefficient * sine[(index + kTableSize / 4) & kIndexMask];
+            }
+        }
+
+        if (n == m_levelHarmonics[level - 1]) {
+            --level;
+            float* table = &m_samples[level * stride];
+            for (unsigned int i = 0; i < kTableSize; ++i) {
+                table[i] = static_cast<float>(sum[i]);
+                peak = std::max(peak, std::abs(sum[i]));
+            }
+            table[kTableSize] = table[0];
+        }
+    }
+
+    // One gain for the whole bank keeps the level constant across mip
+    // switches while holding the Gibbs overshoot inside [-1, 1]
+    if (peak > 1.0) {
+        const float gain = static_cast<float>(1.0 / peak);
+        for (float& sample : m_samples) {
+            sample *= gain;
+        }
+    }
+}
+
+const float* WavetableBank::selectTable(float increment) const
+{
+    // Richest level whose top harmonic stays below Nyquist; notes above the
+    // last level's limit fall back to the plain fundamental
+    size_t level = 0;
+    while (level + 1 < m_levelHarmonics.size() && m_levelHarmonics[level] * increment > 0.5f) {
+        ++level;
+    }
+    return &m_samples[level * (kTableSize + 1)];
+}
+
+// -----------------------------------------------------------------------------
+// WavetableWave implementation
+// -----------------------------------------------------------------------------
+
+WavetableWave::WavetableWave(WavetableShape shape)
+    : m_shape(shape), m_bank(&WavetableBank::get(shape))
+{
+}
+
+WavetableWave::~WavetableWave() {}
+
+float WavetableWave::generate(float frequency, float sampleRate, float& phase)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        return 0.0f;
+    }
+
+    float increment = frequency / sampleRate;
+    float sample = readTable(m_bank->selectTable(increment), phase);
+
+    // Update phase
+    phase += increment;
+
+    // Robust phase wrapping
+    if (phase >= 1.0f) {
+        phase = std::fmod(phase, 1.0f);
+    }
+
+    return sample;
+}
+
+void WavetableWave::generateBlock(float frequency, float sampleRate, float& phase,
+                                  float* output, unsigned int numFrames)
+{
+    // Input validation
+    if (frequency <= 0.0f || sampleRate <= 0.0f) {
+        std::fill(output, output + numFrames, 0.0f);
+        return;
+    }
+
+    // The frequency is constant across the block, so is the mip level
+    float increment = frequency / sampleRate;
+    const float* table = m_bank->selectTable(increment);
+    if (increment >= 1.0f) {
+        increment = std::fmod(increment, 1.0f);
+    }
+
+    for (unsigned int i = 0; i < numFrames; ++i) {
+        output[i] = readTable(table, phase);
+        phase += increment;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+        }
+    }
+}
+
+void WavetableWave::reset()
+{
+    // no state to reset
+}
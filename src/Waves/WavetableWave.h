@@ -0,0 +1,104 @@
+#pragma once
+#include "IWave.h"
+#include <vector>
+
+/**
+ * @brief Shapes available as band-limited wavetables
+ */
+enum class WavetableShape {
+    Sine,       ///< Fundamental only
+    Sawtooth,   ///< All harmonics at 1/n, rising ramp like SawtoothWave
+    Square,     ///< Odd harmonics at 1/n, high for the first half cycle like SquareWave
+    Triangle    ///< Odd harmonics at 1/n^2, starting at -1 like TriangleWave
+};
+
+/**
+ * @brief Read-only set of band-limited mip levels for one shape
+ *
+ * Each level holds one cycle of the shape built from a truncated Fourier
+ * series. Level 0 carries kMaxHarmonics harmonics and every following level
+ * halves the count, down to the plain fundamental. An oscillator picks the
+ * richest level whose highest harmonic still lies below Nyquist for its
+ * phase increment, so it never aliases while keeping as much brightness as
+ * the pitch allows.
+ *
+ * Banks are built once per shape on first use and shared by every
+ * WavetableWave; nothing in them changes afterwards, so any number of voices
+ * and threads may read them concurrently.
+ */
+class WavetableBank
+{
+public:
+    static constexpr unsigned int kTableSize = 2048;     ///< Samples per cycle (power of two)
+    static constexpr unsigned int kMaxHarmonics = 512;   ///< Harmonics in level 0 (full band above ~43 Hz at 44.1 kHz)
+
+    /**
+     * @brief Shared bank for a shape, built on the first call
+     *
+     * Building takes a few milliseconds, so the first call should happen on a
+     * control thread (WavetableWave's constructor takes care of that).
+     */
+    static const WavetableBank& get(WavetableShape shape);
+
+    /**
+     * @brief Table to read for a given phase increment
+     *
+     * @param increment Phase advance per sample (frequency / sampleRate)
+     * @return kTableSize + 1 samples; the last repeats the first so
+     *         interpolation never needs to wrap
+     */
+    const float* selectTable(float increment) const;
+
+    /**
+     * @brief Number of mip levels in the bank
+     */
+    unsigned int getLevelCount() const { return static_cast<unsigned int>(m_levelHarmonics.size()); }
+
+private:
+    explicit WavetableBank(WavetableShape shape);
+
+    std::vector<unsigned int> m_levelHarmonics;  ///< Highest harmonic in each level, descending
+    std::vector<float> m_samples;                ///< All levels back to back, kTableSize + 1 each
+};
+
+/**
+ * @brief Wavetable oscillator reading band-limited mip levels
+ *
+ * A cheaper and cleaner alternative to the computed waveforms: one table
+ * lookup with linear interpolation per sample instead of std::sin/std::fmod,
+ * and no aliasing on high notes because the table is chosen from the phase
+ * increment. The mip level is selected once per block in generateBlock().
+ *
+ * The oscillator itself is stateless; the phase is owned by the caller as
+ * with every IWave.
+ */
+class WavetableWave : public IWave
+{
+public:
+    /**
+     * @brief Construct an oscillator for a shape
+     *
+     * Builds the shared bank for @p shape if this is its first use.
+     *
+     * @param shape Waveform to play
+     */
+    explicit WavetableWave(WavetableShape shape);
+
+    /// Virtual destructor
+    ~WavetableWave() override;
+
+    /// Generate the next sample from the band-limited table
+    float generate(float frequency, float sampleRate, float& phase) override;
+    /// Generate a block of samples from a single mip level
+    void generateBlock(float frequency, float sampleRate, float& phase,
+                       float* output, unsigned int numFrames) override;
+    /// Reset internal state (no-op, the tables are read-only)
+    void reset() override;
+
+    /// Shape this oscillator plays
+    WavetableShape getShape() const { return m_shape; }
+
+private:
+    WavetableShape m_shape;         ///< Shape selected at construction
+    const WavetableBank* m_bank;    ///< Shared tables for m_shape
+};